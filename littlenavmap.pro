@@ -288,6 +288,7 @@ SOURCES += \
   src/common/settingsmigrate.cpp \
   src/common/symbolpainter.cpp \
   src/common/tabindexes.cpp \
+  src/common/textcollisiongrid.cpp \
   src/common/textplacement.cpp \
   src/common/unit.cpp \
   src/common/unitstringtool.cpp \
@@ -295,11 +296,13 @@ SOURCES += \
   src/common/vehicleicons.cpp \
   src/connect/connectclient.cpp \
   src/connect/connectdialog.cpp \
+  src/connect/simdatarecorder.cpp \
   src/db/airspacedialog.cpp \
   src/db/databasedialog.cpp \
   src/db/databaseloader.cpp \
   src/db/databasemanager.cpp \
   src/db/databaseprogressdialog.cpp \
+  src/db/dataimport.cpp \
   src/db/dbtools.cpp \
   src/db/dbtypes.cpp \
   src/db/undoredoprogress.cpp \
@@ -323,8 +326,11 @@ SOURCES += \
   src/logbook/logdatacontroller.cpp \
   src/logbook/logdataconverter.cpp \
   src/logbook/logdatadialog.cpp \
+  src/logbook/loggeometrycache.cpp \
+  src/logbook/logstatistics.cpp \
   src/logbook/logstatisticsdialog.cpp \
   src/main.cpp \
+  src/mapgui/aircraftindex.cpp \
   src/mapgui/aprongeometrycache.cpp \
   src/mapgui/imageexportdialog.cpp \
   src/mapgui/mapairporthandler.cpp \
@@ -335,9 +341,11 @@ SOURCES += \
   src/mapgui/maplayersettings.cpp \
   src/mapgui/mapmarkhandler.cpp \
   src/mapgui/mappaintwidget.cpp \
+  src/mapgui/mapprefetcher.cpp \
   src/mapgui/mapscale.cpp \
   src/mapgui/mapscreenindex.cpp \
   src/mapgui/mapthemehandler.cpp \
+  src/mapgui/maptilerenderer.cpp \
   src/mapgui/maptooltip.cpp \
   src/mapgui/mapvisible.cpp \
   src/mapgui/mapwidget.cpp \
@@ -359,6 +367,7 @@ SOURCES += \
   src/mappainter/mappainterweather.cpp \
   src/mappainter/mappainterwind.cpp \
   src/mappainter/mappaintlayer.cpp \
+  src/mappainter/paintarena.cpp \
   src/online/onlinedatacontroller.cpp \
   src/options/optiondata.cpp \
   src/options/optionsdialog.cpp \
@@ -405,6 +414,7 @@ SOURCES += \
   src/routeexport/routeexportformat.cpp \
   src/routeexport/routemultiexportdialog.cpp \
   src/routeexport/simbriefhandler.cpp \
+  src/routestring/routestringbatch.cpp \
   src/routestring/routestringdialog.cpp \
   src/routestring/routestringreader.cpp \
   src/routestring/routestringtypes.cpp \
@@ -440,18 +450,21 @@ SOURCES += \
   src/weather/weathercontext.cpp \
   src/weather/weathercontexthandler.cpp \
   src/weather/weatherreporter.cpp \
+  src/weather/windgrid.cpp \
   src/weather/windreporter.cpp \
   src/web/requesthandler.cpp \
   src/web/webapp.cpp \
   src/web/webcontroller.cpp \
   src/web/webflags.cpp \
   src/web/webmapcontroller.cpp \
+  src/web/webstream.cpp \
   src/web/webtools.cpp \
   src/webapi/abstractactionscontroller.cpp \
   src/webapi/abstractlnmactionscontroller.cpp \
   src/webapi/actionscontrollerindex.cpp \
   src/webapi/airportactionscontroller.cpp \
   src/webapi/mapactionscontroller.cpp \
+  src/webapi/routeactionscontroller.cpp \
   src/webapi/simactionscontroller.cpp \
   src/webapi/uiactionscontroller.cpp \
   src/webapi/webapicontroller.cpp
@@ -489,6 +502,7 @@ HEADERS  += \
   src/common/settingsmigrate.h \
   src/common/symbolpainter.h \
   src/common/tabindexes.h \
+  src/common/textcollisiongrid.h \
   src/common/textplacement.h \
   src/common/unit.h \
   src/common/unitstringtool.h \
@@ -496,11 +510,13 @@ HEADERS  += \
   src/common/vehicleicons.h \
   src/connect/connectclient.h \
   src/connect/connectdialog.h \
+  src/connect/simdatarecorder.h \
   src/db/airspacedialog.h \
   src/db/databasedialog.h \
   src/db/databaseloader.h \
   src/db/databasemanager.h \
   src/db/databaseprogressdialog.h \
+  src/db/dataimport.h \
   src/db/dbtools.h \
   src/db/dbtypes.h \
   src/db/undoredoprogress.h \
@@ -524,7 +540,10 @@ HEADERS  += \
   src/logbook/logdatacontroller.h \
   src/logbook/logdataconverter.h \
   src/logbook/logdatadialog.h \
+  src/logbook/loggeometrycache.h \
+  src/logbook/logstatistics.h \
   src/logbook/logstatisticsdialog.h \
+  src/mapgui/aircraftindex.h \
   src/mapgui/aprongeometrycache.h \
   src/mapgui/imageexportdialog.h \
   src/mapgui/mapairporthandler.h \
@@ -535,9 +554,11 @@ HEADERS  += \
   src/mapgui/maplayersettings.h \
   src/mapgui/mapmarkhandler.h \
   src/mapgui/mappaintwidget.h \
+  src/mapgui/mapprefetcher.h \
   src/mapgui/mapscale.h \
   src/mapgui/mapscreenindex.h \
   src/mapgui/mapthemehandler.h \
+  src/mapgui/maptilerenderer.h \
   src/mapgui/maptooltip.h \
   src/mapgui/mapvisible.h \
   src/mapgui/mapwidget.h \
@@ -559,6 +580,7 @@ HEADERS  += \
   src/mappainter/mappainterweather.h \
   src/mappainter/mappainterwind.h \
   src/mappainter/mappaintlayer.h \
+  src/mappainter/paintarena.h \
   src/online/onlinedatacontroller.h \
   src/options/optiondata.h \
   src/options/optionsdialog.h \
@@ -606,6 +628,7 @@ HEADERS  += \
   src/routeexport/routeexportformat.h \
   src/routeexport/routemultiexportdialog.h \
   src/routeexport/simbriefhandler.h \
+  src/routestring/routestringbatch.h \
   src/routestring/routestringdialog.h \
   src/routestring/routestringreader.h \
   src/routestring/routestringtypes.h \
@@ -641,18 +664,21 @@ HEADERS  += \
   src/weather/weathercontext.h \
   src/weather/weathercontexthandler.h \
   src/weather/weatherreporter.h \
+  src/weather/windgrid.h \
   src/weather/windreporter.h \
   src/web/requesthandler.h \
   src/web/webapp.h \
   src/web/webcontroller.h \
   src/web/webflags.h \
   src/web/webmapcontroller.h \
+  src/web/webstream.h \
   src/web/webtools.h \
   src/webapi/abstractactionscontroller.h \
   src/webapi/abstractlnmactionscontroller.h \
   src/webapi/actionscontrollerindex.h \
   src/webapi/airportactionscontroller.h \
   src/webapi/mapactionscontroller.h \
+  src/webapi/routeactionscontroller.h \
   src/webapi/simactionscontroller.h \
   src/webapi/uiactionscontroller.h \
   src/webapi/webapicontroller.h \
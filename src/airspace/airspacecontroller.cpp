@@ -221,6 +221,25 @@ const atools::geo::LineString *AirspaceController::getAirspaceGeometry(map::MapA
   return nullptr;
 }
 
+void AirspaceController::prefetchAirspaces(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer,
+                                           const map::MapAirspaceFilter& filter, float flightPlanAltitude,
+                                           map::MapAirspaceSources sourcesParam)
+{
+  for(map::MapAirspaceSources src : map::MAP_AIRSPACE_SRC_VALUES)
+  {
+    // Avoid deadlock while loading user airspaces
+    if((src & map::AIRSPACE_SRC_USER) && loadingUserAirspaces)
+      continue;
+
+    if(sourcesParam & src & sources)
+    {
+      AirspaceQuery *query = queries.value(src);
+      if(query != nullptr)
+        query->prefetchAirspaces(rect, mapLayer, filter, flightPlanAltitude);
+    }
+  }
+}
+
 void AirspaceController::restoreState()
 {
   Ui::MainWindow *ui = NavApp::getMainUi();
@@ -86,6 +86,11 @@ public:
   /* Get Geometry for any airspace and source database */
   const atools::geo::LineString *getAirspaceGeometry(map::MapAirspaceId id);
 
+  /* Load airspaces and geometry for the rectangle into the query caches without changing the map display cache.
+   * Used by the map prefetcher. */
+  void prefetchAirspaces(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer, const map::MapAirspaceFilter& filter,
+                         float flightPlanAltitude, map::MapAirspaceSources sourcesParam);
+
   /* Read and write widget states, source and airspace selection */
   void restoreState();
   void saveState();
@@ -91,6 +91,55 @@ CommandLine::CommandLine()
                                                    "The code is not checked for existence or validity and "
                                                    "is saved for the next startup."), "language");
   parser->addOption(*languageOpt);
+
+  simRecordOpt = new QCommandLineOption(lnm::STARTUP_SIM_RECORD,
+                                        QObject::tr("Record all data received from the simulator or Little Navconnect "
+                                                    "including AI and weather to the file <%1>.").arg(lnm::STARTUP_SIM_RECORD),
+                                        lnm::STARTUP_SIM_RECORD);
+  parser->addOption(*simRecordOpt);
+
+  simReplayOpt = new QCommandLineOption(lnm::STARTUP_SIM_REPLAY,
+                                        QObject::tr("Replay simulator data from the file <%1> instead of connecting to a "
+                                                    "simulator on startup.").arg(lnm::STARTUP_SIM_REPLAY),
+                                        lnm::STARTUP_SIM_REPLAY);
+  parser->addOption(*simReplayOpt);
+
+  simReplaySpeedOpt = new QCommandLineOption(lnm::STARTUP_SIM_REPLAY_SPEED,
+                                             QObject::tr("Replay speed factor <%1> for option \"%2\". "
+                                                         "\"1\" is original speed and \"0\" is as fast as possible.").
+                                             arg(lnm::STARTUP_SIM_REPLAY_SPEED).arg(lnm::STARTUP_SIM_REPLAY),
+                                             lnm::STARTUP_SIM_REPLAY_SPEED);
+  parser->addOption(*simReplaySpeedOpt);
+
+  importUserpointsOpt = new QCommandLineOption(lnm::STARTUP_IMPORT_USERPOINTS,
+                                               QObject::tr("Import userpoints from the CSV file <%1> on startup. "
+                                                           "Number of imported userpoints and time are written to the log file.").
+                                               arg(lnm::STARTUP_IMPORT_USERPOINTS),
+                                               lnm::STARTUP_IMPORT_USERPOINTS);
+  parser->addOption(*importUserpointsOpt);
+
+  importLogbookOpt = new QCommandLineOption(lnm::STARTUP_IMPORT_LOGBOOK,
+                                            QObject::tr("Import logbook entries from the CSV file <%1> on startup. "
+                                                        "Number of imported entries and time are written to the log file.").
+                                            arg(lnm::STARTUP_IMPORT_LOGBOOK),
+                                            lnm::STARTUP_IMPORT_LOGBOOK);
+  parser->addOption(*importLogbookOpt);
+
+  parseRoutesOpt = new QCommandLineOption(lnm::STARTUP_PARSE_ROUTES,
+                                          QObject::tr("Read route descriptions from the text file <%1> on startup. "
+                                                      "One route per line. Results are written to a CSV file "
+                                                      "with the suffix \"_parsed.csv\" in the same directory.").
+                                          arg(lnm::STARTUP_PARSE_ROUTES),
+                                          lnm::STARTUP_PARSE_ROUTES);
+  parser->addOption(*parseRoutesOpt);
+
+  trackFilesOpt = new QCommandLineOption(lnm::STARTUP_TRACK_FILES,
+                                         QObject::tr("Load tracks from the files \"NAT.txt\", \"PACOTS.txt\" and \"AUSOTS.txt\" "
+                                                     "in directory <%1> on startup instead of downloading them. "
+                                                     "Loading times are written to the log file.").
+                                         arg(lnm::STARTUP_TRACK_FILES),
+                                         lnm::STARTUP_TRACK_FILES);
+  parser->addOption(*trackFilesOpt);
 }
 
 CommandLine::~CommandLine()
@@ -105,6 +154,13 @@ CommandLine::~CommandLine()
   delete performanceOpt;
   delete layoutOpt;
   delete languageOpt;
+  delete simRecordOpt;
+  delete simReplayOpt;
+  delete simReplaySpeedOpt;
+  delete importUserpointsOpt;
+  delete importLogbookOpt;
+  delete parseRoutesOpt;
+  delete trackFilesOpt;
 }
 
 void CommandLine::process()
@@ -142,6 +198,32 @@ void CommandLine::process()
   if(parser->isSet(*layoutOpt) && !parser->value(*layoutOpt).isEmpty())
     NavApp::addStartupOptionStr(lnm::STARTUP_LAYOUT, parser->value(*layoutOpt));
 
+  // Simulator data recording and replay
+  if(parser->isSet(*simRecordOpt) && parser->isSet(*simReplayOpt))
+    qWarning() << QObject::tr("Only one of options --%1 and --%2 can be used").arg(lnm::STARTUP_SIM_RECORD).arg(lnm::STARTUP_SIM_REPLAY);
+
+  if(parser->isSet(*simRecordOpt) && !parser->value(*simRecordOpt).isEmpty())
+    NavApp::addStartupOptionStr(lnm::STARTUP_SIM_RECORD, parser->value(*simRecordOpt));
+
+  if(parser->isSet(*simReplayOpt) && !parser->value(*simReplayOpt).isEmpty())
+    NavApp::addStartupOptionStr(lnm::STARTUP_SIM_REPLAY, parser->value(*simReplayOpt));
+
+  if(parser->isSet(*simReplaySpeedOpt) && !parser->value(*simReplaySpeedOpt).isEmpty())
+    NavApp::addStartupOptionStr(lnm::STARTUP_SIM_REPLAY_SPEED, parser->value(*simReplaySpeedOpt));
+
+  // Bulk imports
+  if(parser->isSet(*importUserpointsOpt) && !parser->value(*importUserpointsOpt).isEmpty())
+    NavApp::addStartupOptionStr(lnm::STARTUP_IMPORT_USERPOINTS, parser->value(*importUserpointsOpt));
+
+  if(parser->isSet(*importLogbookOpt) && !parser->value(*importLogbookOpt).isEmpty())
+    NavApp::addStartupOptionStr(lnm::STARTUP_IMPORT_LOGBOOK, parser->value(*importLogbookOpt));
+
+  if(parser->isSet(*parseRoutesOpt) && !parser->value(*parseRoutesOpt).isEmpty())
+    NavApp::addStartupOptionStr(lnm::STARTUP_PARSE_ROUTES, parser->value(*parseRoutesOpt));
+
+  if(parser->isSet(*trackFilesOpt) && !parser->value(*trackFilesOpt).isEmpty())
+    NavApp::addStartupOptionStr(lnm::STARTUP_TRACK_FILES, parser->value(*trackFilesOpt));
+
   // Other arguments without option
   if(!parser->positionalArguments().isEmpty())
     NavApp::addStartupOptionStrList(lnm::STARTUP_OTHER_ARGUMENTS, parser->positionalArguments());
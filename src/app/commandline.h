@@ -62,7 +62,9 @@ private:
 
   QCommandLineOption *settingsDirOpt = nullptr, *settingsPathOpt = nullptr, *logPathOpt = nullptr, *cachePathOpt = nullptr,
                      *flightplanOpt = nullptr, *flightplanDescrOpt = nullptr, *performanceOpt,
-                     *layoutOpt = nullptr, *languageOpt = nullptr;
+                     *layoutOpt = nullptr, *languageOpt = nullptr, *simRecordOpt = nullptr, *simReplayOpt = nullptr,
+                     *simReplaySpeedOpt = nullptr, *importUserpointsOpt = nullptr, *importLogbookOpt = nullptr,
+                     *parseRoutesOpt = nullptr, *trackFilesOpt = nullptr;
 };
 
 #endif // LNM_COMMANDLINE_H
@@ -24,14 +24,31 @@
 #include "common/constants.h"
 #include "settings/settings.h"
 
+#include <QCryptographicHash>
 #include <QDataStream>
 #include <QSharedMemory>
 #include <QDateTime>
 #include <QDir>
+#include <QLocalServer>
+#include <QLocalSocket>
 
 static const int SHARED_MEMORY_SIZE = 4096;
 static QLatin1String PROGRAM_GUID("203abd54-8a6a-4308-a654-6771efec62cd");
 
+/* Timeout for connecting and writing to the local server of other instance */
+static const int LOCAL_SOCKET_TIMEOUT_MS = 1000;
+
+/* Timeout for the acknowledge from the other instance after sending the message */
+static const int LOCAL_SOCKET_ACK_TIMEOUT_MS = 2000;
+
+/* Sent back by the running instance once the message was received completely */
+static const char LOCAL_SOCKET_ACK = '\x06';
+
+/* Shared memory check interval. Slow if local server is active since shared memory is only a fallback
+ * then. Has to be below the ten seconds crash detection. */
+static const int SHARED_MEMORY_CHECK_MS = 500;
+static const int SHARED_MEMORY_CHECK_SLOW_MS = 4000;
+
 DataExchange::DataExchange()
   : QObject(nullptr)
 {
@@ -42,6 +59,14 @@ DataExchange::DataExchange()
 
   exit = false;
 
+  // Try fast path first and send options to other instance using local socket =======================
+  LocalServerResult result = sendToLocalServer();
+  if(result == LOCAL_SERVER_ACK)
+  {
+    exit = true;
+    return;
+  }
+
   // Detect other running application instance with same settings - this is unsafe on Unix since shm can remain after crashes
   if(sharedMemory == nullptr)
     sharedMemory = new QSharedMemory(PROGRAM_GUID + "-" +
@@ -89,6 +114,15 @@ DataExchange::DataExchange()
         // If timestamp is older than ten seconds other might be crashed or frozen, start normally - otherwise send message
         if(QDateTime::fromMSecsSinceEpoch(datetime).secsTo(QDateTime::currentDateTimeUtc()) < 10)
         {
+          if(result == LOCAL_SERVER_NO_ACK)
+          {
+            // Other instance is alive but busy - it will read the message from the socket later
+            qDebug() << Q_FUNC_INFO << "No acknowledge from local server but other instance is alive";
+            exit = true;
+            sharedMemory->unlock();
+            return;
+          }
+
           // Copy command line parameters and add activate option to bring other to front
           atools::util::Properties properties(NavApp::getStartupOptionsConst());
           properties.setPropertyBool(lnm::STARTUP_COMMAND_ACTIVATE, true); // Raise other window
@@ -123,6 +157,14 @@ DataExchange::~DataExchange()
 {
   sharedMemoryCheckTimer.stop();
 
+  if(localServer != nullptr)
+  {
+    qDebug() << Q_FUNC_INFO << "delete localServer";
+    localServer->close();
+    delete localServer;
+    localServer = nullptr;
+  }
+
   if(sharedMemory != nullptr)
   {
     qDebug() << Q_FUNC_INFO << "delete sharedMemory";
@@ -134,17 +176,164 @@ DataExchange::~DataExchange()
 
 void DataExchange::startTimer()
 {
-  // Check for commands from other instance =====================
-  sharedMemoryCheckTimer.setInterval(500);
+  // Listen for messages from other instances =====================
+  bool listening = startLocalServer();
+
+  // Check for commands from other instance in shared memory and update timestamp =====================
+  sharedMemoryCheckTimer.setInterval(listening ? SHARED_MEMORY_CHECK_SLOW_MS : SHARED_MEMORY_CHECK_MS);
   connect(&sharedMemoryCheckTimer, &QTimer::timeout, this, &DataExchange::checkData);
   sharedMemoryCheckTimer.start();
 }
 
+QString DataExchange::localServerName() const
+{
+  // Use hash of path to get a short name without special characters which is valid for sockets and pipes
+  QString path = QDir::cleanPath(QFileInfo(atools::settings::Settings::getPath()).canonicalFilePath());
+  return PROGRAM_GUID + "-" + QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Md5).toHex();
+}
+
+DataExchange::LocalServerResult DataExchange::sendToLocalServer()
+{
+  QLocalSocket socket;
+  socket.connectToServer(localServerName(), QIODevice::ReadWrite);
+
+  if(!socket.waitForConnected(LOCAL_SOCKET_TIMEOUT_MS))
+  {
+#ifdef DEBUG_INFORMATION
+    qDebug() << Q_FUNC_INFO << "No server" << socket.errorString();
+#endif
+    return LOCAL_SERVER_NONE;
+  }
+
+  // Copy command line parameters and add activate option to bring other to front
+  atools::util::Properties properties(NavApp::getStartupOptionsConst());
+  properties.setPropertyBool(lnm::STARTUP_COMMAND_ACTIVATE, true); // Raise other window
+
+#ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << "Sending" << properties;
+#endif
+
+  // Message is a byte array containing the serialized properties
+  QByteArray bytes;
+  QDataStream out(&bytes, QIODevice::WriteOnly);
+  out << properties.asByteArray();
+
+  socket.write(bytes);
+  if(!socket.waitForBytesWritten(LOCAL_SOCKET_TIMEOUT_MS))
+  {
+    qWarning() << Q_FUNC_INFO << "Error writing to" << socket.serverName() << socket.errorString();
+    socket.abort();
+    return LOCAL_SERVER_NONE;
+  }
+
+  // Wait for other instance to confirm reception - a frozen instance accepts connections but does not reply
+  char ack = 0;
+  while(socket.bytesAvailable() < 1 && socket.waitForReadyRead(LOCAL_SOCKET_ACK_TIMEOUT_MS))
+    ;
+  bool acknowledged = socket.getChar(&ack) && ack == LOCAL_SOCKET_ACK;
+  socket.disconnectFromServer();
+
+  if(!acknowledged)
+    qWarning() << Q_FUNC_INFO << "No acknowledge from" << socket.serverName() << socket.errorString();
+  return acknowledged ? LOCAL_SERVER_ACK : LOCAL_SERVER_NO_ACK;
+}
+
+bool DataExchange::isLocalServerStale() const
+{
+  // Connection refused means a socket file without a listening process left by a crashed instance on Unix
+  QLocalSocket socket;
+  socket.connectToServer(localServerName(), QIODevice::ReadWrite);
+  bool connected = socket.waitForConnected(LOCAL_SOCKET_TIMEOUT_MS);
+  QLocalSocket::LocalSocketError error = socket.error();
+  socket.abort();
+
+  return !connected && error == QLocalSocket::ConnectionRefusedError;
+}
+
+bool DataExchange::startLocalServer()
+{
+  localServer = new QLocalServer;
+
+  // Allow access for the same user only
+  localServer->setSocketOptions(QLocalServer::UserAccessOption);
+
+  bool listening = localServer->listen(localServerName());
+
+  if(!listening && localServer->serverError() == QAbstractSocket::AddressInUseError && isLocalServerStale())
+  {
+    // Remove stale socket file left by a crashed instance and try again
+    qDebug() << Q_FUNC_INFO << "Removing stale" << localServerName();
+    QLocalServer::removeServer(localServerName());
+    listening = localServer->listen(localServerName());
+  }
+
+  if(listening)
+  {
+    qDebug() << Q_FUNC_INFO << "Listening on" << localServer->fullServerName();
+    connect(localServer, &QLocalServer::newConnection, this, &DataExchange::newLocalConnection);
+    return true;
+  }
+  else
+  {
+    qWarning() << Q_FUNC_INFO << "Cannot listen on" << localServerName() << localServer->errorString();
+    delete localServer;
+    localServer = nullptr;
+    return false;
+  }
+}
+
+void DataExchange::newLocalConnection()
+{
+  while(localServer->hasPendingConnections())
+  {
+    QLocalSocket *socket = localServer->nextPendingConnection();
+    connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+      readLocalSocket(socket);
+    });
+    connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+
+    // Data might be already there
+    readLocalSocket(socket);
+  }
+}
+
+void DataExchange::readLocalSocket(QLocalSocket *socket)
+{
+  // Read complete message or wait for next readyRead signal
+  QDataStream in(socket);
+  in.startTransaction();
+
+  QByteArray propBytes;
+  in >> propBytes;
+
+  if(!in.commitTransaction())
+    return;
+
+  // Confirm reception before handling the message since this might open dialogs
+  socket->putChar(LOCAL_SOCKET_ACK);
+  socket->flush();
+
+  atools::util::Properties properties;
+  QDataStream propIn(&propBytes, QIODevice::ReadOnly);
+  propIn >> properties;
+
+  if(propIn.status() == QDataStream::Ok)
+    handleProperties(properties);
+  else
+    qWarning() << Q_FUNC_INFO << "Invalid message";
+}
+
 void DataExchange::checkData()
 {
   // Check for message from other instance
   atools::util::Properties properties = fetchSharedMemory();
 
+  if(!properties.isEmpty())
+    handleProperties(properties);
+}
+
+void DataExchange::handleProperties(const atools::util::Properties& properties)
+{
   if(!properties.isEmpty())
   {
     // Found message
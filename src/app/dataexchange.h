@@ -28,10 +28,18 @@ class Properties;
 }
 
 class QSharedMemory;
+class QLocalServer;
+class QLocalSocket;
 
 /*
  * Implements a mechanism similar to the old Windows DDE to pass parameters to a running instance from another starting instance.
- * Uses shared memory to attach to a running instance which regularily checks the shared memory for messages.
+ *
+ * The running instance listens on a local socket (named pipe on Windows) and gets messages immediately.
+ * A starting instance first tries to connect to this socket and exits once the running instance
+ * acknowledged the message with one byte.
+ *
+ * Shared memory is used as fallback if the local server cannot be used. The running instance regularily checks
+ * the shared memory for messages. This is done less often if the local server is active.
  * A timestamp is saved to avoid dead or crashed instances blocking further startups.
  */
 class DataExchange :
@@ -54,8 +62,9 @@ public:
     return exit;
   }
 
-  /* Start the timer which updates the timestamp in the shared memory segment. Sends messages below if another instance left messages.
-   * Currently twice a second. */
+  /* Start the local server and the timer which updates the timestamp in the shared memory segment.
+   * Sends messages below if another instance left messages.
+   * Timer runs twice a second or every four seconds if the local server is listening. */
   void startTimer();
 
 signals:
@@ -75,12 +84,39 @@ private:
   /* Called by sharedMemoryCheckTimer and checks for messages from other instances */
   void checkData();
 
+  /* Read files and send messages for the properties received from the other instance */
+  void handleProperties(const atools::util::Properties& properties);
+
+  enum LocalServerResult
+  {
+    LOCAL_SERVER_NONE, /* No server or sending failed */
+    LOCAL_SERVER_ACK, /* Message sent and acknowledged */
+    LOCAL_SERVER_NO_ACK /* Message sent but no acknowledge received. Other might be frozen or busy. */
+  };
+
+  /* Try to send startup options to a running instance using the local socket */
+  LocalServerResult sendToLocalServer();
+
+  /* true if a connection attempt shows that the socket is left over from a crashed instance */
+  bool isLocalServerStale() const;
+
+  /* Start listening for other instances. Returns true if successful. */
+  bool startLocalServer();
+
+  /* Connected to local server signals */
+  void newLocalConnection();
+  void readLocalSocket(QLocalSocket *socket);
+
+  /* Name of socket or pipe derived from settings path */
+  QString localServerName() const;
+
   /* Found other instance if true. This one can exit now. */
   bool exit = false;
 
   /* Check shared memory for updates by other instance every second. Calls checkSharedMemory() */
   QTimer sharedMemoryCheckTimer;
   QSharedMemory *sharedMemory = nullptr;
+  QLocalServer *localServer = nullptr;
 };
 
 #endif // LNM_DATAEXCHANGE_H
@@ -59,6 +59,12 @@ QByteArray AbstractInfoBuilder::uiinfo(UiInfoData uiInfoData) const
     return "not implemented";
 }
 
+QByteArray AbstractInfoBuilder::routeparse(RouteParseData routeParseData) const
+{
+  Q_UNUSED(routeParseData);
+    return "not implemented";
+}
+
 QByteArray AbstractInfoBuilder::features(MapFeaturesData mapFeaturesData) const
 {
   Q_UNUSED(mapFeaturesData);
@@ -26,6 +26,7 @@ namespace InfoBuilderTypes {
     struct SimConnectInfoData;
     struct UiInfoData;
     struct MapFeaturesData;
+    struct RouteParseData;
 }
 namespace atools {
     namespace sql {
@@ -41,6 +42,7 @@ using InfoBuilderTypes::AirportInfoData;
 using InfoBuilderTypes::SimConnectInfoData;
 using InfoBuilderTypes::UiInfoData;
 using InfoBuilderTypes::MapFeaturesData;
+using InfoBuilderTypes::RouteParseData;
 
 /**
  * Generic interface for LNM-specific views.
@@ -98,6 +100,13 @@ public:
    * @param uiInfoData
    */
   virtual QByteArray uiinfo(UiInfoData uiInfoData) const;
+
+  /**
+   * Creates a description for the provided route parsing results.
+   *
+   * @param routeParseData
+   */
+  virtual QByteArray routeparse(RouteParseData routeParseData) const;
 protected:
   /**
    * @brief Get heading and opposed heading corrected by magnetic variation
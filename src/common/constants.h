@@ -458,6 +458,13 @@ const QLatin1String STARTUP_FLIGHTPLAN("flight-plan");
 const QLatin1String STARTUP_FLIGHTPLAN_DESCR("flight-plan-descr");
 const QLatin1String STARTUP_AIRCRAFT_PERF("aircraft-perf");
 const QLatin1String STARTUP_LAYOUT("layout");
+const QLatin1String STARTUP_SIM_RECORD("sim-record");
+const QLatin1String STARTUP_SIM_REPLAY("sim-replay");
+const QLatin1String STARTUP_SIM_REPLAY_SPEED("sim-replay-speed");
+const QLatin1String STARTUP_IMPORT_USERPOINTS("import-userpoints");
+const QLatin1String STARTUP_IMPORT_LOGBOOK("import-logbook");
+const QLatin1String STARTUP_PARSE_ROUTES("parse-routes");
+const QLatin1String STARTUP_TRACK_FILES("track-files");
 
 /* Not used as long options */
 const QLatin1String STARTUP_OTHER_ARGUMENTS("others"); /* Positional arguments not found after option - string list */
@@ -21,6 +21,7 @@
 
 #include "common/maptypes.h"
 #include "fs/sc/simconnectdata.h"
+#include "routestring/routestringbatch.h"
 
 #include <QObject>
 
@@ -99,6 +100,14 @@ namespace InfoBuilderTypes {
         const QList<map::MapWaypoint> waypoints;
     };
 
+    /**
+     * @brief Data container for batch parsed route descriptions
+     */
+    struct RouteParseData{
+        const QVector<RouteStringBatch::Result>& results;
+        const qint64 elapsedMs;
+    };
+
 }
 
 #endif // INFOBUILDERTYPES_H
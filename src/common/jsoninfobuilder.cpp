@@ -333,6 +333,35 @@ QByteArray JsonInfoBuilder::uiinfo(UiInfoData uiInfoData) const
     return json.dump().data();
 }
 
+QByteArray JsonInfoBuilder::routeparse(RouteParseData routeParseData) const
+{
+
+    JSON json = {
+        { "elapsed_ms", routeParseData.elapsedMs },
+        { "routes", JSON::array() },
+    };
+
+    for(const RouteStringBatch::Result& result : routeParseData.results){
+
+        JSON messages = JSON::array();
+        for(const QString& message : result.messages)
+            messages.push_back(qUtf8Printable(message));
+
+        json["routes"].push_back({
+            { "route", qUtf8Printable(result.routeString) },
+            { "valid", result.valid },
+            { "departure", qUtf8Printable(result.departureIdent) },
+            { "destination", qUtf8Printable(result.destinationIdent) },
+            { "entries", result.numEntries },
+            { "distance_nm", result.distanceNm },
+            { "cruise_altitude_ft", result.cruiseAltitudeFt },
+            { "messages", messages },
+        });
+    }
+
+    return json.dump().data();
+}
+
 QByteArray JsonInfoBuilder::features(MapFeaturesData mapFeaturesData) const
 {
 
@@ -41,6 +41,7 @@ public:
   QByteArray airport(AirportInfoData airportInfoData) const override;
   QByteArray siminfo(SimConnectInfoData simConnectInfoData) const override;
   QByteArray uiinfo(UiInfoData uiInfoData) const override;
+  QByteArray routeparse(RouteParseData routeParseData) const override;
   QByteArray features(MapFeaturesData mapFeaturesData) const override;
   QByteArray feature(MapFeaturesData mapFeaturesData) const override;
 
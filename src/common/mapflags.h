@@ -548,6 +548,8 @@ enum TextAttribute
 
   NO_ROUND_RECT = 0x4000, /* No rounded background rect */
 
+  COLLISION_CHECK = 0x8000, /* Drop text if it overlaps other labels. Drawn deferred by priority. Needs a TextCollisionGrid in SymbolPainter. */
+
   /* Automatic text placement to octants for flight plan labels */
   PLACE_ABOVE = ABOVE | CENTER,
   PLACE_ABOVE_RIGHT = ABOVE | RIGHT,
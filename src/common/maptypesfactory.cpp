@@ -28,6 +28,20 @@ using namespace atools::geo;
 using atools::sql::SqlRecord;
 using namespace map;
 
+QString MapTypesFactory::intern(const QString& str)
+{
+  // Keep null and empty strings as they are
+  if(str.isEmpty())
+    return str;
+
+  QSet<QString>::const_iterator it = stringPool.constFind(str);
+  if(it != stringPool.constEnd())
+    return *it;
+
+  stringPool.insert(str);
+  return str;
+}
+
 void MapTypesFactory::fillAirport(const SqlRecord& record, map::MapAirport& airport, bool complete, bool nav, bool xplane)
 {
   fillAirportBase(record, airport, complete);
@@ -45,7 +59,7 @@ void MapTypesFactory::fillAirport(const SqlRecord& record, map::MapAirport& airp
     airport.asosFrequency = record.valueInt("asos_frequency");
     airport.unicomFrequency = record.valueInt("unicom_frequency");
     airport.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), record.valueFloat("altitude"));
-    airport.region = record.valueStr("region", QString());
+    airport.region = intern(record.valueStr("region", QString()));
   }
   else
     airport.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), 0.f);
@@ -67,11 +81,11 @@ void MapTypesFactory::fillRunway(const atools::sql::SqlRecord& record, map::MapR
 
   if(!overview)
   {
-    runway.surface = record.valueStr("surface");
-    runway.shoulder = record.valueStr("shoulder", QString()); // Optional X-Plane field
+    runway.surface = intern(record.valueStr("surface"));
+    runway.shoulder = intern(record.valueStr("shoulder", QString())); // Optional X-Plane field
     runway.primaryName = record.valueStr("primary_name");
     runway.secondaryName = record.valueStr("secondary_name");
-    runway.edgeLight = record.valueStr("edge_light");
+    runway.edgeLight = intern(record.valueStr("edge_light"));
     runway.width = record.valueFloat("width");
     runway.primaryOffset = record.valueFloat("primary_offset_threshold");
     runway.secondaryOffset = record.valueFloat("secondary_offset_threshold");
@@ -122,9 +136,9 @@ void MapTypesFactory::fillRunwayEnd(const atools::sql::SqlRecord& record, MapRun
   end.id = record.valueInt("runway_end_id");
   end.leftVasiPitch = record.valueFloat("left_vasi_pitch");
   end.rightVasiPitch = record.valueFloat("right_vasi_pitch");
-  end.leftVasiType = record.valueStr("left_vasi_type");
-  end.rightVasiType = record.valueStr("right_vasi_type");
-  end.pattern = record.valueStr("is_pattern", QString());
+  end.leftVasiType = intern(record.valueStr("left_vasi_type"));
+  end.rightVasiType = intern(record.valueStr("right_vasi_type"));
+  end.pattern = intern(record.valueStr("is_pattern", QString()));
 }
 
 void MapTypesFactory::fillAirportBase(const SqlRecord& record, map::MapAirport& ap, bool complete)
@@ -289,19 +303,19 @@ void MapTypesFactory::fillVorBase(const SqlRecord& record, map::MapVor& vor)
 {
   vor.id = record.valueInt("vor_id");
   vor.ident = record.valueStr("ident");
-  vor.region = record.valueStr("region");
+  vor.region = intern(record.valueStr("region"));
   vor.name = atools::capString(record.valueStr("name"));
 
   // Check also for types from the nav_search table and VORTACs
   QString type = record.valueStr("type");
   if(type == "VH" || type == "VTH")
-    vor.type = "H";
+    vor.type = intern("H");
   else if(type == "VL" || type == "VTL")
-    vor.type = "L";
+    vor.type = intern("L");
   else if(type == "VT" || type == "VTT")
-    vor.type = "T";
+    vor.type = intern("T");
   else
-    vor.type = type;
+    vor.type = intern(type);
 
   vor.tacan = type == "TC";
   vor.vortac = type.startsWith("VT");
@@ -324,9 +338,9 @@ void MapTypesFactory::fillUserdataPoint(const SqlRecord& rec, map::MapUserpoint&
   {
     obj.id = rec.valueInt("userdata_id");
     obj.ident = rec.valueStr("ident");
-    obj.region = rec.valueStr("region");
+    obj.region = intern(rec.valueStr("region"));
     obj.name = rec.valueStr("name");
-    obj.type = rec.valueStr("type");
+    obj.type = intern(rec.valueStr("type"));
     obj.description = rec.valueStr("description");
     obj.tags = rec.valueStr("tags");
     obj.temp = rec.valueBool("temp", false);
@@ -398,9 +412,9 @@ void MapTypesFactory::fillNdb(const SqlRecord& record, map::MapNdb& ndb)
 {
   ndb.id = record.valueInt("ndb_id");
   ndb.ident = record.valueStr("ident");
-  ndb.region = record.valueStr("region");
+  ndb.region = intern(record.valueStr("region"));
   ndb.name = atools::capString(record.valueStr("name"));
-  ndb.type = record.valueStr("type");
+  ndb.type = intern(record.valueStr("type"));
   ndb.frequency = record.valueInt("frequency");
   ndb.range = record.valueInt("range");
   ndb.magvar = record.valueFloat("mag_var");
@@ -424,8 +438,8 @@ void MapTypesFactory::fillHelipad(const SqlRecord& record, map::MapHelipad& heli
   helipad.width = record.value("width").toInt();
   helipad.length = record.value("length").toInt();
   helipad.heading = static_cast<int>(std::roundf(record.value("heading").toFloat()));
-  helipad.surface = record.value("surface").toString();
-  helipad.type = record.value("type").toString();
+  helipad.surface = intern(record.value("surface").toString());
+  helipad.type = intern(record.value("type").toString());
   helipad.transparent = record.value("is_transparent").toInt() > 0;
   helipad.closed = record.value("is_closed").toInt() > 0;
 }
@@ -434,9 +448,9 @@ void MapTypesFactory::fillWaypoint(const SqlRecord& record, map::MapWaypoint& wa
 {
   waypoint.id = record.valueInt(track ? "trackpoint_id" : "waypoint_id");
   waypoint.ident = record.valueStr("ident");
-  waypoint.region = record.valueStr("region");
-  waypoint.type = record.valueStr("type");
-  waypoint.arincType = record.valueStr("arinc_type", QString());
+  waypoint.region = intern(record.valueStr("region"));
+  waypoint.type = intern(record.valueStr("type"));
+  waypoint.arincType = intern(record.valueStr("arinc_type", QString()));
   waypoint.magvar = record.valueFloat("mag_var");
   waypoint.hasVictorAirways = record.valueInt("num_victor_airway") > 0;
   waypoint.hasJetAirways = record.valueInt("num_jet_airway") > 0;
@@ -449,9 +463,9 @@ void MapTypesFactory::fillWaypointFromNav(const SqlRecord& record, map::MapWaypo
 {
   waypoint.id = record.valueInt("waypoint_id");
   waypoint.ident = record.valueStr("ident");
-  waypoint.region = record.valueStr("region");
-  waypoint.type = record.valueStr("type");
-  waypoint.arincType = record.valueStr("arinc_type", QString());
+  waypoint.region = intern(record.valueStr("region"));
+  waypoint.type = intern(record.valueStr("type"));
+  waypoint.arincType = intern(record.valueStr("arinc_type", QString()));
   waypoint.magvar = record.valueFloat("mag_var");
   waypoint.hasVictorAirways = record.valueInt("waypoint_num_victor_airway") > 0;
   waypoint.hasJetAirways = record.valueInt("waypoint_num_jet_airway") > 0;
@@ -557,7 +571,7 @@ void MapTypesFactory::fillAirwayOrTrack(const SqlRecord& record, map::MapAirway&
 void MapTypesFactory::fillMarker(const SqlRecord& record, map::MapMarker& marker)
 {
   marker.id = record.valueInt("marker_id");
-  marker.type = record.valueStr("type");
+  marker.type = intern(record.valueStr("type"));
   marker.ident = record.valueStr("ident");
   marker.heading = static_cast<int>(std::round(record.valueFloat("heading")));
   marker.position = Pos(record.valueFloat("lonx"),
@@ -572,7 +586,7 @@ void MapTypesFactory::fillIls(const SqlRecord& record, map::MapIls& ils, float r
   ils.runwayName = record.valueStr("loc_runway_name");
   ils.ident = record.valueStr("ident");
   ils.name = record.valueStr("name");
-  ils.region = record.valueStr("region", QString());
+  ils.region = intern(record.valueStr("region", QString()));
 
   ils.type = static_cast<map::IlsType>(atools::strToChar(record.valueStr("type", QString())));
   ils.perfIndicator = record.valueStr("perf_indicator", QString());
@@ -692,7 +706,7 @@ void MapTypesFactory::fillAirportMsa(const atools::sql::SqlRecord& record, map::
   airportMsa.id = record.valueInt("airport_msa_id");
   airportMsa.airportIdent = record.valueStr("airport_ident");
   airportMsa.navIdent = record.valueStr("nav_ident");
-  airportMsa.region = record.valueStr("region");
+  airportMsa.region = intern(record.valueStr("region"));
   airportMsa.multipleCode = record.valueStr("multiple_code");
 
   airportMsa.vorType = record.valueStr("vor_type");
@@ -722,7 +736,7 @@ void MapTypesFactory::fillParking(const SqlRecord& record, map::MapParking& park
 {
   parking.id = record.valueInt("parking_id");
   parking.airportId = record.valueInt("airport_id");
-  parking.type = record.valueStr("type");
+  parking.type = intern(record.valueStr("type"));
   parking.name = record.valueStr("name");
   parking.suffix = record.valueStr("suffix", QString());
   parking.airlineCodes = record.valueStr("airline_codes");
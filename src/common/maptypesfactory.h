@@ -20,6 +20,8 @@
 
 #include "common/mapflags.h"
 
+#include <QSet>
+
 namespace atools {
 namespace sql {
 
@@ -50,6 +52,9 @@ struct MapAirportMsa;
 /*
  * Create all map objects (namespace maptypes) from sql records. The sql records can be
  * a result from sql queries or manually built.
+ *
+ * Each instance keeps a pool of strings with only a few distinct values like region codes and type names.
+ * Objects created by the same factory share these. Not thread safe - use one instance per query object.
  */
 class MapTypesFactory
 {
@@ -104,6 +109,10 @@ private:
   map::MapAirportFlags fillAirportFlags(const atools::sql::SqlRecord& record, bool overview);
   map::MapType strToType(const QString& navType);
 
+  /* Get shared copy of str from the pool or add it. Idents and names are not interned since they are mostly unique. */
+  QString intern(const QString& str);
+
+  QSet<QString> stringPool;
 };
 
 #endif // LITTLENAVMAP_MAPTYPESFACTORY_H
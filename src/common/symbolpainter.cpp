@@ -19,6 +19,7 @@
 
 #include "common/mapcolors.h"
 #include "common/maptypes.h"
+#include "common/textcollisiongrid.h"
 #include "common/unit.h"
 #include "fs/util/fsutil.h"
 #include "fs/weather/metar.h"
@@ -27,14 +28,83 @@
 #include "options/optiondata.h"
 #include "util/paintercontextsaver.h"
 
+#include <QMutex>
+#include <QPaintEngine>
 #include <QPainter>
+#include <QStaticText>
 #include <QStringBuilder>
 
+#include <cmath>
+
 using namespace Marble;
 using namespace map;
 using atools::geo::angleToQt;
 using atools::fs::util::roundComFrequency;
 
+// Maximum size of all sprites in kB
+const static int SPRITE_CACHE_SIZE_KB = 16 * 1024;
+
+// Maximum number of label texts kept laid out
+const static int TEXT_LAYOUT_CACHE_SIZE = 10000;
+
+namespace {
+// Sprites are shared between all instances since many temporary painters are created for icons
+QCache<SymbolSpriteKey, QImage> spriteCache(SPRITE_CACHE_SIZE_KB);
+QMutex spriteCacheMutex;
+
+/* Key for a laid out label text. Font includes size and attributes like bold or underline. */
+struct TextLayoutKey
+{
+  QString text;
+  QFont font;
+
+  bool operator==(const TextLayoutKey& other) const
+  {
+    return text == other.text && font == other.font;
+  }
+
+};
+
+inline uint qHash(const TextLayoutKey& key)
+{
+  return qHash(key.text) ^ qHash(key.font);
+}
+
+/* Shaped text and its bounding rectangle at origin */
+struct TextLayout
+{
+  QStaticText staticText;
+  QRectF boundingRect;
+};
+
+// Least recently used label texts. Avoids shaping the same idents and names again for each frame.
+QCache<TextLayoutKey, TextLayout> textLayoutCache(TEXT_LAYOUT_CACHE_SIZE);
+QMutex textLayoutCacheMutex;
+
+/* Get shaped text and bounding rectangle from cache or create them */
+TextLayout textLayout(const QString& text, const QFont& font, const QFontMetricsF& metrics)
+{
+  TextLayoutKey key = {text, font};
+  {
+    QMutexLocker locker(&textLayoutCacheMutex);
+    TextLayout *cached = textLayoutCache.object(key);
+    if(cached != nullptr)
+      return *cached;
+  }
+
+  TextLayout layout;
+  layout.staticText.setText(text);
+  layout.staticText.setTextFormat(Qt::PlainText);
+  layout.staticText.prepare(QTransform(), font);
+  layout.boundingRect = metrics.boundingRect(text);
+
+  QMutexLocker locker(&textLayoutCacheMutex);
+  textLayoutCache.insert(key, new TextLayout(layout));
+  return layout;
+}
+
+}
+
 QIcon SymbolPainter::createAirportIcon(const map::MapAirport& airport, int size)
 {
   QPixmap pixmap(size, size);
@@ -244,6 +314,35 @@ void SymbolPainter::drawHelipadSymbol(QPainter *painter, const map::MapHelipad&
 
 void SymbolPainter::drawAirportSymbol(QPainter *painter, const map::MapAirport& airport,
                                       float x, float y, float size, bool isAirportDiagram, bool fast, bool addonHighlight)
+{
+  bool addon = airport.addon() && addonHighlight;
+  quint64 flags = static_cast<quint64>(airport.flags.testFlag(AP_HARD)) |
+                  static_cast<quint64>(airport.flags.testFlag(AP_MIL)) << 1 |
+                  static_cast<quint64>(airport.flags.testFlag(AP_CLOSED)) << 2 |
+                  static_cast<quint64>(airport.anyFuel()) << 3 |
+                  static_cast<quint64>(airport.waterOnly()) << 4 |
+                  static_cast<quint64>(airport.helipadOnly()) << 5 |
+                  static_cast<quint64>(airport.helipad()) << 6 |
+                  static_cast<quint64>(airport.longestRunwayLength == 0) << 7 |
+                  static_cast<quint64>(addon) << 8 |
+                  static_cast<quint64>(isAirportDiagram) << 9 |
+                  static_cast<quint64>(fast) << 10 |
+                  static_cast<quint64>(atools::roundToInt(airport.longestRunwayHeading) % 360) << 16;
+
+  SymbolSpriteKey key(SymbolSpriteKey::AIRPORT, size, flags, mapcolors::colorForAirport(airport).rgba(),
+                      mapcolors::airportSymbolFillColor.rgba(),
+                      addon ? mapcolors::addonAirportBackgroundColor.rgba() : 0,
+                      addon ? mapcolors::addonAirportFrameColor.rgba() : 0);
+
+  // Add space for fuel spikes, addon highlight and pen widths
+  if(!drawSprite(painter, key, x, y, size * 1.6f + 16.f, [=, &airport](QPainter *spritePainter, float spriteX, float spriteY) {
+        drawAirportSymbolInternal(spritePainter, airport, spriteX, spriteY, size, isAirportDiagram, fast, addonHighlight);
+      }))
+    drawAirportSymbolInternal(painter, airport, x, y, size, isAirportDiagram, fast, addonHighlight);
+}
+
+void SymbolPainter::drawAirportSymbolInternal(QPainter *painter, const map::MapAirport& airport,
+                                              float x, float y, float size, bool isAirportDiagram, bool fast, bool addonHighlight)
 {
   if(airport.longestRunwayLength == 0 && !airport.helipad())
     // Reduce size for airports without runways and without helipads
@@ -348,6 +447,18 @@ void SymbolPainter::drawAirportSymbol(QPainter *painter, const map::MapAirport&
 }
 
 void SymbolPainter::drawWaypointSymbol(QPainter *painter, const QColor& col, float x, float y, float size, bool fill)
+{
+  QColor color = col.isValid() ? col : mapcolors::waypointSymbolColor;
+
+  // Miter joins need more space than the size
+  SymbolSpriteKey key(SymbolSpriteKey::WAYPOINT, size, fill, color.rgba(), fill ? mapcolors::routeTextBoxColor.rgba() : 0);
+  if(!drawSprite(painter, key, x, y, size * 2.f + 8.f, [=, &color](QPainter *spritePainter, float spriteX, float spriteY) {
+        drawWaypointSymbolInternal(spritePainter, color, spriteX, spriteY, size, fill);
+      }))
+    drawWaypointSymbolInternal(painter, color, x, y, size, fill);
+}
+
+void SymbolPainter::drawWaypointSymbolInternal(QPainter *painter, const QColor& col, float x, float y, float size, bool fill)
 {
   atools::util::PainterContextSaver saver(painter);
   painter->setBackgroundMode(Qt::TransparentMode);
@@ -898,6 +1009,31 @@ void SymbolPainter::drawProcedureFaf(QPainter *painter, float x, float y, float
 
 void SymbolPainter::drawVorSymbol(QPainter *painter, const map::MapVor& vor, float x, float y, float size, float sizeLarge, bool routeFill,
                                   bool fast)
+{
+  // Compass rose is rotated by magnetic variation - draw directly
+  if(sizeLarge > 0.f && !vor.dmeOnly)
+  {
+    drawVorSymbolInternal(painter, vor, x, y, size, sizeLarge, routeFill, fast);
+    return;
+  }
+
+  quint64 flags = static_cast<quint64>(vor.tacan) |
+                  static_cast<quint64>(vor.vortac) << 1 |
+                  static_cast<quint64>(vor.hasDme) << 2 |
+                  static_cast<quint64>(vor.dmeOnly) << 3 |
+                  static_cast<quint64>(routeFill) << 4 |
+                  static_cast<quint64>(fast) << 5;
+
+  SymbolSpriteKey key(SymbolSpriteKey::VOR, size, flags, mapcolors::vorSymbolColor.rgba(),
+                      routeFill ? mapcolors::routeTextBoxColor.rgba() : 0);
+  if(!drawSprite(painter, key, x, y, size * 1.5f + 8.f, [=, &vor](QPainter *spritePainter, float spriteX, float spriteY) {
+        drawVorSymbolInternal(spritePainter, vor, spriteX, spriteY, size, sizeLarge, routeFill, fast);
+      }))
+    drawVorSymbolInternal(painter, vor, x, y, size, sizeLarge, routeFill, fast);
+}
+
+void SymbolPainter::drawVorSymbolInternal(QPainter *painter, const map::MapVor& vor, float x, float y, float size, float sizeLarge,
+                                          bool routeFill, bool fast)
 {
   atools::util::PainterContextSaver saver(painter);
 
@@ -1046,6 +1182,18 @@ void SymbolPainter::drawVorSymbol(QPainter *painter, const map::MapVor& vor, flo
 }
 
 void SymbolPainter::drawNdbSymbol(QPainter *painter, float x, float y, float size, bool routeFill, bool fast)
+{
+  quint64 flags = static_cast<quint64>(routeFill) | static_cast<quint64>(fast) << 1;
+
+  SymbolSpriteKey key(SymbolSpriteKey::NDB, size, flags, mapcolors::ndbSymbolColor.rgba(),
+                      routeFill ? mapcolors::routeTextBoxColor.rgba() : 0);
+  if(!drawSprite(painter, key, x, y, size + 8.f, [=](QPainter *spritePainter, float spriteX, float spriteY) {
+        drawNdbSymbolInternal(spritePainter, spriteX, spriteY, size, routeFill, fast);
+      }))
+    drawNdbSymbolInternal(painter, x, y, size, routeFill, fast);
+}
+
+void SymbolPainter::drawNdbSymbolInternal(QPainter *painter, float x, float y, float size, bool routeFill, bool fast)
 {
   atools::util::PainterContextSaver saver(painter);
 
@@ -1082,6 +1230,20 @@ void SymbolPainter::drawNdbSymbol(QPainter *painter, float x, float y, float siz
 }
 
 void SymbolPainter::drawMarkerSymbol(QPainter *painter, const map::MapMarker& marker, float x, float y, float size, bool fast)
+{
+  // Heading is only used for the lens shape
+  quint64 flags = static_cast<quint64>(fast);
+  if(!fast && size > 5.f)
+    flags |= static_cast<quint64>(atools::roundToInt(marker.heading) % 360) << 8;
+
+  if(!drawSprite(painter, SymbolSpriteKey(SymbolSpriteKey::MARKER, size, flags, mapcolors::markerSymbolColor.rgba()),
+                 x, y, size + 8.f, [=, &marker](QPainter *spritePainter, float spriteX, float spriteY) {
+        drawMarkerSymbolInternal(spritePainter, marker, spriteX, spriteY, size, fast);
+      }))
+    drawMarkerSymbolInternal(painter, marker, x, y, size, fast);
+}
+
+void SymbolPainter::drawMarkerSymbolInternal(QPainter *painter, const map::MapMarker& marker, float x, float y, float size, bool fast)
 {
   atools::util::PainterContextSaver saver(painter);
 
@@ -1144,7 +1306,11 @@ void SymbolPainter::drawNdbText(QPainter *painter, const map::MapNdb& ndb, float
       texts.append(*addtionalText);
   }
 
-  textBoxF(painter, texts, mapcolors::ndbSymbolColor, x, y, atts, fill ? 255 : 0);
+  // Drop label if overlapping - flight plan labels are always drawn
+  if(!flags.testFlag(textflags::ROUTE_TEXT))
+    atts |= textatt::COLLISION_CHECK;
+
+  textBoxF(painter, texts, mapcolors::ndbSymbolColor, x, y, atts, fill ? 255 : 0, QColor(), TextCollisionGrid::PRIO_NDB);
 }
 
 void SymbolPainter::drawVorText(QPainter *painter, const map::MapVor& vor, float x, float y, textflags::TextFlags flags, float size,
@@ -1192,7 +1358,11 @@ void SymbolPainter::drawVorText(QPainter *painter, const map::MapVor& vor, float
       texts.append(*addtionalText);
   }
 
-  textBoxF(painter, texts, mapcolors::vorSymbolColor, x, y, atts, fill ? 255 : 0);
+  // Drop label if overlapping - flight plan labels are always drawn
+  if(!flags.testFlag(textflags::ROUTE_TEXT))
+    atts |= textatt::COLLISION_CHECK;
+
+  textBoxF(painter, texts, mapcolors::vorSymbolColor, x, y, atts, fill ? 255 : 0, QColor(), TextCollisionGrid::PRIO_VOR);
 }
 
 void SymbolPainter::adjustPos(float& x, float& y, float size, textatt::TextAttributes atts)
@@ -1243,7 +1413,11 @@ void SymbolPainter::drawWaypointText(QPainter *painter, const map::MapWaypoint&
       texts.append(*addtionalText);
   }
 
-  textBoxF(painter, texts, mapcolors::waypointSymbolColor, x, y, atts, fill ? 255 : 0);
+  // Drop label if overlapping - flight plan labels are always drawn
+  if(!flags.testFlag(textflags::ROUTE_TEXT))
+    atts |= textatt::COLLISION_CHECK;
+
+  textBoxF(painter, texts, mapcolors::waypointSymbolColor, x, y, atts, fill ? 255 : 0, QColor(), TextCollisionGrid::PRIO_WAYPOINT);
 }
 
 void SymbolPainter::drawAirportText(QPainter *painter, const map::MapAirport& airport, float x, float y,
@@ -1282,7 +1456,12 @@ void SymbolPainter::drawAirportText(QPainter *painter, const map::MapAirport& ai
     if(flags & textflags::NO_BACKGROUND)
       transparency = 0;
 
-    textBoxF(painter, texts, mapcolors::colorForAirport(airport), x, y, atts, transparency);
+    // Drop label if overlapping - flight plan and logbook labels are always drawn
+    if(!flags.testFlag(textflags::ROUTE_TEXT) && !flags.testFlag(textflags::LOG_TEXT))
+      atts |= textatt::COLLISION_CHECK;
+
+    textBoxF(painter, texts, mapcolors::colorForAirport(airport), x, y, atts, transparency, QColor(),
+             TextCollisionGrid::PRIO_AIRPORT);
   }
 }
 
@@ -1343,7 +1522,7 @@ void SymbolPainter::textBox(QPainter *painter, const QStringList& texts, const Q
 }
 
 void SymbolPainter::textBoxF(QPainter *painter, QStringList texts, QPen textPen, float x, float y, textatt::TextAttributes atts,
-                             int transparency, const QColor& backgroundColor)
+                             int transparency, const QColor& backgroundColor, TextCollisionGrid::Priority priority)
 {
   // Added margins to background retangle to avoid letters touching the border
   // Windows needs different margins due to fontengine=freetype
@@ -1459,13 +1638,28 @@ void SymbolPainter::textBoxF(QPainter *painter, QStringList texts, QPen textPen,
     // Center text vertically
     yoffset = -totalHeight / 2.f;
 
-  // Draw background rectangle if and calculate text positions ===================
-  painter->setPen(Qt::NoPen);
-
+  // Calculate text positions and background rectangles ===================
   QVector<QPointF> textPt;
+  QVector<QRectF> textRects;
+  QVector<bool> textSmall;
+  QVector<QStaticText> staticTexts;
+  QRectF textRect;
+
+  // Cached layouts are prepared for an identity transform - use them only for unscaled raster output
+  // and not for printing or devices with a pixel ratio
+  bool useStaticText = isUnscaledRaster(painter) && painter->deviceTransform().type() <= QTransform::TxTranslate;
   for(const QString& text : qAsConst(texts))
   {
-    QRectF boundingRect = metrics.boundingRect(text);
+    QRectF boundingRect;
+    if(useStaticText)
+    {
+      TextLayout layout = textLayout(text, painter->font(), metrics);
+      staticTexts.append(layout.staticText);
+      boundingRect = layout.boundingRect;
+    }
+    else
+      boundingRect = metrics.boundingRect(text);
+
     double w = boundingRect.width();
     double newx = x;
     if(atts.testFlag(textatt::LEFT))
@@ -1478,41 +1672,81 @@ void SymbolPainter::textBoxF(QPainter *painter, QStringList texts, QPen textPen,
     QPointF pt(newx, y + yoffset);
     textPt.append(pt);
 
+    boundingRect.moveTo(pt);
+    textSmall.append(boundingRect.height() < 14);
+    if(textSmall.constLast())
+      // Use smaller margins for small fonts
+      boundingRect = boundingRect.marginsAdded(TEXT_MARGINS_SMALL);
+    else
+      // Extend bottom margin for underlined letters
+      boundingRect = boundingRect.marginsAdded(atts.testFlag(textatt::UNDERLINE) ? TEXT_MARGINS_UNDERLINE : TEXT_MARGINS);
+    textRects.append(boundingRect);
+    textRect = textRect.united(boundingRect);
+
+    yoffset += height;
+  }
+
+  // Draws background rectangles and texts - needs only captured values since it might be called later
+  QFont font = painter->font();
+  QBrush brush = painter->brush();
+  QBrush background = painter->background();
+  Qt::BGMode backgroundMode = painter->backgroundMode();
+  bool noRoundRect = atts.testFlag(textatt::NO_ROUND_RECT);
+  QPointF ascent(0., metrics.ascent());
+  auto drawFunc = [ = ](QPainter *labelPainter) {
+    labelPainter->setFont(font);
+
+    // Draw background rectangles ===================
     if(fill)
     {
-      boundingRect.moveTo(pt);
-
-      if(atts.testFlag(textatt::NO_ROUND_RECT))
-      {
-        if(boundingRect.height() < 14)
-          // Use smaller margins for small fonts
-          painter->drawRect(boundingRect.marginsAdded(TEXT_MARGINS_SMALL));
-        else
-          // Extend bottom margin for underlined letters
-          painter->drawRect(boundingRect.marginsAdded(atts.testFlag(textatt::UNDERLINE) ? TEXT_MARGINS_UNDERLINE : TEXT_MARGINS));
-      }
-      else
+      labelPainter->setBackgroundMode(backgroundMode);
+      labelPainter->setBackground(background);
+      labelPainter->setBrush(brush);
+      labelPainter->setPen(Qt::NoPen);
+      for(int i = 0; i < textRects.size(); i++)
       {
-        if(boundingRect.height() < 14)
-          // Use smaller margins for small fonts
-          painter->drawRoundedRect(boundingRect.marginsAdded(TEXT_MARGINS_SMALL), 2., 2.);
+        if(noRoundRect)
+          labelPainter->drawRect(textRects.at(i));
+        else if(textSmall.at(i))
+          labelPainter->drawRoundedRect(textRects.at(i), 2., 2.);
         else
-          // Extend bottom margin for underlined letters
-          painter->drawRoundedRect(boundingRect.marginsAdded(atts.testFlag(textatt::UNDERLINE) ? TEXT_MARGINS_UNDERLINE : TEXT_MARGINS),
-                                   4., 4.);
+          labelPainter->drawRoundedRect(textRects.at(i), 4., 4.);
       }
     }
-    yoffset += height;
-  }
 
-  painter->setBackgroundMode(Qt::TransparentMode);
-  painter->setBrush(Qt::NoBrush);
-  painter->setPen(textPen);
+    labelPainter->setBackgroundMode(Qt::TransparentMode);
+    labelPainter->setBrush(Qt::NoBrush);
+    labelPainter->setPen(textPen);
 
-  // Draw texts =================================
-  QPointF ascent(0., metrics.ascent());
-  for(int i = 0; i < texts.size(); i++)
-    painter->drawText(textPt.at(i) + ascent, texts.at(i));
+    // Draw texts =================================
+    if(useStaticText)
+    {
+      // Cached layouts - position is top left
+      for(int i = 0; i < staticTexts.size(); i++)
+        labelPainter->drawStaticText(textPt.at(i), staticTexts.at(i));
+    }
+    else
+    {
+      for(int i = 0; i < texts.size(); i++)
+        labelPainter->drawText(textPt.at(i) + ascent, texts.at(i));
+    }
+  };
+
+  // Check for overlap with other labels ===================
+  if(textCollisionGrid != nullptr)
+  {
+    if(atts.testFlag(textatt::COLLISION_CHECK))
+    {
+      // Placed by priority and drawn after all layers reserved space for labels which are always drawn
+      textCollisionGrid->defer(priority, textRect, drawFunc);
+      return;
+    }
+    else
+      // Always drawn but keep space free for others
+      textCollisionGrid->reserve(textRect);
+  }
+
+  drawFunc(painter);
 }
 
 QRectF SymbolPainter::textBoxSize(QPainter *painter, const QStringList& texts, textatt::TextAttributes atts)
@@ -1557,6 +1791,59 @@ QRectF SymbolPainter::textBoxSize(QPainter *painter, const QStringList& texts, t
   return retval;
 }
 
+bool SymbolPainter::isUnscaledRaster(QPainter *painter)
+{
+  // Raster output which is not rotated or scaled
+  // Printing and SVG export use vector drawing
+  return painter->paintEngine() != nullptr && painter->paintEngine()->type() == QPaintEngine::Raster &&
+         painter->transform().type() <= QTransform::TxTranslate;
+}
+
+bool SymbolPainter::drawSprite(QPainter *painter, SymbolSpriteKey key, float x, float y, float extent,
+                               const std::function<void(QPainter *spritePainter, float spriteX, float spriteY)>& drawFunc)
+{
+  if(!isUnscaledRaster(painter) || extent < 1.f)
+    return false;
+
+  // Add painter state which is copied into the sprite painter
+  qreal pixelRatio = painter->device()->devicePixelRatioF();
+  key.dpr = atools::roundToInt(pixelRatio * 100.);
+  key.hints = static_cast<int>(painter->renderHints());
+  key.background = painter->background().color().rgba();
+
+  QImage sprite;
+  {
+    QMutexLocker locker(&spriteCacheMutex);
+    QImage *cached = spriteCache.object(key);
+    if(cached != nullptr)
+      sprite = *cached;
+  }
+
+  if(sprite.isNull())
+  {
+    // Create new sprite for the key ===================================
+    int pixel = static_cast<int>(std::ceil(extent * pixelRatio));
+    sprite = QImage(pixel, pixel, QImage::Format_ARGB32_Premultiplied);
+    sprite.setDevicePixelRatio(pixelRatio);
+    sprite.fill(Qt::transparent);
+
+    QPainter spritePainter(&sprite);
+    spritePainter.setRenderHints(painter->renderHints());
+    spritePainter.setBackground(painter->background());
+    float center = static_cast<float>(pixel / pixelRatio / 2.);
+    drawFunc(&spritePainter, center, center);
+    spritePainter.end();
+
+    QMutexLocker locker(&spriteCacheMutex);
+    spriteCache.insert(key, new QImage(sprite), std::max(1, static_cast<int>(sprite.sizeInBytes() / 1024)));
+  }
+
+  // Image is centered - top left corner in logical coordinates
+  float half = static_cast<float>(sprite.width() / pixelRatio / 2.);
+  painter->drawImage(QPointF(x - half, y - half), sprite);
+  return true;
+}
+
 const QPixmap *SymbolPainter::windPointerFromCache(int size)
 {
   if(windPointerPixmaps.contains(size))
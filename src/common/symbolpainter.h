@@ -21,12 +21,15 @@
 #include "options/optiondata.h"
 
 #include "common/mapflags.h"
+#include "common/textcollisiongrid.h"
 
 #include <QColor>
 #include <QIcon>
 #include <QCoreApplication>
 #include <QCache>
 
+#include <functional>
+
 namespace atools {
 namespace fs {
 namespace weather {
@@ -55,11 +58,49 @@ struct MapHelipad;
 struct MapAirportMsa;
 }
 
+/* Key for the pre-rendered symbol sprites. Size is in quarter pixels and device pixel ratio in percent.
+ * Contains all colors used to draw the symbol and the painter state copied into the sprite painter. */
+struct SymbolSpriteKey
+{
+  enum Type : quint8
+  {
+    AIRPORT, WAYPOINT, VOR, NDB, MARKER
+  };
+
+  SymbolSpriteKey(Type typeParam, float sizeParam, quint64 flagsParam, QRgb colorParam, QRgb fillColorParam = 0,
+                  QRgb underlayColorParam = 0, QRgb underlayFrameColorParam = 0)
+    : flags(flagsParam), color(colorParam), fillColor(fillColorParam), underlayColor(underlayColorParam),
+    underlayFrameColor(underlayFrameColorParam), size(static_cast<int>(sizeParam * 4.f + 0.5f)), type(typeParam)
+  {
+  }
+
+  bool operator==(const SymbolSpriteKey& other) const
+  {
+    return flags == other.flags && color == other.color && fillColor == other.fillColor &&
+           underlayColor == other.underlayColor && underlayFrameColor == other.underlayFrameColor &&
+           background == other.background && size == other.size && dpr == other.dpr && hints == other.hints &&
+           type == other.type;
+  }
+
+  quint64 flags;
+  QRgb color, fillColor, underlayColor, underlayFrameColor, background = 0;
+  int size, dpr = 100, hints = 0;
+  Type type;
+};
+
+inline uint qHash(const SymbolSpriteKey& key)
+{
+  return ::qHash(key.flags) ^ key.color ^ (key.fillColor * 31) ^ (key.underlayColor * 131) ^ (key.underlayFrameColor * 257) ^
+         (key.background * 17) ^ (static_cast<uint>(key.size) << 8) ^ (static_cast<uint>(key.dpr) << 20) ^
+         (static_cast<uint>(key.hints) << 24) ^ key.type;
+}
+
 /*
  * Draws all kind of map symbols and texts into an icon or a QPainter. Icons can change shape depending on size.
  * Separate functions are available for texts/captions.
  * An additional parameter "fast" is used to draw icons with less details while scrolling the map.
- * Instead of using a text collision detection text are placed on different sides of the symbols.
+ * Texts are placed on different sides of the symbols. Labels having textatt::COLLISION_CHECK set are dropped
+ * if they overlap already drawn labels if a collision grid is set.
  */
 class SymbolPainter
 {
@@ -153,9 +194,11 @@ public:
   void textBox(QPainter *painter, const QStringList& texts, const QPen& textPen, int x, int y,
                textatt::TextAttributes atts = textatt::NONE,
                int transparency = 255, const QColor& backgroundColor = QColor());
+  /* Texts with attribute textatt::COLLISION_CHECK are deferred and placed by priority if a collision grid is set */
   void textBoxF(QPainter *painter, QStringList texts, QPen textPen, float x, float y,
                 textatt::TextAttributes atts = textatt::NONE,
-                int transparency = 255, const QColor& backgroundColor = QColor());
+                int transparency = 255, const QColor& backgroundColor = QColor(),
+                TextCollisionGrid::Priority priority = TextCollisionGrid::PRIO_USERPOINT);
 
   /* Get dimensions of a custom text box */
   QRectF textBoxSize(QPainter *painter, const QStringList& texts, textatt::TextAttributes atts);
@@ -167,7 +210,31 @@ public:
   /* Move coordinates by size based on text placement attributes */
   void adjustPos(float& x, float& y, float size, textatt::TextAttributes atts);
 
+  /* Grid used by textBoxF() to detect overlapping labels. Not owned. Null disables collision detection. */
+  void setTextCollisionGrid(TextCollisionGrid *grid)
+  {
+    textCollisionGrid = grid;
+  }
+
 private:
+  /* Internal methods doing the actual drawing either into the sprite or directly on the painter */
+  void drawAirportSymbolInternal(QPainter *painter, const map::MapAirport& airport, float x, float y, float size,
+                                 bool isAirportDiagram, bool fast, bool addonHighlight);
+  void drawWaypointSymbolInternal(QPainter *painter, const QColor& color, float x, float y, float size, bool fill);
+  void drawVorSymbolInternal(QPainter *painter, const map::MapVor& vor, float x, float y, float size, float sizeLarge,
+                             bool routeFill, bool fast);
+  void drawNdbSymbolInternal(QPainter *painter, float x, float y, float size, bool routeFill, bool fast);
+  void drawMarkerSymbolInternal(QPainter *painter, const map::MapMarker& marker, float x, float y, float size, bool fast);
+
+  /* true if painter draws into a raster device without scaling or rotation. Needed for sprites and cached text layouts. */
+  static bool isUnscaledRaster(QPainter *painter);
+
+  /* Draw a symbol as one pixmap from the shared sprite cache. The sprite is created by calling drawFunc which has to
+   * draw the symbol centered at the given coordinates. extent is the width and height of the sprite.
+   * Returns false if the painter cannot use sprites, e.g. when printing or if scaled or rotated. */
+  bool drawSprite(QPainter *painter, SymbolSpriteKey key, float x, float y, float extent,
+                  const std::function<void(QPainter *spritePainter, float spriteX, float spriteY)>& drawFunc);
+
   QStringList airportTexts(optsd::DisplayOptionsAirport dispOpts, textflags::TextFlags flags,
                            const map::MapAirport& airport, int maxTextLength);
   const QPixmap *windPointerFromCache(int size);
@@ -185,6 +252,7 @@ private:
 
   static int airportMsaSize(QPainter *painter, const map::MapAirportMsa& airportMsa, float sizeFactor, bool drawDetails);
 
+  TextCollisionGrid *textCollisionGrid = nullptr;
 };
 
 #endif // LITTLENAVMAP_SYMBOLPAINTER_H
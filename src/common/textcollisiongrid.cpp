@@ -0,0 +1,104 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/textcollisiongrid.h"
+
+#include "util/paintercontextsaver.h"
+
+#include <algorithm>
+#include <cmath>
+
+void TextCollisionGrid::cellRange(const QRectF& rect, int& x1, int& y1, int& x2, int& y2)
+{
+  x1 = static_cast<int>(std::floor(rect.left() / CELL_SIZE));
+  y1 = static_cast<int>(std::floor(rect.top() / CELL_SIZE));
+  x2 = static_cast<int>(std::floor(rect.right() / CELL_SIZE));
+  y2 = static_cast<int>(std::floor(rect.bottom() / CELL_SIZE));
+}
+
+bool TextCollisionGrid::overlaps(const QRectF& rect) const
+{
+  if(cells.isEmpty() || rect.isEmpty())
+    return false;
+
+  int x1, y1, x2, y2;
+  cellRange(rect, x1, y1, x2, y2);
+
+  for(int x = x1; x <= x2; x++)
+  {
+    for(int y = y1; y <= y2; y++)
+    {
+      QHash<quint32, QVector<QRectF> >::const_iterator it = cells.constFind(cellKey(x, y));
+      if(it != cells.constEnd())
+      {
+        for(const QRectF& reserved : it.value())
+        {
+          if(reserved.intersects(rect))
+            return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+void TextCollisionGrid::reserve(const QRectF& rect)
+{
+  if(rect.isEmpty())
+    return;
+
+  int x1, y1, x2, y2;
+  cellRange(rect, x1, y1, x2, y2);
+
+  for(int x = x1; x <= x2; x++)
+  {
+    for(int y = y1; y <= y2; y++)
+      cells[cellKey(x, y)].append(rect);
+  }
+}
+
+bool TextCollisionGrid::tryReserve(const QRectF& rect)
+{
+  if(overlaps(rect))
+    return false;
+
+  reserve(rect);
+  return true;
+}
+
+void TextCollisionGrid::defer(Priority priority, const QRectF& rect, const std::function<void(QPainter *)>& drawFunc)
+{
+  deferred.append({priority, rect, drawFunc});
+}
+
+void TextCollisionGrid::drawDeferred(QPainter *painter)
+{
+  // Keep painting order for labels having the same priority
+  std::stable_sort(deferred.begin(), deferred.end(), [](const DeferredLabel& label1, const DeferredLabel& label2) {
+    return label1.priority < label2.priority;
+  });
+
+  for(const DeferredLabel& label : qAsConst(deferred))
+  {
+    if(tryReserve(label.rect))
+    {
+      atools::util::PainterContextSaver saver(painter);
+      label.drawFunc(painter);
+    }
+  }
+  deferred.clear();
+}
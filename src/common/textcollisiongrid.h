@@ -0,0 +1,105 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_TEXTCOLLISIONGRID_H
+#define LITTLENAVMAP_TEXTCOLLISIONGRID_H
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+#include <functional>
+
+class QPainter;
+
+/*
+ * Screen space occupancy grid for map labels. Painters reserve the rectangles of drawn texts and can check
+ * if a new label would overlap one of these. Allows to drop cluttered labels before drawing them.
+ *
+ * Labels which can be dropped are not drawn immediately but queued by defer(). drawDeferred() places them in order of
+ * priority after all labels which are always drawn (flight plan, logbook) reserved their space.
+ * This keeps the priority independent of the painting order of the layers.
+ *
+ * Cells are created on demand. Lives in the paint context and is emptied for each frame.
+ */
+class TextCollisionGrid
+{
+public:
+  /* Priority of deferred labels. Lower values are placed first. */
+  enum Priority
+  {
+    PRIO_AIRPORT,
+    PRIO_VOR,
+    PRIO_NDB,
+    PRIO_WAYPOINT,
+    PRIO_USERPOINT
+  };
+
+  /* true if rect overlaps with any reserved rectangle */
+  bool overlaps(const QRectF& rect) const;
+
+  /* Add rectangle to the grid */
+  void reserve(const QRectF& rect);
+
+  /* Reserves rect and returns true if it does not overlap. Returns false and does nothing otherwise. */
+  bool tryReserve(const QRectF& rect);
+
+  /* Queue a label which is drawn by drawDeferred() only if rect does not overlap at that time.
+   * drawFunc has to set all painter attributes it needs. */
+  void defer(Priority priority, const QRectF& rect, const std::function<void(QPainter *painter)>& drawFunc);
+
+  /* Place all deferred labels in order of priority and draw the ones which do not overlap. Clears the queue. */
+  void drawDeferred(QPainter *painter);
+
+  void clear()
+  {
+    cells.clear();
+    deferred.clear();
+  }
+
+  bool isEmpty() const
+  {
+    return cells.isEmpty() && deferred.isEmpty();
+  }
+
+private:
+  /* Cell size in pixel - about the size of a short label */
+  static constexpr int CELL_SIZE = 48;
+
+  /* Get cell range covering the rectangle */
+  static void cellRange(const QRectF& rect, int& x1, int& y1, int& x2, int& y2);
+
+  static quint32 cellKey(int x, int y)
+  {
+    return static_cast<quint32>((x + 0x8000) & 0xffff) << 16 | static_cast<quint32>((y + 0x8000) & 0xffff);
+  }
+
+  /* Reserved rectangles by cell key. A rectangle is stored in all cells it touches. */
+  QHash<quint32, QVector<QRectF> > cells;
+
+  struct DeferredLabel
+  {
+    Priority priority;
+    QRectF rect;
+    std::function<void(QPainter *painter)> drawFunc;
+  };
+
+  /* Labels waiting for drawDeferred() in painting order */
+  QVector<DeferredLabel> deferred;
+};
+
+#endif // LITTLENAVMAP_TEXTCOLLISIONGRID_H
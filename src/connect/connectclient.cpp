@@ -19,6 +19,7 @@
 
 #include "app/navapp.h"
 #include "common/constants.h"
+#include "connect/simdatarecorder.h"
 #include "fs/sc/simconnectreply.h"
 #include "fs/sc/datareaderthread.h"
 #include "gui/dialog.h"
@@ -46,6 +47,9 @@ using atools::fs::sc::DataReaderThread;
 
 const static int FLUSH_QUEUE_MS = 50;
 
+/* Wait not longer than this for the map to draw the last packet before sending the next one */
+const static int MAX_MAP_PAINT_WAIT_MS = 250;
+
 /* Any metar fetched from the Simulator will time out in 15 seconds */
 const static int WEATHER_TIMEOUT_FS_SECS = 15;
 const static int NOT_AVAILABLE_TIMEOUT_FS_SECS = 300;
@@ -103,9 +107,23 @@ ConnectClient::ConnectClient(MainWindow *parent)
   reconnectNetworkTimer.setSingleShot(true);
   connect(&reconnectNetworkTimer, &QTimer::timeout, this, &ConnectClient::connectInternalAuto);
 
+  pendingDataPacket = new atools::fs::sc::SimConnectData;
+  dataPacketTimer.setSingleShot(true);
+  dataPacketTimer.setInterval(MAX_MAP_PAINT_WAIT_MS);
+  connect(&dataPacketTimer, &QTimer::timeout, this, &ConnectClient::mapPaintTimeout);
+
   flushQueuedRequestsTimer.setInterval(FLUSH_QUEUE_MS);
   connect(&flushQueuedRequestsTimer, &QTimer::timeout, this, &ConnectClient::flushQueuedRequests);
   flushQueuedRequestsTimer.start();
+
+  // Recording of simulator data for later replay =================================
+  QString recordFile = NavApp::getStartupOptionStr(lnm::STARTUP_SIM_RECORD);
+  if(!recordFile.isEmpty())
+  {
+    recorder = new SimDataRecorder(recordFile);
+    if(!recorder->open())
+      ATOOLS_DELETE(recorder);
+  }
 }
 
 ConnectClient::~ConnectClient()
@@ -117,6 +135,11 @@ ConnectClient::~ConnectClient()
 
   disconnectClicked();
 
+  dataPacketTimer.stop();
+  ATOOLS_DELETE(pendingDataPacket);
+
+  ATOOLS_DELETE_LOG(replay);
+  ATOOLS_DELETE_LOG(recorder);
   ATOOLS_DELETE_LOG(dataReader);
   ATOOLS_DELETE_LOG(simConnectHandler);
   ATOOLS_DELETE_LOG(xpConnectHandler);
@@ -168,6 +191,13 @@ void ConnectClient::connectToServerDialog()
 
 void ConnectClient::tryConnectOnStartup()
 {
+  if(!NavApp::getStartupOptionStr(lnm::STARTUP_SIM_REPLAY).isEmpty())
+  {
+    // Replay recorded data instead of connecting
+    if(startReplay())
+      return;
+  }
+
   if(connectDialog->isAutoConnect())
   {
     reconnectNetworkTimer.stop();
@@ -178,6 +208,55 @@ void ConnectClient::tryConnectOnStartup()
   }
 }
 
+bool ConnectClient::startReplay()
+{
+  QString speedStr = NavApp::getStartupOptionStr(lnm::STARTUP_SIM_REPLAY_SPEED);
+  bool ok = true;
+  float speed = speedStr.isEmpty() ? 1.f : speedStr.toFloat(&ok);
+  if(!ok || speed < 0.f)
+  {
+    qWarning() << Q_FUNC_INFO << "Invalid replay speed" << speedStr;
+    speed = 1.f;
+  }
+
+  replay = new SimDataReplay(this, NavApp::getStartupOptionStr(lnm::STARTUP_SIM_REPLAY), speed);
+  connect(replay, &SimDataReplay::dataPacketReplayed, this, &ConnectClient::postSimConnectData);
+  connect(replay, &SimDataReplay::replayFinished, this, &ConnectClient::replayFinished);
+
+  if(replay->start())
+  {
+    mainWindow->setConnectionStatusMessageText(tr("Replay"), tr("Replaying recorded simulator data."));
+    connectDialog->setConnected(true);
+    mainWindow->setStatusMessage(tr("Replaying recorded simulator data."), true /* addLog */);
+    emit connectedToSimulator();
+    emit weatherUpdated();
+    return true;
+  }
+  else
+  {
+    mainWindow->setStatusMessage(tr("Cannot replay recorded simulator data."), true /* addLog */);
+    ATOOLS_DELETE(replay);
+    return false;
+  }
+}
+
+void ConnectClient::replayFinished()
+{
+  qDebug() << Q_FUNC_INFO;
+
+  mainWindow->setConnectionStatusMessageText(tr("Disconnected"), tr("Replay of recorded simulator data finished."));
+  connectDialog->setConnected(isConnected());
+  clearPendingDataPacket();
+  metarIdentCache.clear();
+
+  if(!NavApp::isShuttingDown())
+  {
+    mainWindow->setStatusMessage(tr("Replay finished."), true /* addLog */);
+    emit disconnectedFromSimulator();
+    emit weatherUpdated();
+  }
+}
+
 QString ConnectClient::simName() const
 {
   if(connectDialog->isAnyConnectDirect())
@@ -248,6 +327,7 @@ void ConnectClient::disconnectedFromSimulatorDirect()
     mainWindow->setConnectionStatusMessageText(tr("Disconnected"), tr("Disconnected from local flight simulator."));
   connectDialog->setConnected(isConnected());
 
+  clearPendingDataPacket();
   metarIdentCache.clear();
   outstandingReplies.clear();
   queuedRequests.clear();
@@ -264,77 +344,149 @@ void ConnectClient::disconnectedFromSimulatorDirect()
   manualDisconnect = false;
 }
 
+void ConnectClient::queueDataPacket(const atools::fs::sc::SimConnectData& dataPacket)
+{
+  if(dataPacketPending && verbose)
+    qDebug() << Q_FUNC_INFO << "Dropping packet while map is drawing";
+
+  *pendingDataPacket = dataPacket;
+  dataPacketPending = true;
+
+  if(!waitForMapPaint)
+    // Map is idle - send now. Otherwise packets arriving until then replace the pending one.
+    sendPendingDataPacket();
+}
+
+void ConnectClient::sendPendingDataPacket()
+{
+  if(!dataPacketPending)
+    return;
+
+  atools::fs::sc::SimConnectData dataPacket(*pendingDataPacket);
+  dataPacketPending = false;
+
+  // Receivers might call mapPaintScheduled() while emitting
+  prepareDataPacket(dataPacket);
+  emit dataPacketReceived(dataPacket);
+}
+
+void ConnectClient::mapPaintScheduled()
+{
+  waitForMapPaint = true;
+  dataPacketTimer.start();
+}
+
+void ConnectClient::mapPainted()
+{
+  if(waitForMapPaint)
+  {
+    waitForMapPaint = false;
+    dataPacketTimer.stop();
+    sendPendingDataPacket();
+  }
+}
+
+void ConnectClient::mapPaintTimeout()
+{
+  // Map did not draw in time - do not block other receivers
+  waitForMapPaint = false;
+  sendPendingDataPacket();
+}
+
+void ConnectClient::clearPendingDataPacket()
+{
+  dataPacketTimer.stop();
+  dataPacketPending = waitForMapPaint = false;
+}
+
+/* Fix and update names and flags in packet which is about to be sent around */
+void ConnectClient::prepareDataPacket(atools::fs::sc::SimConnectData& dataPacket)
+{
+  // AI list does not include user aircraft
+  dataPacket.updateIndexesAndKeys();
+
+  atools::fs::sc::SimConnectUserAircraft& userAircraft = dataPacket.getUserAircraft();
+  // Workaround for MSFS sending wrong positions around 0/0 while in menu
+  if(!userAircraft.isFullyValid())
+  {
+    if(verbose)
+      qDebug() << Q_FUNC_INFO << "User aircraft not fully valid";
+    // Invalidate position at the 0,0 position if no groundspeed
+    userAircraft.setCoordinates(atools::geo::EMPTY_POS);
+  }
+
+  // Modify AI aircraft and set shadow flag if a online network aircraft is registered as shadowed in the index
+  NavApp::getOnlinedataController()->updateAircraftShadowState(dataPacket);
+
+  // Update the MSFS translated aircraft names and types ===================================
+  /* Mooney, Boeing, Actually aircraft model. */
+  // const QString& getAirplaneType() const
+  // const QString& getAirplaneAirline() const
+  /* Beech Baron 58 Paint 1 */
+  // const QString& getAirplaneTitle() const
+  /* Short ICAO code MD80, BE58, etc. Actually type designator. */
+  // const QString& getAirplaneModel() const
+  const atools::fs::scenery::LanguageJson& languageIndex = NavApp::getLanguageIndex();
+  if(!languageIndex.isEmpty())
+  {
+    // Change user aircraft names
+    userAircraft.updateAircraftNames(languageIndex.getName(userAircraft.getAirplaneType()),
+                                     languageIndex.getName(userAircraft.getAirplaneAirline()),
+                                     languageIndex.getName(userAircraft.getAirplaneTitle()),
+                                     languageIndex.getName(userAircraft.getAirplaneModel()));
+
+    // Change AI names
+    for(atools::fs::sc::SimConnectAircraft& ac : dataPacket.getAiAircraft())
+      ac.updateAircraftNames(languageIndex.getName(ac.getAirplaneType()),
+                             languageIndex.getName(ac.getAirplaneAirline()),
+                             languageIndex.getName(ac.getAirplaneTitle()),
+                             languageIndex.getName(ac.getAirplaneModel()));
+  }
+
+  // Update ICAO aircraft designator from aircraft.cfg for MSFS ===================================
+  QString aircraftCfgKey = userAircraft.getProperties().value(atools::fs::sc::PROP_AIRCRAFT_CFG).getValueString();
+  if(!aircraftCfgKey.isEmpty())
+    // Has property - fetch from index by loaded aircraft.cfg values
+    userAircraft.setAirplaneModel(NavApp::getAircraftIndex().getIcaoTypeDesignator(aircraftCfgKey));
+
+  // Fix incorrect on-ground status which appears from some traffic tools =======================
+  for(atools::fs::sc::SimConnectAircraft& ac : dataPacket.getAiAircraft())
+  {
+    // Ground speed given and too high for ground operations
+    bool gsFlying = ac.getGroundSpeedKts() < map::INVALID_SPEED_VALUE && ac.getGroundSpeedKts() > 40.f;
+
+    // Vertical speed given and too high for ground
+    bool vsFlying = ac.getVerticalSpeedFeetPerMin() < map::INVALID_SPEED_VALUE &&
+                    (ac.getVerticalSpeedFeetPerMin() > 100.f || ac.getVerticalSpeedFeetPerMin() < -100.f);
+
+    if(ac.isOnGround() && (gsFlying || vsFlying))
+      ac.setFlag(atools::fs::sc::ON_GROUND);
+  }
+}
+
 /* Posts data received directly from simconnect or the socket and caches any metar reports */
 void ConnectClient::postSimConnectData(atools::fs::sc::SimConnectData dataPacket)
 {
   if(dataPacket.getStatus() == atools::fs::sc::OK)
   {
+    // Save unmodified packet
+    if(recorder != nullptr && !isReplay())
+      recorder->write(dataPacket);
+
     // Check for empty weather replies or metar replys. Aircraft is not valid in this case.
     if(!dataPacket.isEmptyReply())
     {
-      // AI list does not include user aircraft
-      dataPacket.updateIndexesAndKeys();
-
-      atools::fs::sc::SimConnectUserAircraft& userAircraft = dataPacket.getUserAircraft();
-      // Workaround for MSFS sending wrong positions around 0/0 while in menu
-      if(!userAircraft.isFullyValid())
-      {
-        if(verbose)
-          qDebug() << Q_FUNC_INFO << "User aircraft not fully valid";
-        // Invalidate position at the 0,0 position if no groundspeed
-        userAircraft.setCoordinates(atools::geo::EMPTY_POS);
-      }
-
-      // Modify AI aircraft and set shadow flag if a online network aircraft is registered as shadowed in the index
-      NavApp::getOnlinedataController()->updateAircraftShadowState(dataPacket);
-
-      // Update the MSFS translated aircraft names and types ===================================
-      /* Mooney, Boeing, Actually aircraft model. */
-      // const QString& getAirplaneType() const
-      // const QString& getAirplaneAirline() const
-      /* Beech Baron 58 Paint 1 */
-      // const QString& getAirplaneTitle() const
-      /* Short ICAO code MD80, BE58, etc. Actually type designator. */
-      // const QString& getAirplaneModel() const
-      const atools::fs::scenery::LanguageJson& languageIndex = NavApp::getLanguageIndex();
-      if(!languageIndex.isEmpty())
-      {
-        // Change user aircraft names
-        userAircraft.updateAircraftNames(languageIndex.getName(userAircraft.getAirplaneType()),
-                                         languageIndex.getName(userAircraft.getAirplaneAirline()),
-                                         languageIndex.getName(userAircraft.getAirplaneTitle()),
-                                         languageIndex.getName(userAircraft.getAirplaneModel()));
-
-        // Change AI names
-        for(atools::fs::sc::SimConnectAircraft& ac : dataPacket.getAiAircraft())
-          ac.updateAircraftNames(languageIndex.getName(ac.getAirplaneType()),
-                                 languageIndex.getName(ac.getAirplaneAirline()),
-                                 languageIndex.getName(ac.getAirplaneTitle()),
-                                 languageIndex.getName(ac.getAirplaneModel()));
-      }
-
-      // Update ICAO aircraft designator from aircraft.cfg for MSFS ===================================
-      QString aircraftCfgKey = userAircraft.getProperties().value(atools::fs::sc::PROP_AIRCRAFT_CFG).getValueString();
-      if(!aircraftCfgKey.isEmpty())
-        // Has property - fetch from index by loaded aircraft.cfg values
-        userAircraft.setAirplaneModel(NavApp::getAircraftIndex().getIcaoTypeDesignator(aircraftCfgKey));
-
-      // Fix incorrect on-ground status which appears from some traffic tools =======================
-      for(atools::fs::sc::SimConnectAircraft& ac : dataPacket.getAiAircraft())
+      if(recorder != nullptr || isReplay())
       {
-        // Ground speed given and too high for ground operations
-        bool gsFlying = ac.getGroundSpeedKts() < map::INVALID_SPEED_VALUE && ac.getGroundSpeedKts() > 40.f;
-
-        // Vertical speed given and too high for ground
-        bool vsFlying = ac.getVerticalSpeedFeetPerMin() < map::INVALID_SPEED_VALUE &&
-                        (ac.getVerticalSpeedFeetPerMin() > 100.f || ac.getVerticalSpeedFeetPerMin() < -100.f);
-
-        if(ac.isOnGround() && (gsFlying || vsFlying))
-          ac.setFlag(atools::fs::sc::ON_GROUND);
+        // Pass on each packet while recording or replaying to keep the results independent of timing
+        clearPendingDataPacket();
+        prepareDataPacket(dataPacket);
+        emit dataPacketReceived(dataPacket);
       }
-
-      emit dataPacketReceived(dataPacket);
-    } // if(!dataPacket.isEmptyReply())
+      else
+        // Pass on now or later if packets arrive faster than they can be displayed
+        queueDataPacket(dataPacket);
+    }
 
     if(!dataPacket.getMetars().isEmpty())
     {
@@ -636,6 +788,12 @@ void ConnectClient::disconnectClicked()
 
   dataReader->terminateThread();
 
+  if(isReplay())
+  {
+    replay->stop();
+    replayFinished();
+  }
+
   // Close but do not allow reconnect if auto is on
   closeSocket(false);
 }
@@ -747,13 +905,19 @@ void ConnectClient::connectInternal()
 
 bool ConnectClient::isConnectedActive() const
 {
-  return (socket != nullptr && socket->isOpen() && socketConnected) || (dataReader != nullptr && dataReader->isConnected());
+  return (socket != nullptr && socket->isOpen() && socketConnected) || (dataReader != nullptr && dataReader->isConnected()) ||
+         isReplay();
 }
 
 bool ConnectClient::isConnected() const
 {
-  // socket or SimConnect or Xpconnect
-  return (socket != nullptr && socket->isOpen()) || (dataReader != nullptr && dataReader->isConnected());
+  // socket or SimConnect or Xpconnect or replay from file
+  return (socket != nullptr && socket->isOpen()) || (dataReader != nullptr && dataReader->isConnected()) || isReplay();
+}
+
+bool ConnectClient::isReplay() const
+{
+  return replay != nullptr && replay->isActive();
 }
 
 bool ConnectClient::isSimConnect() const
@@ -850,6 +1014,7 @@ void ConnectClient::closeSocket(bool allowRestart)
   mainWindow->setConnectionStatusMessageText(msg, msgTooltip);
   connectDialog->setConnected(isConnected());
 
+  clearPendingDataPacket();
   metarIdentCache.clear();
   outstandingReplies.clear();
   queuedRequests.clear();
@@ -31,6 +31,8 @@ class QTcpSocket;
 class ConnectDialog;
 class MainWindow;
 class QMessageBox;
+class SimDataRecorder;
+class SimDataReplay;
 
 namespace atools {
 namespace fs {
@@ -84,6 +86,9 @@ public:
   /* Connected to Little Navconnect */
   bool isNetworkConnect() const;
 
+  /* Replaying recorded simulator data given by command line option */
+  bool isReplay() const;
+
   /* Just saves and restores the state of the dialog */
   void saveState();
   void restoreState();
@@ -102,6 +107,13 @@ public:
   /* Print the size of all container classes to detect overflow or memory leak conditions */
   void debugDumpContainerSizes() const;
 
+  /* Map requested a redraw for the last packet. Further packets are coalesced until mapPainted() is called
+   * or MAX_MAP_PAINT_WAIT_MS is exceeded. */
+  void mapPaintScheduled();
+
+  /* Map has drawn the last packet. Sends the latest coalesced packet if any. */
+  void mapPainted();
+
 signals:
   /* Emitted when new data was received from the server (Little Navconnect), SimConnect or X-Plane.
    * can be aircraft position or weather update */
@@ -149,6 +161,21 @@ private:
   void showTerminalError();
   void showXpconnectVersionWarning(const QString& xpconnectVersion);
 
+  /* Coalesce data packets arriving while the map is still drawing the last one and keep only the latest.
+   * This skips all derived calculations in the receivers for dropped packets if drawing cannot keep up.
+   * Not used while recording or replaying. */
+  void queueDataPacket(const atools::fs::sc::SimConnectData& dataPacket);
+  void sendPendingDataPacket();
+  void mapPaintTimeout();
+  void clearPendingDataPacket();
+
+  /* Update names and flags of packet before sending it around. Done only for packets which are not dropped. */
+  void prepareDataPacket(atools::fs::sc::SimConnectData& dataPacket);
+
+  /* Start replay from file given on command line. Returns false if file cannot be read. */
+  bool startReplay();
+  void replayFinished();
+
   bool silent = false, manualDisconnect = false;
   ConnectDialog *connectDialog = nullptr;
 
@@ -161,6 +188,16 @@ private:
   atools::fs::sc::SimConnectData *simConnectData = nullptr;
 
   QTcpSocket *socket = nullptr;
+
+  /* Latest packet waiting to be sent around after the map was drawn or dataPacketTimer timed out */
+  atools::fs::sc::SimConnectData *pendingDataPacket = nullptr;
+  bool dataPacketPending = false, waitForMapPaint = false;
+  QTimer dataPacketTimer;
+
+  /* Record received data or replay it instead of connecting. Set by command line options. */
+  SimDataRecorder *recorder = nullptr;
+  SimDataReplay *replay = nullptr;
+
   /* Used to trigger reconnects on socket base connections */
   QTimer reconnectNetworkTimer, flushQueuedRequestsTimer;
   MainWindow *mainWindow;
@@ -0,0 +1,181 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "connect/simdatarecorder.h"
+
+#include "fs/sc/simconnectdata.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDebug>
+
+// ==========================================================================================
+SimDataRecorder::SimDataRecorder(const QString& filename)
+  : file(filename)
+{
+
+}
+
+SimDataRecorder::~SimDataRecorder()
+{
+  qDebug() << Q_FUNC_INFO << file.fileName() << "packets" << numPackets;
+  file.close();
+}
+
+bool SimDataRecorder::open()
+{
+  if(file.open(QIODevice::WriteOnly))
+  {
+    QDataStream stream(&file);
+    stream << simrec::FILE_MAGIC_NUMBER << simrec::FILE_VERSION;
+    timer.start();
+    qDebug() << Q_FUNC_INFO << "Recording to" << file.fileName();
+    return true;
+  }
+  else
+  {
+    qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << file.errorString();
+    return false;
+  }
+}
+
+void SimDataRecorder::write(const atools::fs::sc::SimConnectData& data)
+{
+  if(!file.isOpen())
+    return;
+
+  // Serialize into buffer first to get size - write() is not const
+  QByteArray bytes;
+  QBuffer buffer(&bytes);
+  buffer.open(QIODevice::WriteOnly);
+  atools::fs::sc::SimConnectData(data).write(&buffer);
+  buffer.close();
+
+  QDataStream stream(&file);
+  stream << static_cast<qint64>(timer.elapsed()) << bytes;
+
+  if(stream.status() != QDataStream::Ok)
+  {
+    qWarning() << Q_FUNC_INFO << "Error writing" << file.fileName() << file.errorString();
+    file.close();
+  }
+  else
+    numPackets++;
+}
+
+// ==========================================================================================
+SimDataReplay::SimDataReplay(QObject *parent, const QString& filename, float speedParam)
+  : QObject(parent), file(filename), speed(speedParam)
+{
+  timer.setSingleShot(true);
+  connect(&timer, &QTimer::timeout, this, &SimDataReplay::sendNext);
+}
+
+SimDataReplay::~SimDataReplay()
+{
+  stop();
+}
+
+bool SimDataReplay::start()
+{
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << file.errorString();
+    return false;
+  }
+
+  quint32 magic = 0;
+  quint16 version = 0;
+  QDataStream stream(&file);
+  stream >> magic >> version;
+
+  if(magic != simrec::FILE_MAGIC_NUMBER || version != simrec::FILE_VERSION)
+  {
+    qWarning() << Q_FUNC_INFO << "Invalid file" << file.fileName() << "magic" << magic << "version" << version;
+    file.close();
+    return false;
+  }
+
+  qDebug() << Q_FUNC_INFO << "Replaying" << file.fileName() << "speed" << speed;
+
+  numPackets = 0;
+  lastTimestampMs = 0L;
+  readNext();
+  return true;
+}
+
+void SimDataReplay::stop()
+{
+  timer.stop();
+  delete nextData;
+  nextData = nullptr;
+
+  if(file.isOpen())
+  {
+    qDebug() << Q_FUNC_INFO << file.fileName() << "packets" << numPackets;
+    file.close();
+  }
+}
+
+void SimDataReplay::readNext()
+{
+  QDataStream stream(&file);
+  if(stream.atEnd())
+  {
+    // Reached end of file
+    stop();
+    emit replayFinished();
+    return;
+  }
+
+  qint64 timestamp = 0L;
+  QByteArray bytes;
+  stream >> timestamp >> bytes;
+
+  delete nextData;
+  nextData = new atools::fs::sc::SimConnectData;
+
+  QBuffer buffer(&bytes);
+  buffer.open(QIODevice::ReadOnly);
+  if(stream.status() != QDataStream::Ok || !nextData->read(&buffer))
+  {
+    qWarning() << Q_FUNC_INFO << "Error reading" << file.fileName() << "at packet" << numPackets;
+    stop();
+    emit replayFinished();
+    return;
+  }
+
+  nextTimestampMs = timestamp;
+
+  // Wait for the original interval scaled by speed - zero speed sends on next event loop cycle
+  qint64 intervalMs = nextTimestampMs - lastTimestampMs;
+  timer.start(speed > 0.f && intervalMs > 0 ? static_cast<int>(intervalMs / speed) : 0);
+}
+
+void SimDataReplay::sendNext()
+{
+  if(nextData != nullptr)
+  {
+    numPackets++;
+    lastTimestampMs = nextTimestampMs;
+    emit dataPacketReplayed(*nextData);
+  }
+
+  // Signal receivers might have stopped the replay
+  if(file.isOpen())
+    readNext();
+}
@@ -0,0 +1,130 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_SIMDATARECORDER_H
+#define LNM_SIMDATARECORDER_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+}
+}
+}
+
+namespace simrec {
+/* File header and version for recorded simulator data */
+const static quint32 FILE_MAGIC_NUMBER = 0x524D4E4C; // "LNMR"
+const static quint16 FILE_VERSION = 1;
+}
+
+/*
+ * Writes all data packets received by ConnectClient including AI and weather replies to a file.
+ *
+ * Each packet is stored with the elapsed milliseconds since start of recording and the serialized
+ * SimConnectData as used by the Little Navconnect network protocol.
+ * Started by command line option "--sim-record <file>".
+ */
+class SimDataRecorder
+{
+public:
+  explicit SimDataRecorder(const QString& filename);
+  ~SimDataRecorder();
+
+  SimDataRecorder(const SimDataRecorder& other) = delete;
+  SimDataRecorder& operator=(const SimDataRecorder& other) = delete;
+
+  /* Opens file and writes header. Returns false on error. */
+  bool open();
+
+  /* Append data packet. Does nothing if not open. */
+  void write(const atools::fs::sc::SimConnectData& data);
+
+  const QString& getFilename() const
+  {
+    return file.fileName();
+  }
+
+  int getNumPackets() const
+  {
+    return numPackets;
+  }
+
+private:
+  QFile file;
+  QElapsedTimer timer;
+  int numPackets = 0;
+};
+
+/*
+ * Reads a file written by SimDataRecorder and feeds the data packets back with original timing
+ * multiplied by speed factor. Zero speed sends all packets as fast as possible but still one per event loop cycle.
+ *
+ * Started by command line option "--sim-replay <file>" and "--sim-replay-speed <factor>".
+ */
+class SimDataReplay :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit SimDataReplay(QObject *parent, const QString& filename, float speedParam);
+  virtual ~SimDataReplay() override;
+
+  SimDataReplay(const SimDataReplay& other) = delete;
+  SimDataReplay& operator=(const SimDataReplay& other) = delete;
+
+  /* Opens file, checks header and starts sending packets. Returns false on error. */
+  bool start();
+
+  /* Stop replay and close file. Does not emit finished. */
+  void stop();
+
+  bool isActive() const
+  {
+    return file.isOpen();
+  }
+
+signals:
+  /* Data packet read from file */
+  void dataPacketReplayed(const atools::fs::sc::SimConnectData& simConnectData);
+
+  /* End of file reached or read error. File is closed. */
+  void replayFinished();
+
+private:
+  /* Read next packet from file and schedule it */
+  void readNext();
+
+  /* Send the scheduled packet and read the next one */
+  void sendNext();
+
+  QFile file;
+  QTimer timer;
+  float speed = 1.f;
+
+  /* Packet read ahead and its timestamp */
+  atools::fs::sc::SimConnectData *nextData = nullptr;
+  qint64 nextTimestampMs = 0L, lastTimestampMs = 0L;
+  int numPackets = 0;
+};
+
+#endif // LNM_SIMDATARECORDER_H
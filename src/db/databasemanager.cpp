@@ -48,6 +48,11 @@
 #include "gui/signalblocker.h"
 
 #include <QDir>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
 
 using atools::sql::SqlUtil;
 using atools::fs::NavDatabase;
@@ -147,13 +152,21 @@ DatabaseManager::DatabaseManager(MainWindow *parent)
     databaseSimAirspace = new SqlDatabase(dbtools::DATABASE_NAME_SIM_AIRSPACE);
     databaseNavAirspace = new SqlDatabase(dbtools::DATABASE_NAME_NAV_AIRSPACE);
 
+    // Schema updates are only done by new program versions - backup has to be complete before migration
+    bool schemaMigration = !migrate::getOptionsVersion().isValid() || migrate::getOptionsVersion() != atools::util::Version();
+
     // Open user point database =================================
+    // Backup snapshot is taken in background thread from the open database
     openWriteableDatabase(databaseUser, "userdata", "user", true /* backup */);
     userdataManager = new atools::fs::userdata::UserdataManager(databaseUser);
     if(!userdataManager->hasSchema())
       userdataManager->createSchema(false /* verboseLogging */);
     else
+    {
+      if(schemaMigration)
+        waitForBackup("userdata");
       userdataManager->updateSchema();
+    }
 
     // Open logbook database =================================
     openWriteableDatabase(databaseLogbook, "logbook", "logbook", true /* backup */);
@@ -161,7 +174,11 @@ DatabaseManager::DatabaseManager(MainWindow *parent)
     if(!logdataManager->hasSchema())
       logdataManager->createSchema(false /* verboseLogging */);
     else
+    {
+      if(schemaMigration)
+        waitForBackup("logbook");
       logdataManager->updateSchema();
+    }
 
     // Open user airspace database =================================
     openWriteableDatabase(databaseUserAirspace, "userairspace", "userairspace", false /* backup */);
@@ -209,6 +226,10 @@ DatabaseManager::DatabaseManager(MainWindow *parent)
 
 DatabaseManager::~DatabaseManager()
 {
+  // Let backups finish before databases are closed
+  for(const QString& name : backupThreads.keys())
+    waitForBackup(name);
+
   // Delete simulator switch actions
   freeActions();
 
@@ -969,31 +990,29 @@ void DatabaseManager::switchSimInternal(atools::fs::FsPaths::SimulatorType type)
   }
 }
 
+QString DatabaseManager::buildWriteableDatabaseFileName(const QString& name) const
+{
+  return databaseDirectory + QDir::separator() + lnm::DATABASE_PREFIX + name + lnm::DATABASE_SUFFIX;
+}
+
+QString DatabaseManager::buildBackupDatabaseFileName(const QString& name) const
+{
+  return databaseDirectory + QDir::separator() + lnm::DATABASE_PREFIX + name + "_backup" + lnm::DATABASE_SUFFIX;
+}
+
 void DatabaseManager::openWriteableDatabase(atools::sql::SqlDatabase *database, const QString& name,
                                             const QString& displayName, bool backup)
 {
-  QString databaseName = databaseDirectory + QDir::separator() + lnm::DATABASE_PREFIX + name + lnm::DATABASE_SUFFIX;
-
-  QString databaseNameBackup = databaseDirectory + QDir::separator() + QFileInfo(databaseName).baseName() + "_backup" +
-                               lnm::DATABASE_SUFFIX;
+  QString databaseName = buildWriteableDatabaseFileName(name);
 
   try
   {
-    if(backup)
-    {
-      // Roll copies
-      // .../ABarthel/little_navmap_db/little_navmap_userdata_backup.sqlite
-      // .../ABarthel/little_navmap_db/little_navmap_userdata_backup.sqlite.1
-      atools::io::FileRoller roller(1);
-      roller.rollFile(databaseNameBackup);
-
-      // Copy database before opening
-      bool result = QFile(databaseName).copy(databaseNameBackup);
-      qInfo() << Q_FUNC_INFO << "Copied" << databaseName << "to" << databaseNameBackup << "result" << result;
-    }
-
     dbtools::openDatabaseFileExt(database, databaseName, false /* readonly */, false /* createSchema */,
                                  false /* exclusive */, false /* auto transactions */);
+
+    if(backup)
+      // Take snapshot from a separate read-only connection in background
+      startBackup(name);
   }
   catch(atools::sql::SqlException& e)
   {
@@ -1018,6 +1037,110 @@ void DatabaseManager::openWriteableDatabase(atools::sql::SqlDatabase *database,
   }
 }
 
+void DatabaseManager::startBackup(const QString& name)
+{
+  QString databaseName = buildWriteableDatabaseFileName(name), databaseNameBackup = buildBackupDatabaseFileName(name);
+
+  if(!QFile::exists(databaseName))
+    return;
+
+  // Use a dedicated thread to avoid changing priorities of global thread pool threads
+  QString connectionName = dbtools::DATABASE_NAME_BACKUP + "_" + name;
+  QThread *thread = QThread::create([databaseName, databaseNameBackup, connectionName]() {
+    backupDatabaseThread(databaseName, databaseNameBackup, connectionName);
+  });
+  thread->setObjectName("Backup " + name);
+  backupThreads.insert(name, thread);
+
+  qDebug() << Q_FUNC_INFO << "Starting backup for" << databaseName;
+  thread->start(QThread::LowestPriority);
+}
+
+void DatabaseManager::waitForBackup(const QString& name)
+{
+  QThread *thread = backupThreads.take(name);
+  if(thread != nullptr)
+  {
+    QElapsedTimer timer;
+    timer.start();
+
+    // Caller is blocked - do not let the thread run with lowest priority anymore
+    if(thread->isRunning())
+      thread->setPriority(QThread::NormalPriority);
+    thread->wait();
+    delete thread;
+
+    if(timer.elapsed() > 0)
+      qDebug() << Q_FUNC_INFO << "Waited" << timer.elapsed() << "ms for backup of" << name;
+  }
+}
+
+void DatabaseManager::backupDatabaseThread(const QString& databaseName, const QString& databaseNameBackup,
+                                           const QString& connectionName)
+{
+  // Nothing changed since last backup - keep it and its rolled copy ==========================
+  QFileInfo databaseInfo(databaseName), backupInfo(databaseNameBackup);
+  if(backupInfo.exists() && backupInfo.size() > 0 && databaseInfo.lastModified() <= backupInfo.lastModified())
+  {
+    qInfo() << Q_FUNC_INFO << "Backup" << databaseNameBackup << "is up to date";
+    return;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Write a consistent copy into a temporary file using a separate read-only connection ==========================
+  // VACUUM INTO reads the database in one read transaction which gives a snapshot of the last committed state
+  // while the main thread connection stays open
+  QString databaseNameTemp = databaseNameBackup + ".tmp";
+  QFile::remove(databaseNameTemp);
+
+  bool result = false;
+  {
+    QSqlDatabase db = QSqlDatabase::addDatabase(dbtools::DATABASE_TYPE, connectionName);
+    db.setDatabaseName(databaseName);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=10000");
+
+    if(db.open())
+    {
+      QSqlQuery query(db);
+      result = query.exec("vacuum into '" + QString(databaseNameTemp).replace('\'', "''") + "'");
+      if(!result)
+      {
+        qWarning() << Q_FUNC_INFO << "vacuum into failed for" << databaseName << query.lastError().text();
+        QFile::remove(databaseNameTemp);
+
+        // Fall back to plain file copy for older SQLite versions.
+        // The shared lock of the open read transaction keeps the main connection from committing while copying.
+        if(db.transaction() && query.exec("select count(1) from sqlite_master") && query.next())
+          result = QFile(databaseName).copy(databaseNameTemp);
+        query.finish();
+        db.rollback();
+      }
+      query.finish();
+      db.close();
+    }
+    else
+      qWarning() << Q_FUNC_INFO << "Cannot open" << databaseName << db.lastError().text();
+  }
+  QSqlDatabase::removeDatabase(connectionName);
+
+  if(result)
+  {
+    // Roll copies only after the new copy is complete
+    // .../ABarthel/little_navmap_db/little_navmap_userdata_backup.sqlite
+    // .../ABarthel/little_navmap_db/little_navmap_userdata_backup.sqlite.1
+    atools::io::FileRoller roller(1);
+    roller.rollFile(databaseNameBackup);
+    result = QFile::rename(databaseNameTemp, databaseNameBackup);
+  }
+  else
+    QFile::remove(databaseNameTemp);
+
+  qInfo() << Q_FUNC_INFO << "Copied" << databaseName << "to" << databaseNameBackup << "result" << result
+          << "in" << timer.elapsed() << "ms";
+}
+
 void DatabaseManager::closeUserDatabase()
 {
   dbtools::closeDatabaseFile(databaseUser);
@@ -22,6 +22,7 @@
 #include "db/dbtypes.h"
 
 #include <QAction>
+#include <QHash>
 #include <QObject>
 
 namespace atools {
@@ -58,6 +59,7 @@ class DatabaseDialog;
 class MainWindow;
 class TrackManager;
 class DatabaseLoader;
+class QThread;
 
 /*
  * Takes care of all scenery database management. Switching between flight simulators, loading of scenery
@@ -125,7 +127,8 @@ public:
   /* Load MSFS aircraft.cfg files from paths */
   void loadAircraftIndex();
 
-  /* Open a writeable database for userpoints or online network data. Automatic transactions are off.  */
+  /* Open a writeable database for userpoints or online network data. Automatic transactions are off.
+   * Starts a background backup using startBackup() if backup is true. */
   void openWriteableDatabase(atools::sql::SqlDatabase *database, const QString& name, const QString& displayName, bool backup);
   void closeLogDatabase();
   void closeUserDatabase();
@@ -290,6 +293,23 @@ signals:
 private:
   void restoreState();
 
+  /* Start a low priority thread which copies the open writeable database "name" into its backup file.
+   * Call waitForBackup() before modifying the schema. */
+  void startBackup(const QString& name);
+
+  /* Wait for the backup thread of database "name" if any and delete it. Raises thread priority while waiting. */
+  void waitForBackup(const QString& name);
+
+  /* Thread method. Copies the database into a temporary file using "VACUUM INTO" on a separate read-only connection
+   * or a file copy inside a read transaction if not supported. Rolls the backup files only if this succeeded.
+   * Skips databases which were not modified since the last backup. */
+  static void backupDatabaseThread(const QString& databaseName, const QString& databaseNameBackup,
+                                   const QString& connectionName);
+
+  /* Full path for userdata, logbook and other writeable databases and their backup */
+  QString buildWriteableDatabaseFileName(const QString& name) const;
+  QString buildBackupDatabaseFileName(const QString& name) const;
+
   bool isDatabaseCompatible(atools::sql::SqlDatabase *db) const;
   bool hasData(atools::sql::SqlDatabase *db) const;
 
@@ -415,6 +435,9 @@ private:
 
   /* Show hint dialog only once per session */
   bool backgroundHintShown = false;
+
+  /* Running backup threads by database name. Destructor waits for these. */
+  QHash<QString, QThread *> backupThreads;
 };
 
 #endif // LITTLENAVMAP_DATABASEMANAGER_H
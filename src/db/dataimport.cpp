@@ -0,0 +1,241 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "db/dataimport.h"
+
+#include "db/dbtools.h"
+#include "sql/datamanagerbase.h"
+#include "sql/sqldatabase.h"
+#include "sql/sqlquery.h"
+#include "sql/sqltransaction.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QGuiApplication>
+#include <QProgressDialog>
+#include <QStringBuilder>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <atomic>
+#include <exception>
+
+namespace dataimport {
+
+/* Drop secondary indexes before and rebuild them after the import if all files together are larger than this */
+static const qint64 INDEX_REBUILD_MIN_BYTES = 2L * 1024L * 1024L;
+
+/* Update interval for the progress dialog text */
+static const int PROGRESS_UPDATE_MS = 250;
+
+enum ImportPhase
+{
+  PHASE_DROP_INDEXES,
+  PHASE_IMPORT,
+  PHASE_CREATE_INDEXES,
+  PHASE_COMMIT
+};
+
+struct ImportResult
+{
+  int numImported = 0;
+  bool canceled = false;
+  std::exception_ptr exception;
+};
+
+/* Drops all non-unique indexes of the table and returns the statements to create them again */
+static QStringList dropIndexes(atools::sql::SqlDatabase *db, const QString& table)
+{
+  QStringList names, statements;
+  atools::sql::SqlQuery query(db);
+  query.prepare("select name, sql from sqlite_master "
+                "where type = 'index' and tbl_name = :table and sql is not null and lower(sql) not like 'create unique%'");
+  query.bindValue(":table", table);
+  query.exec();
+  while(query.next())
+  {
+    names.append(query.valueStr("name"));
+    statements.append(query.valueStr("sql"));
+  }
+  query.finish();
+
+  atools::sql::SqlQuery dropQuery(db);
+  for(const QString& name : qAsConst(names))
+    dropQuery.exec("drop index if exists \"" % name % "\"");
+
+  qDebug() << Q_FUNC_INFO << "Dropped indexes" << names << "on" << table;
+  return statements;
+}
+
+/* Runs in background thread. Database is the user or logbook database file which is already opened in the main thread. */
+static ImportResult importWorker(const QString& databaseName, const QString& table, bool rebuildIndexes,
+                                 const ImportFuncType& importFunc, std::atomic_bool *canceled, std::atomic_int *phase)
+{
+  ImportResult result;
+  atools::sql::SqlDatabase::addDatabase(dbtools::DATABASE_TYPE, dbtools::DATABASE_NAME_IMPORT);
+  {
+    atools::sql::SqlDatabase db(dbtools::DATABASE_NAME_IMPORT);
+    try
+    {
+      dbtools::openDatabaseFileExt(&db, databaseName, false /* readonly */, false /* createSchema */,
+                                   false /* exclusive */, false /* auto transactions */);
+
+      // Collect all inserts and index changes in one transaction
+      atools::sql::SqlTransaction transaction(&db);
+      try
+      {
+        QStringList indexStatements;
+        if(rebuildIndexes)
+        {
+          *phase = PHASE_DROP_INDEXES;
+          indexStatements = dropIndexes(&db, table);
+        }
+
+        if(!*canceled)
+        {
+          *phase = PHASE_IMPORT;
+          result.numImported = importFunc(&db);
+        }
+
+        if(!*canceled && !indexStatements.isEmpty())
+        {
+          *phase = PHASE_CREATE_INDEXES;
+          atools::sql::SqlQuery query(&db);
+          for(const QString& statement : qAsConst(indexStatements))
+            query.exec(statement);
+        }
+
+        if(*canceled)
+        {
+          result.canceled = true;
+          result.numImported = 0;
+          transaction.rollback();
+        }
+        else
+        {
+          *phase = PHASE_COMMIT;
+          transaction.commit();
+        }
+      }
+      catch(...)
+      {
+        transaction.rollback();
+        throw;
+      }
+      db.close();
+    }
+    catch(...)
+    {
+      result.numImported = 0;
+      result.exception = std::current_exception();
+    }
+  }
+  atools::sql::SqlDatabase::removeDatabase(dbtools::DATABASE_NAME_IMPORT);
+  return result;
+}
+
+int runImport(QWidget *parent, atools::sql::DataManagerBase *manager, const QString& table, const QStringList& files,
+              const ImportFuncType& importFunc)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  qint64 totalBytes = 0;
+  for(const QString& file : files)
+    totalBytes += QFileInfo(file).size();
+  bool rebuildIndexes = totalBytes > INDEX_REBUILD_MIN_BYTES;
+
+  qDebug() << Q_FUNC_INFO << files << totalBytes << "bytes" << "rebuild indexes" << rebuildIndexes;
+
+  std::atomic_bool canceled(false);
+  std::atomic_int phase(PHASE_DROP_INDEXES);
+
+  // Application modal to avoid changes on the main thread connection while the import is running
+  QProgressDialog progress(QObject::tr("Importing ..."), QObject::tr("Cancel"), 0, 0, parent);
+  progress.setWindowTitle(QObject::tr("Little Navmap - Importing"));
+  progress.setWindowFlags(progress.windowFlags() & ~Qt::WindowContextHelpButtonHint);
+  progress.setWindowModality(Qt::ApplicationModal);
+  progress.setAutoClose(false);
+  progress.setAutoReset(false);
+  progress.setMinimumDuration(0);
+
+  QObject::connect(&progress, &QProgressDialog::canceled, [&canceled, &progress]() {
+    canceled = true;
+    progress.setLabelText(QObject::tr("Canceling import ..."));
+  });
+
+  QTimer progressTimer;
+  progressTimer.setInterval(PROGRESS_UPDATE_MS);
+  QObject::connect(&progressTimer, &QTimer::timeout, [&canceled, &phase, &progress, &timer]() {
+    if(canceled)
+      return;
+
+    QString text;
+    switch(phase)
+    {
+      case PHASE_DROP_INDEXES:
+        text = QObject::tr("Preparing import ...");
+        break;
+      case PHASE_IMPORT:
+        text = QObject::tr("Importing ...");
+        break;
+      case PHASE_CREATE_INDEXES:
+        text = QObject::tr("Updating indexes ...");
+        break;
+      case PHASE_COMMIT:
+        text = QObject::tr("Saving ...");
+        break;
+    }
+    progress.setLabelText(text % QObject::tr("\n%1 seconds elapsed.").arg(timer.elapsed() / 1000));
+  });
+
+  QFutureWatcher<ImportResult> watcher;
+  QEventLoop eventLoop;
+  QObject::connect(&watcher, &QFutureWatcher<ImportResult>::finished, &eventLoop, &QEventLoop::quit);
+
+  QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+  watcher.setFuture(QtConcurrent::run(importWorker, manager->getDatabase()->databaseName(), table, rebuildIndexes,
+                                      importFunc, &canceled, &phase));
+  progressTimer.start();
+  progress.show();
+
+  // Keep the GUI responsive while the worker is running
+  if(!watcher.isFinished())
+    eventLoop.exec();
+
+  progressTimer.stop();
+  progress.close();
+  QGuiApplication::restoreOverrideCursor();
+
+  ImportResult result = watcher.result();
+  if(result.exception)
+    std::rethrow_exception(result.exception);
+
+  qint64 elapsed = timer.elapsed();
+  if(result.canceled)
+    qDebug() << Q_FUNC_INFO << "Import canceled and rolled back after" << elapsed << "ms";
+  else
+    qDebug() << Q_FUNC_INFO << "Imported" << result.numImported << "records in" << elapsed << "ms"
+             << (elapsed > 0 ? result.numImported * 1000 / elapsed : result.numImported) << "records per second";
+
+  return result.numImported;
+}
+
+} // namespace dataimport
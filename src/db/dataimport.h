@@ -0,0 +1,56 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_DATAIMPORT_H
+#define LNM_DATAIMPORT_H
+
+#include <functional>
+
+class QWidget;
+class QString;
+class QStringList;
+
+namespace atools {
+namespace sql {
+class DataManagerBase;
+class SqlDatabase;
+}
+}
+
+namespace dataimport {
+
+/* Function doing the actual import in the worker thread. Has to create its own data manager on the given
+ * separate database connection. Returns number of imported records. */
+typedef std::function<int(atools::sql::SqlDatabase *db)> ImportFuncType;
+
+/*
+ * Runs a bulk import of userpoints or logbook entries in a background thread using a separate database
+ * connection and one single transaction. An application modal progress dialog keeps the GUI responsive and
+ * allows to cancel the import which rolls back all changes.
+ *
+ * Secondary indexes of table are dropped before and rebuilt after the import if the files are large.
+ * Number of records and throughput are logged.
+ *
+ * Returns number of imported records or 0 if canceled.
+ * Exceptions from importFunc are passed to the caller after rolling back.
+ */
+int runImport(QWidget *parent, atools::sql::DataManagerBase *manager, const QString& table, const QStringList& files,
+              const ImportFuncType& importFunc);
+
+} // namespace dataimport
+
+#endif // LNM_DATAIMPORT_H
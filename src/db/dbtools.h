@@ -60,6 +60,18 @@ const QString DATABASE_NAME_LOADER = "LNMLOADER";
 /* Used to temporary load metadata */
 const QString DATABASE_NAME_DLG_INFO_TEMP = "LNMTEMPDB2";
 
+/* Used in background thread to create backups of user databases */
+const QString DATABASE_NAME_BACKUP = "LNMBACKUPDB";
+
+/* Used in background thread to load logbook trail geometry */
+const QString DATABASE_NAME_LOG_GEOMETRY = "LNMLOGGEOMETRYDB";
+
+/* Used in background thread to load logbook statistics */
+const QString DATABASE_NAME_LOG_STATS = "LNMLOGSTATSDB";
+
+/* Used in background thread to import userpoints and logbook entries */
+const QString DATABASE_NAME_IMPORT = "LNMIMPORTDB";
+
 /* Common type for all databases */
 const QString DATABASE_TYPE = "QSQLITE";
 
@@ -55,7 +55,9 @@
 #include "mapgui/mapairporthandler.h"
 #include "mapgui/mapdetailhandler.h"
 #include "mapgui/mapmarkhandler.h"
+#include "mapgui/mapprefetcher.h"
 #include "mapgui/mapthemehandler.h"
+#include "mapgui/maptilerenderer.h"
 #include "mapgui/mapwidget.h"
 #include "app/navapp.h"
 #include "online/onlinedatacontroller.h"
@@ -68,6 +70,7 @@
 #include "route/routecontroller.h"
 #include "routeexport/routeexport.h"
 #include "routeexport/simbriefhandler.h"
+#include "routestring/routestringbatch.h"
 #include "routestring/routestringdialog.h"
 #include "routestring/routestringwriter.h"
 #include "search/airportsearch.h"
@@ -88,6 +91,7 @@
 #include "weather/weatherreporter.h"
 #include "weather/windreporter.h"
 #include "web/webcontroller.h"
+#include "web/webstream.h"
 #include "common/updatehandler.h"
 
 #include <marble/MarbleAboutDialog.h>
@@ -1035,6 +1039,7 @@ void MainWindow::connectAllSlots()
   connect(routeController, &RouteController::showPos, mapWidget, &MapPaintWidget::showPos);
   connect(routeController, &RouteController::changeMark, mapWidget, &MapWidget::changeSearchMark);
   connect(routeController, &RouteController::routeChanged, mapWidget, &MapPaintWidget::routeChanged);
+  connect(routeController, &RouteController::routeChanged, mapWidget->getMapPrefetcher(), &MapPrefetcher::routeChanged);
   connect(routeController, &RouteController::routeAltitudeChanged, mapWidget, &MapPaintWidget::routeAltitudeChanged);
   connect(routeController, &RouteController::preRouteCalc, profileWidget, &ProfileWidget::preRouteCalc);
   connect(routeController, &RouteController::showInformation, infoController, &InfoController::showInformation);
@@ -1143,6 +1148,9 @@ void MainWindow::connectAllSlots()
   connect(logdataController, &LogdataController::logDataChanged, mapWidget, &MapWidget::updateLogEntryScreenGeometry);
   connect(logdataController, &LogdataController::logDataChanged, this, &MainWindow::updateMapObjectsShown);
   connect(logdataController, &LogdataController::logDataChanged, infoController, &InfoController::updateAllInformation);
+  connect(logdataController, &LogdataController::logGeometryReady, mapWidget, [this]() {
+    mapWidget->update();
+  });
 
   connect(mapWidget, &MapWidget::aircraftTakeoff, logdataController, &LogdataController::aircraftTakeoff);
   connect(mapWidget, &MapWidget::aircraftLanding, logdataController, &LogdataController::aircraftLanding);
@@ -1588,6 +1596,16 @@ void MainWindow::connectAllSlots()
   connect(connectClient, &ConnectClient::dataPacketReceived, infoController, &InfoController::simDataChanged);
   connect(connectClient, &ConnectClient::dataPacketReceived, NavApp::getAircraftPerfController(), &AircraftPerfController::simDataChanged);
 
+  // Hold back packets while the map is drawing the last one - send next one after leaving the paint event
+  connect(mapWidget, &MapWidget::simDataPaintScheduled, connectClient, &ConnectClient::mapPaintScheduled);
+  connect(mapWidget, &MapWidget::simDataPainted, connectClient, &ConnectClient::mapPainted, Qt::QueuedConnection);
+
+  // Web server push stream - after route controller to get the updated active leg
+  WebStream *webStream = NavApp::getWebController()->getWebStream();
+  connect(connectClient, &ConnectClient::dataPacketReceived, webStream, &WebStream::simDataChanged);
+  connect(connectClient, &ConnectClient::disconnectedFromSimulator, webStream, &WebStream::disconnectedFromSimulator);
+  connect(routeController, &RouteController::routeChanged, webStream, &WebStream::routeChanged);
+
   connect(connectClient, &ConnectClient::connectedToSimulator,
           NavApp::getAircraftPerfController(), &AircraftPerfController::connectedToSimulator);
   connect(connectClient, &ConnectClient::disconnectedFromSimulator,
@@ -2704,96 +2722,122 @@ bool MainWindow::layoutOpenInternal(const QString& layoutFile)
   return false;
 }
 
-bool MainWindow::createMapImage(QPixmap& pixmap, const QString& dialogTitle, const QString& optionPrefx, QString *json)
+bool MainWindow::createMapImage(QImage& image, const QString& dialogTitle, const QString& optionPrefx, QString *json)
 {
   ImageExportDialog exportDialog(this, dialogTitle, optionPrefx, mapWidget->width(), mapWidget->height());
   int retval = exportDialog.exec();
   if(retval == QDialog::Accepted)
+    return renderMapImage(image, exportDialog, json);
+
+  return false;
+}
+
+bool MainWindow::renderMapImage(QImage& image, const ImageExportDialog& exportDialog, QString *json)
+{
+  if(exportDialog.isCurrentView())
+  {
+    // Copy image as is from current view
+    mapWidget->showOverlays(false, false /* show scale */);
+    image = mapWidget->mapScreenShot().toImage();
+    mapWidget->showOverlays(true, false /* show scale */);
+
+    if(json != nullptr)
+      *json = mapWidget->createAvitabJson();
+  }
+  else if(MapTileRenderer::isTiledRendering(*mapWidget, exportDialog.getSize()))
   {
-    if(exportDialog.isCurrentView())
+    // Large image - render in tiles to avoid one huge widget and pixmap
+    // Watermark is added by the renderer
+    try
     {
-      // Copy image as is from current view
-      mapWidget->showOverlays(false, false /* show scale */);
-      pixmap = mapWidget->mapScreenShot();
-      mapWidget->showOverlays(true, false /* show scale */);
+      MapTileRenderer renderer(this, *mapWidget, exportDialog.getSize());
+      if(!renderer.renderToImage(image))
+        return false;
 
       if(json != nullptr)
-        *json = mapWidget->createAvitabJson();
+        *json = renderer.createAvitabJson();
+      return true;
     }
-    else
+    catch(atools::Exception& e)
     {
-      // Create a map widget clone with the desired resolution
-      MapPaintWidget paintWidget(this, false /* no real widget - hidden */);
-      paintWidget.setActive(); // Activate painting
-      paintWidget.setKeepWorldRect(); // Center world rectangle when resizing
-
-      paintWidget.setAvoidBlurredMap(exportDialog.isAvoidBlurredMap());
-      paintWidget.setAdjustOnResize(exportDialog.isAvoidBlurredMap());
-
-      // Copy all map settings
-      paintWidget.copySettings(*mapWidget);
-
-      // Copy visible rectangle
-      paintWidget.copyView(*mapWidget);
-      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-
-      // Prepare drawing by painting a dummy image
-      paintWidget.prepareDraw(exportDialog.getSize().width(), exportDialog.getSize().height());
-      QGuiApplication::restoreOverrideCursor();
-
-      // Create a progress dialog
-      int numSeconds = 60;
-      QString label = tr("Waiting up to %1 seconds for map download ...\n");
-      QProgressDialog progress(label.arg(numSeconds), tr("&Ignore Downloads and Continue"), 0, numSeconds, this);
-      progress.setWindowModality(Qt::WindowModal);
-      progress.setMinimumDuration(0);
-      progress.show();
-      QApplication::processEvents();
+      atools::gui::ErrorHandler(this).handleException(e);
+      return false;
+    }
+  }
+  else
+  {
+    // Create a map widget clone with the desired resolution
+    MapPaintWidget paintWidget(this, false /* no real widget - hidden */);
+    paintWidget.setActive(); // Activate painting
+    paintWidget.setKeepWorldRect(); // Center world rectangle when resizing
 
-      // Get download job information and update progress text
-      int queuedJobs = -1, activeJobs = -1;
-      connect(paintWidget.model()->downloadManager(), &HttpDownloadManager::progressChanged, this,
-              [&progress, &queuedJobs, &activeJobs, &numSeconds, &label](int active, int queued) -> void
-      {
-        progress.setLabelText(label.arg(numSeconds) % tr("%1 downloads active and %2 downloads queued.").
-                              arg(active).arg(queued));
-        queuedJobs = queued;
-        activeJobs = active;
-      });
-
-      // Loop until seconds are over
-      for(int i = 0; i < numSeconds; i++)
-      {
-        progress.setValue(i);
-        QApplication::processEvents();
+    paintWidget.setAvoidBlurredMap(exportDialog.isAvoidBlurredMap());
+    paintWidget.setAdjustOnResize(exportDialog.isAvoidBlurredMap());
 
-        if(progress.wasCanceled() || paintWidget.renderStatus() == Marble::Complete ||
-           (queuedJobs == 0 && activeJobs == 0))
-          break;
+    // Copy all map settings
+    paintWidget.copySettings(*mapWidget);
 
-        QThread::sleep(1);
-      }
-      progress.setValue(numSeconds);
+    // Copy visible rectangle
+    paintWidget.copyView(*mapWidget);
+    QGuiApplication::setOverrideCursor(Qt::WaitCursor);
 
-      // Now draw the actual image including navaids
-      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-      pixmap = paintWidget.getPixmap(exportDialog.getSize());
-      QGuiApplication::restoreOverrideCursor();
+    // Prepare drawing by painting a dummy image
+    paintWidget.prepareDraw(exportDialog.getSize().width(), exportDialog.getSize().height());
+    QGuiApplication::restoreOverrideCursor();
 
-      if(json != nullptr)
-        // Create Avitab reference if needed
-        *json = paintWidget.createAvitabJson();
+    // Create a progress dialog
+    int numSeconds = 60;
+    QString label = tr("Waiting up to %1 seconds for map download ...\n");
+    QProgressDialog progress(label.arg(numSeconds), tr("&Ignore Downloads and Continue"), 0, numSeconds, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.show();
+    QApplication::processEvents();
+
+    // Get download job information and update progress text
+    int queuedJobs = -1, activeJobs = -1;
+    connect(paintWidget.model()->downloadManager(), &HttpDownloadManager::progressChanged, this,
+            [&progress, &queuedJobs, &activeJobs, &numSeconds, &label](int active, int queued) -> void
+    {
+      progress.setLabelText(label.arg(numSeconds) % tr("%1 downloads active and %2 downloads queued.").
+                            arg(active).arg(queued));
+      queuedJobs = queued;
+      activeJobs = active;
+    });
+
+    // Loop until seconds are over
+    for(int i = 0; i < numSeconds; i++)
+    {
+      progress.setValue(i);
+      QApplication::processEvents();
+
+      if(progress.wasCanceled() || paintWidget.renderStatus() == Marble::Complete ||
+         (queuedJobs == 0 && activeJobs == 0))
+        break;
+
+      QThread::sleep(1);
     }
-    PrintSupport::drawWatermark(QPoint(0, pixmap.height()), &pixmap);
-    return true;
+    progress.setValue(numSeconds);
+
+    // Now draw the actual image including navaids
+    QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+    image = paintWidget.getPixmap(exportDialog.getSize()).toImage();
+    QGuiApplication::restoreOverrideCursor();
+
+    if(json != nullptr)
+      // Create Avitab reference if needed
+      *json = paintWidget.createAvitabJson();
   }
-  return false;
+  PrintSupport::drawWatermark(QPoint(0, image.height()), &image);
+  return true;
 }
 
 void MainWindow::mapSaveImage()
 {
-  QPixmap pixmap;
-  if(createMapImage(pixmap, tr(" - Save Map as Image"), lnm::IMAGE_EXPORT_DIALOG))
+  // Ask for resolution first to allow streaming large images directly into the file
+  ImageExportDialog exportDialog(this, tr(" - Save Map as Image"), lnm::IMAGE_EXPORT_DIALOG, mapWidget->width(),
+                                 mapWidget->height());
+  if(exportDialog.exec() == QDialog::Accepted)
   {
     int filterIndex = -1;
 
@@ -2822,10 +2866,43 @@ void MainWindow::mapSaveImage()
           format = "bmp";
       }
 
-      if(!pixmap.save(imageFile, format, 95))
-        atools::gui::Dialog::warning(this, tr("Error saving image.\n" "Only JPG, PNG and BMP are allowed."));
-      else
-        setStatusMessage(tr("Map image saved."));
+      bool bmp = imageFile.endsWith("bmp", Qt::CaseInsensitive) || qstrcmp(format, "bmp") == 0;
+      bool png = imageFile.endsWith("png", Qt::CaseInsensitive) || qstrcmp(format, "png") == 0;
+      bool tiled = !exportDialog.isCurrentView() && MapTileRenderer::isTiledRendering(*mapWidget, exportDialog.getSize());
+
+      if(tiled && (bmp || png))
+      {
+        // Write large BMP or PNG files band by band without keeping the whole image in memory
+        try
+        {
+          MapTileRenderer renderer(this, *mapWidget, exportDialog.getSize());
+          if(bmp ? renderer.renderToBmp(imageFile) : renderer.renderToPng(imageFile))
+            setStatusMessage(tr("Map image saved."));
+        }
+        catch(atools::Exception& e)
+        {
+          atools::gui::ErrorHandler(this).handleException(e);
+        }
+      }
+      else if(!tiled ||
+              QMessageBox::question(this, QApplication::applicationName(),
+                                    tr("The image is kept in memory completely while saving as JPG which needs about %L1 MB.\n\n"
+                                       "Use PNG or BMP to save large images with low memory usage.\n\n"
+                                       "Continue?").
+                                    arg(static_cast<qint64>(exportDialog.getSize().width()) *
+                                        exportDialog.getSize().height() * 3LL / 1024LL / 1024LL),
+                                    QMessageBox::Yes | QMessageBox::No, QMessageBox::No) == QMessageBox::Yes)
+      {
+        // Render into an image in memory - large images are rendered in tiles
+        QImage image;
+        if(renderMapImage(image, exportDialog, nullptr))
+        {
+          if(!image.save(imageFile, format, 95))
+            atools::gui::Dialog::warning(this, tr("Error saving image.\n" "Only JPG, PNG and BMP are allowed."));
+          else
+            setStatusMessage(tr("Map image saved."));
+        }
+      }
     }
   }
 }
@@ -2834,9 +2911,9 @@ void MainWindow::mapSaveImageAviTab()
 {
   if(mapWidget->projection() == Marble::Mercator)
   {
-    QPixmap pixmap;
+    QImage image;
     QString json;
-    if(createMapImage(pixmap, tr(" - Save Map as Image for AviTab"), lnm::IMAGE_EXPORT_AVITAB_DIALOG, &json))
+    if(createMapImage(image, tr(" - Save Map as Image for AviTab"), lnm::IMAGE_EXPORT_AVITAB_DIALOG, &json))
     {
       if(!json.isEmpty())
       {
@@ -2873,7 +2950,7 @@ void MainWindow::mapSaveImageAviTab()
               format = "png";
           }
 
-          if(!pixmap.save(imageFile, format, 95))
+          if(!image.save(imageFile, format, 95))
             atools::gui::Dialog::warning(this, tr("Error saving image.\n" "Only JPG and PNG are allowed."));
           else
           {
@@ -2903,12 +2980,12 @@ void MainWindow::mapSaveImageAviTab()
 
 void MainWindow::mapCopyToClipboard()
 {
-  QPixmap pixmap;
-  if(createMapImage(pixmap, tr(" - Copy Map Image to Clipboard"), lnm::IMAGE_EXPORT_DIALOG))
+  QImage image;
+  if(createMapImage(image, tr(" - Copy Map Image to Clipboard"), lnm::IMAGE_EXPORT_DIALOG))
   {
     // Copy formatted and plain text to clipboard
     QMimeData *data = new QMimeData;
-    data->setImageData(pixmap);
+    data->setImageData(image);
     QGuiApplication::clipboard()->setMimeData(data);
     setStatusMessage(tr("Map image copied to clipboard."));
   }
@@ -3291,7 +3368,7 @@ void MainWindow::mainWindowShown()
   // Do delayed dock window formatting and fullscreen state after widget layout is done
   QTimer::singleShot(100, this, &MainWindow::mainWindowShownDelayed);
 
-  if(ui->actionRouteDownloadTracks->isChecked())
+  if(ui->actionRouteDownloadTracks->isChecked() || !NavApp::getStartupOptionStr(lnm::STARTUP_TRACK_FILES).isEmpty())
     QTimer::singleShot(1000, NavApp::getTrackController(), &TrackController::startDownloadStartup);
 
   // Log screen information ==============
@@ -3380,6 +3457,11 @@ void MainWindow::mainWindowShownDelayed()
   // Attempt to restore splitter after first start
   profileWidget->restoreSplitter();
 
+  // Import userpoints or logbook entries and parse route descriptions given on the command line
+  NavApp::getUserdataController()->importStartup();
+  NavApp::getLogdataController()->importStartup();
+  RouteStringBatch::parseStartup(this);
+
   NavApp::setMainWindowVisible();
 
   // Draw map ============================================================================
@@ -4522,6 +4604,7 @@ void MainWindow::preDatabaseLoad()
     routeController->preDatabaseLoad();
 
     mapWidget->preDatabaseLoad();
+    mapWidget->getMapPrefetcher()->preDatabaseLoad();
     NavApp::getWebController()->postDatabaseLoad();
 
     profileWidget->preDatabaseLoad();
@@ -4546,6 +4629,7 @@ void MainWindow::postDatabaseLoad(atools::fs::FsPaths::SimulatorType type)
   {
     NavApp::getWebController()->postDatabaseLoad();
     mapWidget->postDatabaseLoad(); // Init map widget dependent queries first
+    mapWidget->getMapPrefetcher()->postDatabaseLoad();
     NavApp::postDatabaseLoad();
     searchController->postDatabaseLoad();
     routeController->postDatabaseLoad();
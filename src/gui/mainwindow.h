@@ -29,6 +29,7 @@
 
 class ConnectClient;
 class DatabaseManager;
+class ImageExportDialog;
 class InfoController;
 class MapThemeHandler;
 class OptionsDialog;
@@ -36,6 +37,7 @@ class PrintSupport;
 class ProcedureSearch;
 class ProfileWidget;
 class QActionGroup;
+class QImage;
 class QLabel;
 class QPushButton;
 class QToolButton;
@@ -384,8 +386,12 @@ private:
   void mapSaveImageAviTab();
   void mapCopyToClipboard();
 
-  /* Opens dialog for image resolution and returns pixmap and optionally AviTab JSON */
-  bool createMapImage(QPixmap& pixmap, const QString& dialogTitle, const QString& optionPrefx, QString *json = nullptr);
+  /* Opens dialog for image resolution and returns image and optionally AviTab JSON */
+  bool createMapImage(QImage& image, const QString& dialogTitle, const QString& optionPrefx, QString *json = nullptr);
+
+  /* Renders the image for the accepted dialog. Large images in Mercator projection are rendered in tiles.
+   * Returns false if canceled or on error. */
+  bool renderMapImage(QImage& image, const ImageExportDialog& exportDialog, QString *json);
 
   void distanceChanged();
   void showDonationPage();
@@ -21,6 +21,7 @@
 #include "common/constants.h"
 #include "common/maptypes.h"
 #include "common/maptypesfactory.h"
+#include "db/dataimport.h"
 #include "db/undoredoprogress.h"
 #include "exception.h"
 #include "fs/gpx/gpxio.h"
@@ -37,6 +38,8 @@
 #include "logbook/logdataconverter.h"
 #include "common/aircrafttrail.h"
 #include "logbook/logdatadialog.h"
+#include "logbook/loggeometrycache.h"
+#include "logbook/logstatistics.h"
 #include "logbook/logstatisticsdialog.h"
 #include "sql/sqlcolumn.h"
 #include "zip/gzip.h"
@@ -57,8 +60,10 @@
 #include "gui/errorhandler.h"
 #include "common/unit.h"
 
+#include <QCoreApplication>
 #include <QDebug>
 #include <QStandardPaths>
+#include <QThread>
 
 using atools::sql::SqlTransaction;
 using atools::sql::SqlRecord;
@@ -66,10 +71,16 @@ using atools::sql::SqlColumn;
 using atools::geo::Pos;
 using atools::fs::pln::FlightplanIO;
 
+/* Undo steps in the manager. Also used to limit the list of changed ids per undo step. */
+const static int MAX_UNDO_STEPS = 50;
+
 LogdataController::LogdataController(atools::fs::userdata::LogdataManager *logdataManager, MainWindow *parent)
   : manager(logdataManager), mainWindow(parent)
 {
   dialog = new atools::gui::Dialog(mainWindow);
+  geometryCache = new LogGeometryCache(manager);
+  statistics = new LogStatistics(manager->getDatabase());
+  connect(geometryCache, &LogGeometryCache::geometryReady, this, &LogdataController::logGeometryReady);
 
   // Do not use a parent to allow the window moving to back
   statsDialog = new LogStatisticsDialog(nullptr, this);
@@ -84,7 +95,7 @@ LogdataController::LogdataController(atools::fs::userdata::LogdataManager *logda
   connect(ui->actionSearchLogdataUndo, &QAction::triggered, this, &LogdataController::undoTriggered);
   connect(ui->actionSearchLogdataRedo, &QAction::triggered, this, &LogdataController::redoTriggered);
 
-  manager->setMaximumUndoSteps(50);
+  manager->setMaximumUndoSteps(MAX_UNDO_STEPS);
   manager->setTextSuffix(tr("Logbook Entry", "Log singular"), tr("Logbook Entries", "Log plural"));
   manager->setActions(ui->actionSearchLogdataUndo, ui->actionSearchLogdataRedo);
 }
@@ -95,6 +106,8 @@ LogdataController::~LogdataController()
   delete statsDialog;
   delete aircraftAtTakeoff;
   delete dialog;
+  delete geometryCache;
+  delete statistics;
 }
 
 void LogdataController::undoTriggered()
@@ -115,7 +128,9 @@ void LogdataController::undoTriggered()
     {
       qDebug() << Q_FUNC_INFO << "Committing";
       transaction.commit();
-      manager->clearGeometryCache();
+      undoRedoStatistics(undoIds, redoIds);
+      clearCaches();
+      geometryCache->clear();
 
       emit refreshLogSearch(false /* loadAll */, false /* keepSelection */, true /* force */);
       emit logDataChanged();
@@ -146,7 +161,9 @@ void LogdataController::redoTriggered()
     {
       qDebug() << Q_FUNC_INFO << "Committing";
       transaction.commit();
-      manager->clearGeometryCache();
+      undoRedoStatistics(redoIds, undoIds);
+      clearCaches();
+      geometryCache->clear();
 
       emit refreshLogSearch(false /* loadAll */, false /* keepSelection */, true /* force */);
       emit logDataChanged();
@@ -159,6 +176,24 @@ void LogdataController::redoTriggered()
   }
 }
 
+void LogdataController::undoRedoStatistics(QVector<QSet<int> >& fromIds, QVector<QSet<int> >& toIds)
+{
+  if(!fromIds.isEmpty())
+  {
+    QSet<int> ids = fromIds.takeLast();
+    statistics->updateEntries(ids);
+    toIds.append(ids);
+  }
+  else
+  {
+    // Changes not known - read all again on next access
+    qWarning() << Q_FUNC_INFO << "No changed ids for undo step";
+    statistics->clear();
+    undoIds.clear();
+    redoIds.clear();
+  }
+}
+
 void LogdataController::showSearch()
 {
   Ui::MainWindow *ui = NavApp::getMainUi();
@@ -214,33 +249,33 @@ atools::sql::SqlRecord LogdataController::getLogEntryRecordById(int id)
 void LogdataController::getFlightStatsTime(QDateTime& earliest, QDateTime& latest, QDateTime& earliestSim,
                                            QDateTime& latestSim)
 {
-  manager->getFlightStatsTime(earliest, latest, earliestSim, latestSim);
+  statistics->getFlightStatsTime(earliest, latest, earliestSim, latestSim);
 }
 
 void LogdataController::getFlightStatsDistance(float& distTotal, float& distMax, float& distAverage)
 {
-  manager->getFlightStatsDistance(distTotal, distMax, distAverage);
+  statistics->getFlightStatsDistance(distTotal, distMax, distAverage);
 }
 
 void LogdataController::getFlightStatsAirports(int& numDepartAirports, int& numDestAirports)
 {
-  manager->getFlightStatsAirports(numDepartAirports, numDestAirports);
+  statistics->getFlightStatsAirports(numDepartAirports, numDestAirports);
 }
 
 void LogdataController::getFlightStatsTripTime(float& timeMaximum, float& timeAverage, float& timeTotal,
                                                float& timeMaximumSim, float& timeAverageSim, float& timeTotalSim)
 {
-  manager->getFlightStatsTripTime(timeMaximum, timeAverage, timeTotal, timeMaximumSim, timeAverageSim, timeTotalSim);
+  statistics->getFlightStatsTripTime(timeMaximum, timeAverage, timeTotal, timeMaximumSim, timeAverageSim, timeTotalSim);
 }
 
 void LogdataController::getFlightStatsAircraft(int& numTypes, int& numRegistrations, int& numNames, int& numSimulators)
 {
-  manager->getFlightStatsAircraft(numTypes, numRegistrations, numNames, numSimulators);
+  statistics->getFlightStatsAircraft(numTypes, numRegistrations, numNames, numSimulators);
 }
 
 void LogdataController::getFlightStatsSimulator(QVector<std::pair<int, QString> >& numSimulators)
 {
-  manager->getFlightStatsSimulator(numSimulators);
+  statistics->getFlightStatsSimulator(numSimulators);
 }
 
 void LogdataController::statisticsLogbookShow()
@@ -333,7 +368,7 @@ void LogdataController::createTakeoffLanding(const atools::fs::sc::SimConnectUse
       logEntryId = manager->getCurrentId();
       transaction.commit();
 
-      logChanged(false /* load all */, true /* keep selection */);
+      logChanged(false /* load all */, true /* keep selection */, {logEntryId});
 
       mainWindow->setStatusMessage(tr("Logbook Entry for %1 at %2%3 added.").
                                    arg(departureArrivalText).
@@ -396,8 +431,9 @@ void LogdataController::createTakeoffLanding(const atools::fs::sc::SimConnectUse
         SqlTransaction transaction(manager->getDatabase());
         manager->updateRecords(record, {logEntryId});
         transaction.commit();
+        geometryCache->invalidate({logEntryId});
 
-        logChanged(false /* load all */, false /* keep selection */);
+        logChanged(false /* load all */, false /* keep selection */, {logEntryId});
 
         mainWindow->setStatusMessage(tr("Logbook Entry for %1 at %2%3 updated.").
                                      arg(departureArrivalText).
@@ -419,10 +455,17 @@ void LogdataController::createTakeoffLanding(const atools::fs::sc::SimConnectUse
     aircraftAtTakeoff = new atools::fs::sc::SimConnectUserAircraft(aircraft);
 }
 
-void LogdataController::logChanged(bool loadAll, bool keepSelection)
+void LogdataController::logChanged(bool loadAll, bool keepSelection, const QSet<int>& changedIds)
 {
+  // Update statistics and remember changed entries for undo of this step
+  statistics->updateEntries(changedIds);
+  undoIds.append(changedIds);
+  if(undoIds.size() > MAX_UNDO_STEPS)
+    undoIds.removeFirst();
+  redoIds.clear();
+
   // Clear cache and update map screen index
-  manager->clearGeometryCache();
+  clearCaches();
   manager->updateUndoRedoActions();
 
   emit logDataChanged();
@@ -487,11 +530,21 @@ void LogdataController::preDatabaseLoad()
 
 void LogdataController::postDatabaseLoad()
 {
+  clearCaches();
+  statistics->clear();
+  undoIds.clear();
+  redoIds.clear();
+}
+
+void LogdataController::clearCaches()
+{
+  // Trail geometry is invalidated separately per changed entry
   manager->clearGeometryCache();
 }
 
 void LogdataController::displayOptionsChanged()
 {
+  // Trail geometry is not affected
   manager->clearGeometryCache();
 }
 
@@ -500,6 +553,11 @@ const atools::fs::gpx::GpxData *LogdataController::getGpxData(int id)
   return manager->getGpxData(id);
 }
 
+const LogGeometry *LogdataController::getLogGeometry(int id)
+{
+  return geometryCache->getGeometry(id);
+}
+
 void LogdataController::editLogEntryFromMap(int id)
 {
   qDebug() << Q_FUNC_INFO;
@@ -542,8 +600,10 @@ void LogdataController::editLogEntries(const QVector<int>& ids)
       SqlTransaction transaction(manager->getDatabase());
       manager->updateRecords(dlg.getRecord(), QSet<int>(ids.constBegin(), ids.constEnd()));
       transaction.commit();
+      QSet<int> idSet(ids.constBegin(), ids.constEnd());
+      geometryCache->invalidate(idSet);
 
-      logChanged(false /* load all */, true /* keep selection */);
+      logChanged(false /* load all */, true /* keep selection */, idSet);
 
       mainWindow->setStatusMessage(tr("%1 logbook %2 updated.").arg(ids.size()).arg(ids.size() == 1 ? tr("entry") : tr("entries")));
     }
@@ -647,9 +707,10 @@ void LogdataController::addLogEntry()
       newRec.setNull("logbook_id");
 
     manager->insertOneRecord(newRec);
+    int newId = manager->getCurrentId();
     transaction.commit();
 
-    logChanged(false /* load all */, false /* keep selection */);
+    logChanged(false /* load all */, false /* keep selection */, {newId});
 
     mainWindow->setStatusMessage(tr("Logbook entry added."));
   }
@@ -780,10 +841,14 @@ void LogdataController::cleanupLogEntries()
     manager->postCleanup();
 
     int removed = 0;
+    QSet<int> idsBefore;
     if(deleteEntries)
     {
       // Dialog ok - remove entries ===============================================
       QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+
+      // Remember ids to find deleted entries
+      idsBefore = statistics->getIds();
       SqlTransaction transaction(manager->getDatabase());
       removed = manager->cleanupLogEntries(choiceDialog.isChecked(DEPARTURE_AND_DESTINATION_EQUAL),
                                            choiceDialog.isChecked(DEPARTURE_OR_DESTINATION_EMPTY),
@@ -799,7 +864,12 @@ void LogdataController::cleanupLogEntries()
     {
       // Send messages ===============================================
       if(removed > 0)
-        logChanged(false /* load all */, false /* keep selection */);
+      {
+        // Deleted ids are all which are not in the table anymore
+        QSet<int> deletedIds = idsBefore.subtract(statistics->getIds());
+        geometryCache->invalidate(deletedIds);
+        logChanged(false /* load all */, false /* keep selection */, deletedIds);
+      }
       mainWindow->setStatusMessage(tr("%1 logbook %2 deleted.").arg(removed).arg(removed == 1 ? tr("entry") : tr("entries")));
     }
   }
@@ -813,8 +883,9 @@ void LogdataController::deleteLogEntries(const QSet<int>& ids)
   SqlTransaction transaction(manager->getDatabase());
   manager->deleteRows(ids);
   transaction.commit();
+  geometryCache->invalidate(ids);
 
-  logChanged(false /* load all */, false /* keep selection */);
+  logChanged(false /* load all */, false /* keep selection */, ids);
 
   mainWindow->setStatusMessage(tr("%1 logbook %2 deleted.").arg(ids.size()).arg(txt));
 }
@@ -841,16 +912,15 @@ void LogdataController::importXplane()
     int numImported = 0;
     if(!file.isEmpty())
     {
-      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-      SqlTransaction transaction(manager->getDatabase());
-      numImported += manager->importXplane(file, fetchAirportCoordinates);
-      transaction.commit();
-      QGuiApplication::restoreOverrideCursor();
+      int lastId = statistics->getMaxId();
+      numImported = runImport(file, [&file](atools::fs::userdata::LogdataManager& importManager) -> int {
+        return importManager.importXplane(file, fetchAirportCoordinates);
+      });
 
       mainWindow->setStatusMessage(tr("Imported %1 %2 X-Plane logbook.").arg(numImported).
                                    arg(numImported == 1 ? tr("entry") : tr("entries")));
 
-      logChanged(false /* load all */, false /* keep selection */);
+      logChanged(false /* load all */, false /* keep selection */, statistics->getIdsAfter(lastId));
 
       // Enable more search options to show user the search criteria
       NavApp::getMainUi()->actionLogdataSearchShowMoreOptions->setChecked(true);
@@ -864,13 +934,11 @@ void LogdataController::importXplane()
   }
   catch(atools::Exception& e)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleException(e);
   }
   catch(...)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleUnknownException();
   }
@@ -888,32 +956,79 @@ void LogdataController::importCsv()
     int numImported = 0;
     if(!file.isEmpty())
     {
-      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-      SqlTransaction transaction(manager->getDatabase());
-      numImported += manager->importCsv(file);
-      transaction.commit();
-      QGuiApplication::restoreOverrideCursor();
+      int lastId = statistics->getMaxId();
+      numImported = importCsvFile(file);
 
       mainWindow->setStatusMessage(tr("Imported %1 %2 from CSV file.").arg(numImported).
                                    arg(numImported == 1 ? tr("entry") : tr("entries")));
       mainWindow->showLogbookSearch();
-      logChanged(false /* load all */, false /* keep selection */);
+      logChanged(false /* load all */, false /* keep selection */, statistics->getIdsAfter(lastId));
     }
   }
   catch(atools::Exception& e)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleException(e);
   }
   catch(...)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleUnknownException();
   }
 }
 
+int LogdataController::importCsvFile(const QString& file)
+{
+  return runImport(file, [&file](atools::fs::userdata::LogdataManager& importManager) -> int {
+    return importManager.importCsv(file);
+  });
+}
+
+int LogdataController::runImport(const QString& file,
+                                 const std::function<int(atools::fs::userdata::LogdataManager& importManager)>& importFunc)
+{
+  QString suffixSingular = tr("Logbook Entry", "Log singular"), suffixPlural = tr("Logbook Entries", "Log plural");
+
+  return dataimport::runImport(mainWindow, manager, "logbook", {file},
+                               [&importFunc, &suffixSingular, &suffixPlural](atools::sql::SqlDatabase *db) -> int {
+    // Separate manager for the worker thread connection using the same undo settings
+    atools::fs::userdata::LogdataManager importManager(db);
+    importManager.setMaximumUndoSteps(MAX_UNDO_STEPS);
+    importManager.setTextSuffix(suffixSingular, suffixPlural);
+    return importFunc(importManager);
+  });
+}
+
+void LogdataController::importStartup()
+{
+  QString file = NavApp::getStartupOptionStr(lnm::STARTUP_IMPORT_LOGBOOK);
+  if(!file.isEmpty())
+  {
+    qDebug() << Q_FUNC_INFO << file;
+    try
+    {
+      if(atools::checkFile(Q_FUNC_INFO, file, true /* warn */))
+      {
+        int lastId = statistics->getMaxId();
+        int numImported = importCsvFile(file);
+        mainWindow->setStatusMessage(tr("Imported %1 %2 from CSV file.").arg(numImported).
+                                     arg(numImported == 1 ? tr("entry") : tr("entries")));
+        logChanged(false /* load all */, false /* keep selection */, statistics->getIdsAfter(lastId));
+      }
+    }
+    catch(atools::Exception& e)
+    {
+      NavApp::closeSplashScreen();
+      atools::gui::ErrorHandler(mainWindow).handleException(e);
+    }
+    catch(...)
+    {
+      NavApp::closeSplashScreen();
+      atools::gui::ErrorHandler(mainWindow).handleUnknownException();
+    }
+  }
+}
+
 void LogdataController::exportCsv()
 {
   qDebug() << Q_FUNC_INFO;
@@ -1016,6 +1131,7 @@ void LogdataController::convertUserdata()
   if(result == QMessageBox::Yes)
   {
     LogdataConverter converter(NavApp::getDatabaseUser(), manager, NavApp::getAirportQuerySim());
+    int lastId = statistics->getMaxId();
 
     QGuiApplication::setOverrideCursor(Qt::WaitCursor);
 
@@ -1056,7 +1172,7 @@ void LogdataController::convertUserdata()
 
     mainWindow->showLogbookSearch();
 
-    logChanged(false /* load all */, false /* keep selection */);
+    logChanged(false /* load all */, false /* keep selection */, statistics->getIdsAfter(lastId));
 
     // Enable more search options to show user the search criteria
     NavApp::getMainUi()->actionLogdataSearchShowMoreOptions->setChecked(true);
@@ -1073,6 +1189,15 @@ void LogdataController::convertUserdata()
 
 void LogdataController::fetchAirportCoordinates(atools::geo::Pos& pos, QString& name, const QString& airportIdent)
 {
+  if(QThread::currentThread() != QCoreApplication::instance()->thread())
+  {
+    // Airport query is bound to the main thread - wait for the result there
+    QMetaObject::invokeMethod(QCoreApplication::instance(), [&pos, &name, &airportIdent]() {
+      fetchAirportCoordinates(pos, name, airportIdent);
+    }, Qt::BlockingQueuedConnection);
+    return;
+  }
+
   map::MapAirport airport = NavApp::getAirportQuerySim()->getAirportByIdent(airportIdent);
 
   if(airport.isValid())
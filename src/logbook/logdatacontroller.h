@@ -21,8 +21,11 @@
 #include "common/maptypes.h"
 
 #include <QObject>
+#include <QSet>
 #include <QVector>
 
+#include <functional>
+
 namespace atools {
 namespace sql {
 class SqlRecord;
@@ -66,6 +69,9 @@ struct MapLogbookEntry;
 class MainWindow;
 class LogStatisticsDialog;
 class LogdataDialog;
+class LogGeometryCache;
+class LogStatistics;
+struct LogGeometry;
 class QAction;
 /*
  * Methods to edit, add, delete, import and export logbook entries. Also creates entries for flight events.
@@ -94,6 +100,9 @@ public:
   void importCsv();
   void exportCsv();
 
+  /* Import logbook CSV file given on the command line without user interaction */
+  void importStartup();
+
   /* Import X-Plane text logbook - does not commit. */
   void importXplane();
 
@@ -115,6 +124,8 @@ public:
   map::MapLogbookEntry getLogEntryById(int id);
   atools::sql::SqlRecord getLogEntryRecordById(int id);
 
+  /* Statistics below are served from memory and updated incrementally on each change */
+
   /* Get various statistical information for departure times */
   void getFlightStatsTime(QDateTime& earliest, QDateTime& latest, QDateTime& earliestSim, QDateTime& latestSim);
 
@@ -152,6 +163,11 @@ public:
 
   const atools::fs::gpx::GpxData *getGpxData(int id);
 
+  /* Get flight plan and simplified trail geometry for the map display. Created once per entry and cached.
+   * Returns null if nothing is attached or if still loading in background. logGeometryReady() is sent
+   * once loaded. Pointer is valid until the next call. */
+  const LogGeometry *getLogGeometry(int id);
+
   /* Clear caches */
   void preDatabaseLoad();
   void postDatabaseLoad();
@@ -186,10 +202,16 @@ signals:
   /* Issue a redraw of the map */
   void logDataChanged();
 
+  /* Trail geometry was loaded in background. Issue a redraw of the map. */
+  void logGeometryReady();
+
   /* Show search after converting or importing entries */
   void showInSearch(map::MapTypes type, const atools::sql::SqlRecord& record, bool select);
 
 private:
+  /* Clear geometry caches after logbook modifications */
+  void clearCaches();
+
   /* Create a logbook entry on takeoff and update it on landing */
   void createTakeoffLanding(const atools::fs::sc::SimConnectUserAircraft& aircraft, bool takeoff,
                             float flownDistanceNm);
@@ -197,7 +219,7 @@ private:
   /* Prefill record for add dialog with values from current program state */
   void prefillLogEntry(atools::sql::SqlRecord& rec);
 
-  /* Callback function for X-Plane import */
+  /* Callback function for X-Plane import. Queries the airport in the main thread if called from the import worker. */
   static void fetchAirportCoordinates(atools::geo::Pos& pos, QString& name, const QString& airportIdent);
 
   /* Attach the current flight plan and performance file to the record as Gzipped XML files */
@@ -206,8 +228,18 @@ private:
   /* Connect buttons in dialog with above */
   void connectDialogSignals(LogdataDialog *dialog);
 
-  /* Emit signals for changed */
-  void logChanged(bool loadAll, bool keepSelection);
+  /* Update statistics for changed, added or deleted entries, remember them for undo and emit signals for changed */
+  void logChanged(bool loadAll, bool keepSelection, const QSet<int>& changedIds);
+
+  /* Update statistics for entries changed by an undo or redo step. Moves ids from one stack to the other. */
+  void undoRedoStatistics(QVector<QSet<int> >& fromIds, QVector<QSet<int> >& toIds);
+
+  /* Import CSV file in one transaction. Returns number of entries. */
+  int importCsvFile(const QString& file);
+
+  /* Runs importFunc in a background thread on a separate manager configured like the main one.
+   * Returns number of entries. */
+  int runImport(const QString& file, const std::function<int(atools::fs::userdata::LogdataManager& importManager)>& importFunc);
 
   void planAttachLnmpln(atools::sql::SqlRecord *record, const QString& filename, QWidget *parent);
   void perfAttachLnmperf(atools::sql::SqlRecord *record, const QString& filename, QWidget *parent);
@@ -225,6 +257,12 @@ private:
   LogStatisticsDialog *statsDialog = nullptr;
 
   atools::fs::userdata::LogdataManager *manager;
+  LogGeometryCache *geometryCache;
+  LogStatistics *statistics;
+
+  /* Ids of entries changed by each undo or redo step in the manager. Used to update statistics. */
+  QVector<QSet<int> > undoIds, redoIds;
+
   atools::gui::Dialog *dialog;
   MainWindow *mainWindow;
 };
@@ -0,0 +1,358 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "logbook/loggeometrycache.h"
+
+#include "db/dbtools.h"
+#include "fs/gpx/gpxio.h"
+#include "fs/gpx/gpxtypes.h"
+#include "fs/userdata/logdatamanager.h"
+#include "geo/calculations.h"
+#include "sql/sqldatabase.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QPointF>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QtConcurrent/QtConcurrentRun>
+
+using atools::geo::LineString;
+
+namespace {
+/* Simplification tolerance in nautical miles for each level of detail. First level is nearly unchanged. */
+const static QVector<float> LEVEL_TOLERANCE_NM = {0.01f, 0.1f, 0.5f, 2.f, 8.f};
+
+/* Maximum allowed deviation on screen in pixel when selecting a level */
+const static float MAX_DEVIATION_PIXEL = 1.5f;
+}
+
+int LogGeometry::numPoints() const
+{
+  int num = route.size();
+  for(const QVector<LineString>& level : trails)
+  {
+    for(const LineString& line : level)
+      num += line.size();
+  }
+  return num;
+}
+
+LogGeometryCache::LogGeometryCache(atools::fs::userdata::LogdataManager *logdataManager, QObject *parent)
+  : QObject(parent), manager(logdataManager)
+{
+  geometryCache.setMaxCost(CACHE_MAX_POINTS);
+  connect(&watcher, &QFutureWatcher<LogGeometryList>::finished, this, &LogGeometryCache::loadingFinished);
+}
+
+LogGeometryCache::~LogGeometryCache()
+{
+  watcher.disconnect(this);
+  watcher.waitForFinished();
+
+  // Delete results of a batch which was not picked up
+  if(!loadingIds.isEmpty() && watcher.future().resultCount() > 0)
+  {
+    for(const std::pair<int, LogGeometry *>& result : watcher.result())
+      delete result.second;
+  }
+  clear();
+}
+
+const LogGeometry *LogGeometryCache::getGeometry(int id)
+{
+  if(emptyIds.contains(id))
+    return nullptr;
+
+  LogGeometry *geometry = geometryCache.object(id);
+  if(geometry == nullptr && !pendingIds.contains(id))
+  {
+    // Not cached yet - load, decompress and parse attachment in background
+    requestedIds.append(id);
+    pendingIds.insert(id);
+    startLoading();
+  }
+  return geometry;
+}
+
+void LogGeometryCache::invalidate(const QSet<int>& ids)
+{
+  for(int id : ids)
+  {
+    geometryCache.remove(id);
+    emptyIds.remove(id);
+    if(loadingIds.contains(id))
+      invalidatedIds.insert(id);
+  }
+}
+
+void LogGeometryCache::clear()
+{
+  geometryCache.clear();
+  emptyIds.clear();
+  requestedIds.clear();
+  pendingIds.clear();
+
+  // Drop results of the running batch
+  for(int id : qAsConst(loadingIds))
+  {
+    invalidatedIds.insert(id);
+    pendingIds.insert(id);
+  }
+}
+
+void LogGeometryCache::startLoading()
+{
+  if(!loadingIds.isEmpty() || requestedIds.isEmpty())
+    // Already running or nothing to do
+    return;
+
+  loadingIds = requestedIds.mid(0, MAX_IDS_PER_BATCH);
+  requestedIds.remove(0, loadingIds.size());
+
+  watcher.setFuture(QtConcurrent::run(&LogGeometryCache::loadGeometries, manager->getDatabase()->databaseName(), loadingIds));
+}
+
+void LogGeometryCache::loadingFinished()
+{
+  int numUpdated = 0;
+  for(const std::pair<int, LogGeometry *>& result : watcher.result())
+  {
+    int id = result.first;
+    pendingIds.remove(id);
+
+    if(invalidatedIds.contains(id))
+    {
+      // Changed while loading - request again on next paint
+      delete result.second;
+      numUpdated++;
+    }
+    else if(result.second == nullptr)
+      emptyIds.insert(id);
+    else
+    {
+      // Cost is limited to maximum to avoid insert failing and deleting the object for very large trails
+      geometryCache.insert(id, result.second, std::min(result.second->numPoints(), CACHE_MAX_POINTS));
+      numUpdated++;
+    }
+  }
+
+  loadingIds.clear();
+  invalidatedIds.clear();
+
+  // Continue with entries requested in the meantime
+  startLoading();
+
+  if(numUpdated > 0)
+    emit geometryReady();
+}
+
+LogGeometryCache::LogGeometryList LogGeometryCache::loadGeometries(const QString& databaseName, const QVector<int>& ids)
+{
+#ifdef DEBUG_INFORMATION
+  QElapsedTimer timer;
+  timer.start();
+#endif
+
+  LogGeometryList geometries;
+  {
+    QSqlDatabase db = QSqlDatabase::addDatabase(dbtools::DATABASE_TYPE, dbtools::DATABASE_NAME_LOG_GEOMETRY);
+    db.setDatabaseName(databaseName);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+
+    if(db.open())
+    {
+      QSqlQuery query(db);
+      query.prepare("select aircraft_trail from logbook where logbook_id = ?");
+
+      for(int id : ids)
+      {
+        LogGeometry *geometry = nullptr;
+        query.addBindValue(id);
+        if(query.exec() && query.next())
+        {
+          QByteArray bytes = query.value(0).toByteArray();
+          if(!bytes.isEmpty())
+          {
+            atools::fs::gpx::GpxData gpxData;
+            atools::fs::gpx::GpxIO().loadGpxGz(gpxData, bytes);
+            if(!gpxData.flightplan.isEmpty() || !gpxData.trails.isEmpty())
+              geometry = createGeometry(gpxData);
+          }
+        }
+        else if(query.lastError().isValid())
+          qWarning() << Q_FUNC_INFO << "Query failed for" << id << query.lastError().text();
+
+        query.finish();
+        geometries.append(std::make_pair(id, geometry));
+      }
+      db.close();
+    }
+    else
+    {
+      qWarning() << Q_FUNC_INFO << "Cannot open" << databaseName << db.lastError().text();
+
+      // Mark all as empty to avoid loading again
+      for(int id : ids)
+        geometries.append(std::make_pair(id, nullptr));
+    }
+  }
+  QSqlDatabase::removeDatabase(dbtools::DATABASE_NAME_LOG_GEOMETRY);
+
+#ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << "entries" << ids.size() << "time" << timer.elapsed() << "ms";
+#endif
+
+  return geometries;
+}
+
+int LogGeometryCache::levelForPixelPerNm(float pixelPerNm)
+{
+  // Use the most simplified level which does not deviate more than the allowed number of pixels
+  for(int level = LEVEL_TOLERANCE_NM.size() - 1; level > 0; level--)
+  {
+    if(LEVEL_TOLERANCE_NM.at(level) * pixelPerNm <= MAX_DEVIATION_PIXEL)
+      return level;
+  }
+  return 0;
+}
+
+LogGeometry *LogGeometryCache::createGeometry(const atools::fs::gpx::GpxData& gpxData)
+{
+
+  LogGeometry *geometry = new LogGeometry;
+
+  // Flight plan =========================================================
+  for(const atools::fs::pln::FlightplanEntry& entry : gpxData.flightplan)
+  {
+    geometry->route.append(entry.getPosition());
+    geometry->routeIdents.append(entry.getIdent());
+  }
+  geometry->routeRect = gpxData.flightplanRect;
+
+  // Trail =========================================================
+  if(!gpxData.trails.isEmpty())
+  {
+    geometry->trailRect = gpxData.trailRect;
+    geometry->minTrailAltitude = gpxData.minTrailAltitude;
+    geometry->maxTrailAltitude = gpxData.maxTrailAltitude;
+
+    // Convert to line strings once
+    QVector<LineString> lines;
+    for(const atools::fs::gpx::TrailPoints& points : gpxData.trails)
+    {
+      if(!points.isEmpty())
+      {
+        LineString line;
+        for(const atools::fs::gpx::TrailPoint& point : points)
+          line.append(point.pos.asPos());
+        lines.append(line);
+      }
+    }
+
+    // Build all levels from the full resolution trail
+    for(float toleranceNm : LEVEL_TOLERANCE_NM)
+    {
+      QVector<LineString> level;
+      for(const LineString& line : lines)
+        level.append(simplify(line, toleranceNm));
+      geometry->trails.append(level);
+    }
+  }
+
+  return geometry;
+}
+
+LineString LogGeometryCache::simplify(const LineString& line, float toleranceNm)
+{
+  if(line.size() < 3)
+    return line;
+
+  // Project to a plane in nautical miles using an equirectangular projection around the center latitude
+  // Longitude is unwrapped to avoid jumps at the anti-meridian
+  const float cosLat = std::cos(atools::geo::toRadians(line.boundingRect().getCenter().getLatY()));
+  QVector<QPointF> projected;
+  projected.reserve(line.size());
+  float lonOffset = 0.f, lastLon = line.constFirst().getLonX();
+  for(const atools::geo::Pos& pos : line)
+  {
+    float lon = pos.getLonX();
+    if(lon - lastLon > 180.f)
+      lonOffset -= 360.f;
+    else if(lon - lastLon < -180.f)
+      lonOffset += 360.f;
+    lastLon = lon;
+
+    projected.append(QPointF((lon + lonOffset) * 60. * cosLat, pos.getLatY() * 60.));
+  }
+
+  // Douglas-Peucker using a stack instead of recursion ======================
+  QVector<bool> keep(line.size(), false);
+  keep[0] = keep[line.size() - 1] = true;
+
+  QVector<std::pair<int, int> > stack;
+  stack.append(std::make_pair(0, line.size() - 1));
+  const double toleranceSq = static_cast<double>(toleranceNm) * static_cast<double>(toleranceNm);
+
+  while(!stack.isEmpty())
+  {
+    std::pair<int, int> range = stack.takeLast();
+    const QPointF& p1 = projected.at(range.first);
+    const QPointF& p2 = projected.at(range.second);
+    double dx = p2.x() - p1.x(), dy = p2.y() - p1.y();
+    double lengthSq = dx * dx + dy * dy;
+
+    double maxDistSq = -1.;
+    int maxIndex = -1;
+    for(int i = range.first + 1; i < range.second; i++)
+    {
+      const QPointF& p = projected.at(i);
+      double distSq;
+      if(lengthSq > 0.)
+      {
+        // Distance from segment
+        double t = std::max(0., std::min(1., ((p.x() - p1.x()) * dx + (p.y() - p1.y()) * dy) / lengthSq));
+        double px = p1.x() + t * dx - p.x(), py = p1.y() + t * dy - p.y();
+        distSq = px * px + py * py;
+      }
+      else
+        distSq = (p.x() - p1.x()) * (p.x() - p1.x()) + (p.y() - p1.y()) * (p.y() - p1.y());
+
+      if(distSq > maxDistSq)
+      {
+        maxDistSq = distSq;
+        maxIndex = i;
+      }
+    }
+
+    if(maxIndex != -1 && maxDistSq > toleranceSq)
+    {
+      keep[maxIndex] = true;
+      stack.append(std::make_pair(range.first, maxIndex));
+      stack.append(std::make_pair(maxIndex, range.second));
+    }
+  }
+
+  LineString retval;
+  for(int i = 0; i < line.size(); i++)
+  {
+    if(keep.at(i))
+      retval.append(line.at(i));
+  }
+  return retval;
+}
@@ -0,0 +1,155 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_LOGGEOMETRYCACHE_H
+#define LNM_LOGGEOMETRYCACHE_H
+
+#include "geo/linestring.h"
+#include "geo/rect.h"
+
+#include <QCache>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+
+namespace atools {
+namespace fs {
+namespace gpx {
+struct GpxData;
+}
+namespace userdata {
+class LogdataManager;
+}
+}
+}
+
+/* Flight plan and simplified trail geometry of one logbook entry. */
+struct LogGeometry
+{
+  /* Flight plan waypoints and idents */
+  atools::geo::LineString route;
+  QStringList routeIdents;
+  atools::geo::Rect routeRect;
+
+  /* One list of trail line strings per level of detail. Index 0 is the most detailed one. */
+  QVector<QVector<atools::geo::LineString> > trails;
+  atools::geo::Rect trailRect;
+  float minTrailAltitude = 0.f, maxTrailAltitude = 0.f;
+
+  bool hasRoute() const
+  {
+    return !route.isEmpty();
+  }
+
+  bool hasTrail() const
+  {
+    return !trails.isEmpty() && !trails.constFirst().isEmpty();
+  }
+
+  /* Get trail line strings for level. Level is clamped. */
+  const QVector<atools::geo::LineString>& getTrail(int level) const
+  {
+    return trails.at(std::min(std::max(level, 0), trails.size() - 1));
+  }
+
+  /* Number of points in all geometries. Used as cache cost. */
+  int numPoints() const;
+};
+
+/*
+ * Keeps flight plan and trail geometry for logbook entries.
+ *
+ * The attached GPX data is fetched, decompressed and parsed only once per entry in a background thread which uses
+ * its own read-only database connection. Trails are reduced to several levels of detail using the Douglas-Peucker
+ * algorithm. This allows to draw many logbook entries at once without copying all trail points for each frame.
+ *
+ * Entries have to be invalidated if changed or deleted.
+ */
+class LogGeometryCache :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit LogGeometryCache(atools::fs::userdata::LogdataManager *logdataManager, QObject *parent = nullptr);
+  virtual ~LogGeometryCache() override;
+
+  LogGeometryCache(const LogGeometryCache& other) = delete;
+  LogGeometryCache& operator=(const LogGeometryCache& other) = delete;
+
+  /* Get geometry from cache. Returns null if the entry has no attachment or if the geometry is not loaded yet.
+   * Missing geometry is loaded in background and geometryReady() is sent once a batch is available.
+   * Pointer is valid until the next call or until the cache is cleared. */
+  const LogGeometry *getGeometry(int id);
+
+  /* Remove changed or deleted entries. Entries which are currently loaded are discarded. */
+  void invalidate(const QSet<int>& ids);
+
+  /* Clear the cache */
+  void clear();
+
+  /* Get level of detail for the given screen resolution. Result can be passed to LogGeometry::getTrail() */
+  static int levelForPixelPerNm(float pixelPerNm);
+
+signals:
+  /* Geometry for requested entries was loaded. Map has to be redrawn. */
+  void geometryReady();
+
+private:
+  /* Logbook id and geometry or null if nothing is attached */
+  typedef QVector<std::pair<int, LogGeometry *> > LogGeometryList;
+
+  /* Start thread for requested ids if not already running */
+  void startLoading();
+  void loadingFinished();
+
+  /* Thread method. Loads and simplifies geometry for all ids using a separate database connection. */
+  static LogGeometryList loadGeometries(const QString& databaseName, const QVector<int>& ids);
+  static LogGeometry *createGeometry(const atools::fs::gpx::GpxData& gpxData);
+
+  /* Reduce points using the given tolerance and return a new line string */
+  static atools::geo::LineString simplify(const atools::geo::LineString& line, float toleranceNm);
+
+  /* Maximum number of points in all cached entries */
+  static const int CACHE_MAX_POINTS = 2000000;
+
+  /* Maximum number of entries loaded in one batch before the map is updated */
+  static const int MAX_IDS_PER_BATCH = 50;
+
+  atools::fs::userdata::LogdataManager *manager;
+  QCache<int, LogGeometry> geometryCache;
+
+  /* Remember entries without GPX attachment to avoid loading again */
+  QSet<int> emptyIds;
+
+  /* Ids waiting for the next batch in order of request */
+  QVector<int> requestedIds;
+
+  /* Ids in requestedIds and in the running batch to avoid duplicate requests */
+  QSet<int> pendingIds;
+
+  /* Ids of the batch running in the thread. Empty if nothing is running. */
+  QVector<int> loadingIds;
+
+  /* Ids invalidated while loading. Results are dropped for these. */
+  QSet<int> invalidatedIds;
+
+  QFutureWatcher<LogGeometryList> watcher;
+};
+
+#endif // LNM_LOGGEOMETRYCACHE_H
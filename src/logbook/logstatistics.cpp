@@ -0,0 +1,343 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "logbook/logstatistics.h"
+
+#include "sql/sqldatabase.h"
+#include "sql/sqlquery.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QStringBuilder>
+#include <QStringList>
+
+#include <algorithm>
+
+using atools::sql::SqlQuery;
+
+namespace {
+/* All columns needed for aggregation */
+const static QString COLUMNS("logbook_id, departure_time, departure_time_sim, destination_time, destination_time_sim, distance, "
+                             "departure_ident, destination_ident, aircraft_type, aircraft_registration, aircraft_name, simulator");
+
+/* Maximum number of ids for one "in" clause */
+const static int MAX_IDS_PER_QUERY = 500;
+}
+
+LogStatistics::LogStatistics(atools::sql::SqlDatabase *sqlDb)
+  : db(sqlDb)
+{
+}
+
+void LogStatistics::clear()
+{
+  loaded = false;
+  entries.clear();
+
+  departureTimes.clear();
+  departureTimesSim.clear();
+  distances.clear();
+  tripTimes.clear();
+  tripTimesSim.clear();
+  distanceTotal = tripTimeTotal = tripTimeSimTotal = 0.;
+  numDistances = numTripTimes = numTripTimesSim = 0;
+  departureIdents.clear();
+  destinationIdents.clear();
+  aircraftTypes.clear();
+  aircraftRegistrations.clear();
+  aircraftNames.clear();
+  simulators.clear();
+}
+
+void LogStatistics::loadAll()
+{
+  if(loaded)
+    return;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  clear();
+  SqlQuery query(db);
+  query.exec("select " % COLUMNS % " from logbook");
+  readEntries(query);
+  loaded = true;
+
+  qDebug() << Q_FUNC_INFO << "entries" << entries.size() << "time" << timer.elapsed() << "ms";
+}
+
+void LogStatistics::updateEntries(const QSet<int>& ids)
+{
+  if(!loaded || ids.isEmpty())
+    return;
+
+  // Remove old values - entries still present are added again below
+  QStringList idList;
+  for(int id : ids)
+  {
+    removeEntry(id);
+    idList.append(QString::number(id));
+  }
+
+  for(int i = 0; i < idList.size(); i += MAX_IDS_PER_QUERY)
+  {
+    SqlQuery query(db);
+    query.exec("select " % COLUMNS % " from logbook where logbook_id in (" % idList.mid(i, MAX_IDS_PER_QUERY).join(',') % ")");
+    readEntries(query);
+  }
+}
+
+QSet<int> LogStatistics::getIds() const
+{
+  SqlQuery query(db);
+  query.exec("select logbook_id from logbook");
+  return readIds(query);
+}
+
+int LogStatistics::getMaxId() const
+{
+  SqlQuery query(db);
+  query.exec("select max(logbook_id) from logbook");
+  return query.next() ? query.valueInt(0) : 0;
+}
+
+QSet<int> LogStatistics::getIdsAfter(int id) const
+{
+  SqlQuery query(db);
+  query.prepare("select logbook_id from logbook where logbook_id > :id");
+  query.bindValue(":id", id);
+  query.exec();
+  return readIds(query);
+}
+
+QSet<int> LogStatistics::readIds(SqlQuery& query)
+{
+  QSet<int> ids;
+  while(query.next())
+    ids.insert(query.valueInt(0));
+  return ids;
+}
+
+void LogStatistics::readEntries(SqlQuery& query)
+{
+  while(query.next())
+  {
+    Entry entry;
+    entry.departureTime = query.value("departure_time").toDateTime();
+    entry.departureTimeSim = query.value("departure_time_sim").toDateTime();
+    entry.distance = query.valueFloat("distance");
+
+    // Trip times in hours if both times are given - same as in statistics dialog queries
+    QDateTime destinationTime = query.value("destination_time").toDateTime();
+    if(entry.departureTime.isValid() && destinationTime.isValid())
+      entry.tripTime = entry.departureTime.secsTo(destinationTime) / 3600.f;
+
+    QDateTime destinationTimeSim = query.value("destination_time_sim").toDateTime();
+    if(entry.departureTimeSim.isValid() && destinationTimeSim.isValid())
+      entry.tripTimeSim = entry.departureTimeSim.secsTo(destinationTimeSim) / 3600.f;
+
+    entry.departureIdent = query.valueStr("departure_ident");
+    entry.destinationIdent = query.valueStr("destination_ident");
+    entry.aircraftType = query.valueStr("aircraft_type");
+    entry.aircraftRegistration = query.valueStr("aircraft_registration");
+    entry.aircraftName = query.valueStr("aircraft_name");
+    entry.simulator = query.valueStr("simulator");
+
+    int id = query.valueInt("logbook_id");
+    removeEntry(id);
+    addEntry(id, entry);
+  }
+}
+
+void LogStatistics::addEntry(int id, const Entry& entry)
+{
+  entries.insert(id, entry);
+
+  if(entry.departureTime.isValid())
+    addValue(departureTimes, entry.departureTime);
+  if(entry.departureTimeSim.isValid())
+    addValue(departureTimesSim, entry.departureTimeSim);
+
+  if(entry.distance > 0.f)
+  {
+    addValue(distances, entry.distance);
+    distanceTotal += entry.distance;
+    numDistances++;
+  }
+
+  if(entry.tripTime > 0.f)
+  {
+    addValue(tripTimes, entry.tripTime);
+    tripTimeTotal += entry.tripTime;
+    numTripTimes++;
+  }
+
+  if(entry.tripTimeSim > 0.f)
+  {
+    addValue(tripTimesSim, entry.tripTimeSim);
+    tripTimeSimTotal += entry.tripTimeSim;
+    numTripTimesSim++;
+  }
+
+  addValue(departureIdents, entry.departureIdent);
+  addValue(destinationIdents, entry.destinationIdent);
+  addValue(aircraftTypes, entry.aircraftType);
+  addValue(aircraftRegistrations, entry.aircraftRegistration);
+  addValue(aircraftNames, entry.aircraftName);
+
+  // Count empty simulator too to show unknown ones
+  simulators[entry.simulator]++;
+}
+
+void LogStatistics::removeEntry(int id)
+{
+  QHash<int, Entry>::iterator it = entries.find(id);
+  if(it == entries.end())
+    return;
+
+  const Entry& entry = it.value();
+
+  if(entry.departureTime.isValid())
+    removeValue(departureTimes, entry.departureTime);
+  if(entry.departureTimeSim.isValid())
+    removeValue(departureTimesSim, entry.departureTimeSim);
+
+  if(entry.distance > 0.f)
+  {
+    removeValue(distances, entry.distance);
+    distanceTotal -= entry.distance;
+    numDistances--;
+  }
+
+  if(entry.tripTime > 0.f)
+  {
+    removeValue(tripTimes, entry.tripTime);
+    tripTimeTotal -= entry.tripTime;
+    numTripTimes--;
+  }
+
+  if(entry.tripTimeSim > 0.f)
+  {
+    removeValue(tripTimesSim, entry.tripTimeSim);
+    tripTimeSimTotal -= entry.tripTimeSim;
+    numTripTimesSim--;
+  }
+
+  removeValue(departureIdents, entry.departureIdent);
+  removeValue(destinationIdents, entry.destinationIdent);
+  removeValue(aircraftTypes, entry.aircraftType);
+  removeValue(aircraftRegistrations, entry.aircraftRegistration);
+  removeValue(aircraftNames, entry.aircraftName);
+
+  Counter::iterator simIt = simulators.find(entry.simulator);
+  if(simIt != simulators.end() && --simIt.value() <= 0)
+    simulators.erase(simIt);
+
+  entries.erase(it);
+}
+
+template<typename TYPE>
+void LogStatistics::addValue(Multiset<TYPE>& set, const TYPE& value)
+{
+  set[value]++;
+}
+
+template<typename TYPE>
+void LogStatistics::removeValue(Multiset<TYPE>& set, const TYPE& value)
+{
+  typename Multiset<TYPE>::iterator it = set.find(value);
+  if(it != set.end() && --it.value() <= 0)
+    set.erase(it);
+}
+
+void LogStatistics::addValue(Counter& counter, const QString& value)
+{
+  // Ignore null and empty values like count(distinct) in SQL
+  if(!value.isEmpty())
+    counter[value]++;
+}
+
+void LogStatistics::removeValue(Counter& counter, const QString& value)
+{
+  if(!value.isEmpty())
+  {
+    Counter::iterator it = counter.find(value);
+    if(it != counter.end() && --it.value() <= 0)
+      counter.erase(it);
+  }
+}
+
+void LogStatistics::getFlightStatsTime(QDateTime& earliest, QDateTime& latest, QDateTime& earliestSim, QDateTime& latestSim)
+{
+  loadAll();
+  earliest = departureTimes.isEmpty() ? QDateTime() : departureTimes.firstKey();
+  latest = departureTimes.isEmpty() ? QDateTime() : departureTimes.lastKey();
+  earliestSim = departureTimesSim.isEmpty() ? QDateTime() : departureTimesSim.firstKey();
+  latestSim = departureTimesSim.isEmpty() ? QDateTime() : departureTimesSim.lastKey();
+}
+
+void LogStatistics::getFlightStatsDistance(float& distTotal, float& distMax, float& distAverage)
+{
+  loadAll();
+  distTotal = static_cast<float>(distanceTotal);
+  distMax = distances.isEmpty() ? 0.f : distances.lastKey();
+  distAverage = numDistances > 0 ? static_cast<float>(distanceTotal / numDistances) : 0.f;
+}
+
+void LogStatistics::getFlightStatsTripTime(float& timeMaximum, float& timeAverage, float& timeTotal,
+                                           float& timeMaximumSim, float& timeAverageSim, float& timeTotalSim)
+{
+  loadAll();
+  timeTotal = static_cast<float>(tripTimeTotal);
+  timeMaximum = tripTimes.isEmpty() ? 0.f : tripTimes.lastKey();
+  timeAverage = numTripTimes > 0 ? static_cast<float>(tripTimeTotal / numTripTimes) : 0.f;
+
+  timeTotalSim = static_cast<float>(tripTimeSimTotal);
+  timeMaximumSim = tripTimesSim.isEmpty() ? 0.f : tripTimesSim.lastKey();
+  timeAverageSim = numTripTimesSim > 0 ? static_cast<float>(tripTimeSimTotal / numTripTimesSim) : 0.f;
+}
+
+void LogStatistics::getFlightStatsAirports(int& numDepartAirports, int& numDestAirports)
+{
+  loadAll();
+  numDepartAirports = departureIdents.size();
+  numDestAirports = destinationIdents.size();
+}
+
+void LogStatistics::getFlightStatsAircraft(int& numTypes, int& numRegistrations, int& numNames, int& numSimulators)
+{
+  loadAll();
+  numTypes = aircraftTypes.size();
+  numRegistrations = aircraftRegistrations.size();
+  numNames = aircraftNames.size();
+
+  // Ignore unknown simulator
+  numSimulators = simulators.size() - (simulators.contains(QString()) ? 1 : 0);
+}
+
+void LogStatistics::getFlightStatsSimulator(QVector<std::pair<int, QString> >& numSimulators)
+{
+  loadAll();
+  numSimulators.clear();
+  for(auto it = simulators.constBegin(); it != simulators.constEnd(); ++it)
+    numSimulators.append(std::make_pair(it.value(), it.key()));
+
+  std::sort(numSimulators.begin(), numSimulators.end(),
+            [](const std::pair<int, QString>& p1, const std::pair<int, QString>& p2) -> bool {
+    return p1.first > p2.first || (p1.first == p2.first && p1.second < p2.second);
+  });
+}
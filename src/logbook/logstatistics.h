@@ -0,0 +1,123 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_LOGSTATISTICS_H
+#define LNM_LOGSTATISTICS_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+
+namespace atools {
+namespace sql {
+class SqlDatabase;
+class SqlQuery;
+}
+}
+
+/*
+ * Aggregated logbook values for the statistics dialog and the LogdataController statistics getters.
+ *
+ * Keeps the values needed for the aggregates per logbook entry in memory. Totals, counts and ordered multisets for
+ * minimum and maximum values are updated when entries are added, changed or removed. This avoids scanning the whole
+ * logbook table with several aggregate queries each time the statistics are shown or the logbook is modified.
+ *
+ * Loaded with one table scan on first access.
+ */
+class LogStatistics
+{
+public:
+  explicit LogStatistics(atools::sql::SqlDatabase *sqlDb);
+
+  /* Read all entries on next access */
+  void clear();
+
+  /* Read changed, inserted or deleted entries again. Ids not found in the table are removed.
+   * Does nothing if not loaded yet. */
+  void updateEntries(const QSet<int>& ids);
+
+  /* Ids of all logbook entries in the table. Used to find entries deleted by cleanup. */
+  QSet<int> getIds() const;
+
+  /* Largest id in the table or 0 if empty. Used to find entries added by imports. */
+  int getMaxId() const;
+
+  /* Ids of entries having an id larger than the given one */
+  QSet<int> getIdsAfter(int id) const;
+
+  /* Values as used by LogdataController::getFlightStats* =============================== */
+  void getFlightStatsTime(QDateTime& earliest, QDateTime& latest, QDateTime& earliestSim, QDateTime& latestSim);
+  void getFlightStatsDistance(float& distTotal, float& distMax, float& distAverage);
+  void getFlightStatsTripTime(float& timeMaximum, float& timeAverage, float& timeTotal,
+                              float& timeMaximumSim, float& timeAverageSim, float& timeTotalSim);
+  void getFlightStatsAirports(int& numDepartAirports, int& numDestAirports);
+  void getFlightStatsAircraft(int& numTypes, int& numRegistrations, int& numNames, int& numSimulators);
+
+  /* Number of flights per simulator sorted by number descending */
+  void getFlightStatsSimulator(QVector<std::pair<int, QString> >& numSimulators);
+
+private:
+  /* Values of one logbook entry used for aggregation. Times are in hours and negative if not valid. */
+  struct Entry
+  {
+    QDateTime departureTime, departureTimeSim;
+    float distance = 0.f, tripTime = -1.f, tripTimeSim = -1.f;
+    QString departureIdent, destinationIdent, aircraftType, aircraftRegistration, aircraftName, simulator;
+  };
+
+  /* Counts number of occurrences of each value to allow removal */
+  template<typename TYPE>
+  using Multiset = QMap<TYPE, int>;
+  using Counter = QHash<QString, int>;
+
+  /* Load all if not done yet */
+  void loadAll();
+
+  /* Read entries from query and replace existing ones */
+  void readEntries(atools::sql::SqlQuery& query);
+
+  /* Read ids from first column of query */
+  static QSet<int> readIds(atools::sql::SqlQuery& query);
+
+  void addEntry(int id, const Entry& entry);
+  void removeEntry(int id);
+
+  template<typename TYPE>
+  static void addValue(Multiset<TYPE>& set, const TYPE& value);
+
+  template<typename TYPE>
+  static void removeValue(Multiset<TYPE>& set, const TYPE& value);
+
+  static void addValue(Counter& counter, const QString& value);
+  static void removeValue(Counter& counter, const QString& value);
+
+  atools::sql::SqlDatabase *db;
+  bool loaded = false;
+
+  QHash<int, Entry> entries;
+
+  /* Aggregates =============================== */
+  Multiset<QDateTime> departureTimes, departureTimesSim;
+  Multiset<float> distances, tripTimes, tripTimesSim;
+  double distanceTotal = 0., tripTimeTotal = 0., tripTimeSimTotal = 0.;
+  int numDistances = 0, numTripTimes = 0, numTripTimesSim = 0;
+  Counter departureIdents, destinationIdents, aircraftTypes, aircraftRegistrations, aircraftNames, simulators;
+};
+
+#endif // LNM_LOGSTATISTICS_H
@@ -29,14 +29,23 @@
 #include "gui/widgetstate.h"
 #include "logdatacontroller.h"
 #include "app/navapp.h"
+#include "db/dbtools.h"
+#include "exception.h"
 #include "sql/sqldatabase.h"
 #include "util/htmlbuilder.h"
 
+#include <QAbstractTableModel>
 #include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
 #include <QPushButton>
 #include <QMimeData>
 #include <QClipboard>
+#include <QElapsedTimer>
 #include <QStringBuilder>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
 
 // ============================================================================================
 
@@ -87,13 +96,13 @@ void LogStatsDelegate::paint(QPainter *painter, const QStyleOptionViewItem& opti
 
 // ============================================================================================
 
-/* Overrides data method for local sensitive number formatting and sorting by SQL query */
-class LogStatsSqlModel :
-  public QSqlQueryModel
+/* Keeps rows of the grouped table as loaded in background. Does locale sensitive number formatting and sorting. */
+class LogStatsModel :
+  public QAbstractTableModel
 {
 public:
-  LogStatsSqlModel(QObject *parent, const QSqlDatabase *db)
-    : QSqlQueryModel(parent), database(db)
+  explicit LogStatsModel(QObject *parent)
+    : QAbstractTableModel(parent)
   {
 
   }
@@ -103,9 +112,12 @@ public:
     if(queryParam != query)
     {
       // Update all to defaults if different
+      beginResetModel();
       query = queryParam;
       sortColumn = query->defaultSortColumn;
       sortOrder = query->defaultSortCrder;
+      rows.clear();
+      endResetModel();
     }
 
     // Calculate the conversion factor for distances which will be set into the SQL query
@@ -124,47 +136,108 @@ public:
         nmToUnitFactor = atools::geo::nmToMi(1.f);
         break;
     }
+  }
+
+  /* Build query with unit placeholders and conversion factor. Sorting is done in the model. */
+  QString buildQuery() const
+  {
+    QString str = query->query;
+    if(str.contains("%1"))
+      str = str.arg(nmToUnitFactor);
+    return str;
+  }
 
-    setQuery(buildQuery(), *database);
+  /* Set rows loaded for buildQuery() and sort them */
+  void setRows(const QVector<QVector<QVariant> >& rowsParam)
+  {
+    beginResetModel();
+    rows = rowsParam;
+    sortRows();
+    endResetModel();
+  }
+
+  virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override
+  {
+    return parent.isValid() ? 0 : rows.size();
+  }
+
+  virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override
+  {
+    return parent.isValid() || query == nullptr ? 0 : query->cols.size();
   }
 
 private:
   virtual QVariant data(const QModelIndex& index, int role) const override;
+  virtual QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
   virtual void sort(int column, Qt::SortOrder order) override
   {
     if(query != nullptr)
     {
-      // Reset with new non default sort order and update query
+      // Sort loaded rows with new order
+      emit layoutAboutToBeChanged();
       sortColumn = column;
       sortOrder = order;
-      setQuery(buildQuery(), *database);
+      sortRows();
+      emit layoutChanged();
     }
   }
 
-  QString buildQuery()
-  {
-    // Build query with current ordering, unit placeholders and conversion factor
-    QString str = query->query;
-    if(str.contains("%1"))
-      str = str.arg(nmToUnitFactor);
-    return str % " order by " % query->cols.at(sortColumn) % (sortOrder == Qt::DescendingOrder ? " desc" : " asc");
-  }
+  void sortRows();
 
   QLocale locale;
   float nmToUnitFactor = 1.f;
-  const QSqlDatabase *database = nullptr;
   const Query *query = nullptr;
   int sortColumn = 0;
   Qt::SortOrder sortOrder = Qt::DescendingOrder;
+  QVector<QVector<QVariant> > rows;
 };
 
-QVariant LogStatsSqlModel::data(const QModelIndex& index, int role) const
+void LogStatsModel::sortRows()
+{
+  if(sortColumn < 0 || query == nullptr || sortColumn >= query->cols.size())
+    return;
+
+  // Same order as SQL "order by" - null values first, then numbers or text
+  int col = sortColumn;
+  auto lessThan = [col](const QVector<QVariant>& row1, const QVector<QVariant>& row2) -> bool {
+    const QVariant& v1 = row1.at(col), & v2 = row2.at(col);
+    if(v1.isNull() || v2.isNull())
+      return v1.isNull() && !v2.isNull();
+
+    bool ok1, ok2;
+    double d1 = v1.toDouble(&ok1), d2 = v2.toDouble(&ok2);
+    if(ok1 && ok2 && v1.type() != QVariant::String && v2.type() != QVariant::String)
+      return d1 < d2;
+
+    return v1.toString() < v2.toString();
+  };
+
+  if(sortOrder == Qt::AscendingOrder)
+    std::stable_sort(rows.begin(), rows.end(), lessThan);
+  else
+    std::stable_sort(rows.begin(), rows.end(), [&lessThan](const QVector<QVariant>& row1, const QVector<QVariant>& row2) -> bool {
+      return lessThan(row2, row1);
+    });
+}
+
+QVariant LogStatsModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
+  if(role == Qt::DisplayRole && orientation == Qt::Horizontal && query != nullptr && section < query->header.size())
+    return Unit::replacePlaceholders(query->header.at(section));
+
+  return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant LogStatsModel::data(const QModelIndex& index, int role) const
+{
+  if(!index.isValid() || index.row() >= rows.size() || index.column() >= rows.at(index.row()).size())
+    return QVariant();
+
+  const QVariant& dataValue = rows.at(index.row()).at(index.column());
   if(role == Qt::DisplayRole)
   {
     // Apply locale formatting for numeric values
-    QVariant dataValue = QSqlQueryModel::data(index, Qt::DisplayRole);
     QVariant::Type type = dataValue.type();
 
     if(type == QVariant::Int)
@@ -179,9 +252,13 @@ QVariant LogStatsSqlModel::data(const QModelIndex& index, int role) const
       return locale.toString(dataValue.toDouble(), 'f', 1);
     else if(type == QVariant::DateTime)
       return locale.toString(dataValue.toDateTime());
+    else
+      return dataValue;
   }
+  else if(role == Qt::EditRole)
+    return dataValue;
 
-  return QSqlQueryModel::data(index, role);
+  return QVariant();
 }
 
 // ============================================================================================
@@ -219,12 +296,16 @@ LogStatisticsDialog::LogStatisticsDialog(QWidget *parent, LogdataController *log
 
   connect(ui->comboBoxLogStatsGrouped, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &LogStatisticsDialog::groupChanged);
   connect(ui->buttonBoxLogStats, &QDialogButtonBox::clicked, this, &LogStatisticsDialog::buttonBoxClicked);
+  connect(&watcher, &QFutureWatcher<LogStatsResult>::finished, this, &LogStatisticsDialog::updateFinished);
 
   restoreState();
 }
 
 LogStatisticsDialog::~LogStatisticsDialog()
 {
+  watcher.disconnect(this);
+  watcher.waitForFinished();
+
   ui->tableViewLogStatsGrouped->setItemDelegate(nullptr);
   delete delegate;
 
@@ -237,18 +318,17 @@ LogStatisticsDialog::~LogStatisticsDialog()
 
 void LogStatisticsDialog::updateWidgets()
 {
-  groupChanged(ui->comboBoxLogStatsGrouped->currentIndex());
+  // Overview from aggregates kept in memory
   updateStatisticsText();
+
+  // Sets query into model and starts loading
+  groupChanged(ui->comboBoxLogStatsGrouped->currentIndex());
 }
 
 void LogStatisticsDialog::logDataChanged()
 {
   if(isVisible())
-  {
-    setModel();
     updateWidgets();
-    updateStatisticsText();
-  }
 }
 
 void LogStatisticsDialog::optionsChanged()
@@ -292,10 +372,6 @@ void LogStatisticsDialog::buttonBoxClicked(QAbstractButton *button)
     }
     else
     {
-      // Need to load whole table
-      while(model->canFetchMore())
-        model->fetchMore(QModelIndex());
-
       // Copy CSV from table to clipboard
       QString csv;
       int exported = CsvExporter::tableAsCsv(ui->tableViewLogStatsGrouped, true /* header */, csv);
@@ -322,7 +398,7 @@ void LogStatisticsDialog::setModel()
 {
   clearModel();
 
-  model = new LogStatsSqlModel(this, &logdataController->getDatabase()->getQSqlDatabase());
+  model = new LogStatsModel(this);
 
   QItemSelectionModel *selectionModel = ui->tableViewLogStatsGrouped->selectionModel();
   ui->tableViewLogStatsGrouped->setModel(model);
@@ -356,17 +432,98 @@ void LogStatisticsDialog::groupChanged(int index)
   model->setLogStatQuery(&query);
   ui->tableViewLogStatsGrouped->sortByColumn(query.defaultSortColumn, query.defaultSortCrder);
 
-  if(model->lastError().type() != QSqlError::NoError)
-    qWarning() << Q_FUNC_INFO << "Error executing" << query.query << model->lastError().text();
-
-  // Set headers
-  for(int i = 0; i < query.header.size(); i++)
-    model->setHeaderData(i, Qt::Horizontal, Unit::replacePlaceholders(query.header.at(i)));
-
   // Copy alignment data to delegate
   delegate->align = query.align;
 
-  ui->tableViewLogStatsGrouped->resizeColumnsToContents();
+  startUpdate();
+}
+
+void LogStatisticsDialog::startUpdate()
+{
+  if(model == nullptr)
+    return;
+
+  if(watcher.isRunning())
+    // Load again once the current run is finished
+    updatePending = true;
+  else
+  {
+    updatePending = false;
+    watcher.setFuture(QtConcurrent::run(&LogStatisticsDialog::loadStatistics,
+                                        logdataController->getDatabase()->databaseName(), model->buildQuery()));
+  }
+}
+
+void LogStatisticsDialog::updateFinished()
+{
+  if(updatePending)
+  {
+    // Result is outdated
+    startUpdate();
+    return;
+  }
+
+  const LogStatsResult result = watcher.result();
+
+  // Ignore rows if grouping or units were changed while loading
+  if(model != nullptr && model->buildQuery() == result.query)
+  {
+    model->setRows(result.rows);
+    ui->tableViewLogStatsGrouped->resizeColumnsToContents();
+  }
+}
+
+LogStatsResult LogStatisticsDialog::loadStatistics(const QString& databaseName, const QString& queryStr)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  LogStatsResult result;
+  result.query = queryStr;
+
+  atools::sql::SqlDatabase::addDatabase(dbtools::DATABASE_TYPE, dbtools::DATABASE_NAME_LOG_STATS);
+  {
+    atools::sql::SqlDatabase db(dbtools::DATABASE_NAME_LOG_STATS);
+    try
+    {
+      db.setDatabaseName(databaseName);
+      db.setReadonly();
+      db.open();
+
+      // Grouped table ==========================================
+      QSqlQuery query(db.getQSqlDatabase());
+      query.setForwardOnly(true);
+      if(query.exec(queryStr))
+      {
+        int numCols = query.record().count();
+        while(query.next())
+        {
+          QVector<QVariant> row;
+          row.reserve(numCols);
+          for(int i = 0; i < numCols; i++)
+            row.append(query.value(i));
+          result.rows.append(row);
+        }
+      }
+      else
+        qWarning() << Q_FUNC_INFO << "Error executing" << queryStr << query.lastError().text();
+      query.finish();
+
+      db.close();
+    }
+    catch(atools::Exception& e)
+    {
+      qWarning() << Q_FUNC_INFO << "Error loading statistics from" << databaseName << e.what();
+    }
+    catch(...)
+    {
+      qWarning() << Q_FUNC_INFO << "Unknown error loading statistics from" << databaseName;
+    }
+  }
+  atools::sql::SqlDatabase::removeDatabase(dbtools::DATABASE_NAME_LOG_STATS);
+
+  qDebug() << Q_FUNC_INFO << "rows" << result.rows.size() << "time" << timer.elapsed() << "ms";
+  return result;
 }
 
 void LogStatisticsDialog::updateStatisticsText()
@@ -571,8 +728,8 @@ void LogStatisticsDialog::showEvent(QShowEvent *)
   if(!position.isNull())
     move(position);
 
+  // Sets query and starts loading
   setModel();
-  updateWidgets();
 }
 
 void LogStatisticsDialog::hideEvent(QHideEvent *)
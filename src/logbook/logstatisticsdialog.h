@@ -19,11 +19,11 @@
 #define LNM_LOGSTATISTICSDIALOG_H
 
 #include <QDialog>
-#include <QSqlQueryModel>
+#include <QFutureWatcher>
 #include <QStyledItemDelegate>
 
 class LogdataController;
-class LogStatsSqlModel;
+class LogStatsModel;
 class LogStatsDelegate;
 class QAbstractButton;
 
@@ -40,9 +40,16 @@ namespace Ui {
 class LogStatisticsDialog;
 }
 
-class LogStatsSqlModel;
 class Query;
 
+/* Grouped table rows as loaded in the background thread */
+struct LogStatsResult
+{
+  /* Query used to load rows */
+  QString query;
+  QVector<QVector<QVariant> > rows;
+};
+
 /*
  * Shows logbook statistics in a text browser as well as for various queries in a table
  */
@@ -81,9 +88,16 @@ private:
   /* Update tables and text browser */
   void updateWidgets();
 
-  /* Update text browser */
+  /* Update text browser from aggregates in LogdataController */
   void updateStatisticsText();
 
+  /* Start loading grouped table in background. Loads again after finishing if already running. */
+  void startUpdate();
+  void updateFinished();
+
+  /* Runs in background thread using an own read-only connection to the logbook database */
+  static LogStatsResult loadStatistics(const QString& databaseName, const QString& queryStr);
+
   /* Query has changed in combo box */
   void groupChanged(int index);
 
@@ -104,8 +118,13 @@ private:
   /* Used to remove margins in table */
   atools::gui::ItemViewZoomHandler *zoomHandler;
 
-  /* using own SQL query model to override data method */
-  LogStatsSqlModel *model = nullptr;
+  /* Table model keeping rows loaded in background */
+  LogStatsModel *model = nullptr;
+
+  QFutureWatcher<LogStatsResult> watcher;
+
+  /* Data changed while loading */
+  bool updatePending = false;
 
   /* Item delegate needed to change alignment */
   LogStatsDelegate *delegate = nullptr;
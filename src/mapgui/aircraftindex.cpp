@@ -0,0 +1,260 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/aircraftindex.h"
+
+#include "fs/sc/simconnectaircraft.h"
+#include "geo/calculations.h"
+#include "geo/rect.h"
+
+#include <algorithm>
+#include <cmath>
+
+using atools::fs::sc::SimConnectAircraft;
+using atools::geo::Pos;
+using atools::geo::Rect;
+
+bool AircraftIndex::cellKey(quint32& key, const Pos& pos)
+{
+  if(!pos.isValid())
+    return false;
+
+  int x = static_cast<int>(std::floor((pos.getLonX() + 180.f) / CELL_SIZE_DEG));
+  int y = static_cast<int>(std::floor((pos.getLatY() + 90.f) / CELL_SIZE_DEG));
+  key = cellKey(std::max(0, std::min(x, CELLS_X - 1)), std::max(0, std::min(y, CELLS_Y - 1)));
+  return true;
+}
+
+void AircraftIndex::update(const QVector<SimConnectAircraft>& aircraft, qint64 timestampMs)
+{
+  QHash<int, int> oldObjectIndexes;
+  oldObjectIndexes.swap(objectIndexes);
+  unindexed.clear();
+
+  for(int i = 0; i < aircraft.size(); i++)
+  {
+    const SimConnectAircraft& ac = aircraft.at(i);
+    int objectId = static_cast<int>(ac.getObjectId());
+
+    quint32 key;
+    if(!cellKey(key, ac.getPosition()) || objectIndexes.contains(objectId))
+    {
+      // No position or duplicate id - check always
+      unindexed.append(i);
+      continue;
+    }
+
+    objectIndexes.insert(objectId, i);
+    updateMotion(ac, objectId, timestampMs);
+
+    QHash<int, quint32>::iterator it = objectCells.find(objectId);
+    if(it != objectCells.end())
+    {
+      if(it.value() == key)
+        // Still in same cell - nothing to do
+        continue;
+
+      // Moved to another cell
+      removeFromCell(it.value(), objectId);
+      it.value() = key;
+    }
+    else
+      objectCells.insert(objectId, key);
+
+    cells[key].append(objectId);
+  }
+
+  // Remove all aircraft which are not in the list anymore ======================
+  for(auto it = oldObjectIndexes.constBegin(); it != oldObjectIndexes.constEnd(); ++it)
+  {
+    if(!objectIndexes.contains(it.key()))
+    {
+      removeFromCell(objectCells.value(it.key()), it.key());
+      objectCells.remove(it.key());
+      motions.remove(it.key());
+    }
+  }
+
+  numMoving = 0;
+  for(const Motion& motion : qAsConst(motions))
+  {
+    if(motion.lonXPerMs != 0.f || motion.latYPerMs != 0.f)
+      numMoving++;
+  }
+}
+
+float AircraftIndex::lonXDiff(const Pos& from, const Pos& to)
+{
+  // Shortest difference across the anti-meridian
+  float diff = to.getLonX() - from.getLonX();
+  if(diff > 180.f)
+    diff -= 360.f;
+  else if(diff < -180.f)
+    diff += 360.f;
+  return diff;
+}
+
+void AircraftIndex::updateMotion(const SimConnectAircraft& aircraft, int objectId, qint64 timestampMs)
+{
+  const Pos& pos = aircraft.getPosition();
+  QHash<int, Motion>::iterator it = motions.find(objectId);
+
+  if(it != motions.end() && it.value().pos.getLonX() == pos.getLonX() && it.value().pos.getLatY() == pos.getLatY())
+  {
+    // Position not updated in this packet - keep last movement and timestamp to continue extrapolation
+    // Stop if no new position arrived for too long to avoid showing stopped aircraft ahead of their position
+    Motion& motion = it.value();
+    if(timestampMs - motion.timestampMs > std::min(motion.intervalMs * 2, MAX_EXTRAPOLATION_MS))
+    {
+      motion.timestampMs = timestampMs;
+      motion.lonXPerMs = motion.latYPerMs = 0.f;
+    }
+    return;
+  }
+
+  Motion motion = {pos, timestampMs, MAX_EXTRAPOLATION_MS / 2, 0.f, 0.f};
+  qint64 intervalMs = it != motions.end() ? timestampMs - it.value().timestampMs : 0;
+
+  if(intervalMs > 0 && intervalMs <= MAX_PACKET_INTERVAL_MS)
+  {
+    // Use movement between last and this packet ===========================
+    motion.intervalMs = intervalMs;
+    motion.lonXPerMs = lonXDiff(it.value().pos, pos) / intervalMs;
+    motion.latYPerMs = (pos.getLatY() - it.value().pos.getLatY()) / intervalMs;
+  }
+  else if(aircraft.getGroundSpeedKts() > 1.f && aircraft.getGroundSpeedKts() < atools::fs::sc::SC_INVALID_FLOAT &&
+          aircraft.getHeadingDegTrue() < atools::fs::sc::SC_INVALID_FLOAT && std::abs(pos.getLatY()) < 85.f)
+  {
+    // First packet - use speed and heading for movement of one second ===========================
+    Pos next = pos.endpoint(atools::geo::nmToMeter(aircraft.getGroundSpeedKts()) / 3600.f, aircraft.getHeadingDegTrue());
+    motion.lonXPerMs = lonXDiff(pos, next) / 1000.f;
+    motion.latYPerMs = (next.getLatY() - pos.getLatY()) / 1000.f;
+  }
+
+  if(it != motions.end())
+    it.value() = motion;
+  else
+    motions.insert(objectId, motion);
+}
+
+Pos AircraftIndex::getInterpolatedPos(const SimConnectAircraft& aircraft, qint64 timestampMs) const
+{
+  const Pos& pos = aircraft.getPosition();
+  QHash<int, Motion>::const_iterator it = motions.constFind(static_cast<int>(aircraft.getObjectId()));
+
+  // Ignore aircraft not from the last update like online aircraft having the same id
+  if(it == motions.constEnd() || it.value().pos.getLonX() != pos.getLonX() || it.value().pos.getLatY() != pos.getLatY())
+    return pos;
+
+  const Motion& motion = it.value();
+  if(motion.lonXPerMs == 0.f && motion.latYPerMs == 0.f)
+    return pos;
+
+  qint64 elapsedMs = std::min(std::min(timestampMs - motion.timestampMs, motion.intervalMs * 2), MAX_EXTRAPOLATION_MS);
+  if(elapsedMs <= 0)
+    return pos;
+
+  float lonX = pos.getLonX() + motion.lonXPerMs * elapsedMs;
+  if(lonX > 180.f)
+    lonX -= 360.f;
+  else if(lonX < -180.f)
+    lonX += 360.f;
+
+  return Pos(lonX, std::max(-90.f, std::min(90.f, pos.getLatY() + motion.latYPerMs * elapsedMs)), pos.getAltitude());
+}
+
+void AircraftIndex::removeFromCell(quint32 key, int objectId)
+{
+  QHash<quint32, QVector<int> >::iterator it = cells.find(key);
+  if(it != cells.end())
+  {
+    it.value().removeOne(objectId);
+    if(it.value().isEmpty())
+      cells.erase(it);
+  }
+}
+
+void AircraftIndex::clear()
+{
+  cells.clear();
+  objectCells.clear();
+  objectIndexes.clear();
+  unindexed.clear();
+  motions.clear();
+  numMoving = 0;
+}
+
+void AircraftIndex::getIndexes(QVector<int>& indexes, const Rect& rect) const
+{
+  indexes = unindexed;
+
+  if(!rect.isValid())
+  {
+    // Return all
+    for(int index : objectIndexes)
+      indexes.append(index);
+  }
+  else if(rect.crossesAntiMeridian())
+  {
+    for(const Rect& r : rect.splitAtAntiMeridian())
+      getIndexesForRect(indexes, r);
+  }
+  else
+    getIndexesForRect(indexes, rect);
+
+  // Keep list order to have the same drawing order as the simulator list
+  std::sort(indexes.begin(), indexes.end());
+  indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+}
+
+void AircraftIndex::getIndexesForRect(QVector<int>& indexes, const Rect& rect) const
+{
+  // Add a neighbor cell on each side to catch aircraft symbols overlapping the border
+  int x1 = std::max(0, static_cast<int>(std::floor((rect.getWest() + 180.f) / CELL_SIZE_DEG)) - 1);
+  int x2 = std::min(CELLS_X - 1, static_cast<int>(std::floor((rect.getEast() + 180.f) / CELL_SIZE_DEG)) + 1);
+  int y1 = std::max(0, static_cast<int>(std::floor((rect.getSouth() + 90.f) / CELL_SIZE_DEG)) - 1);
+  int y2 = std::min(CELLS_Y - 1, static_cast<int>(std::floor((rect.getNorth() + 90.f) / CELL_SIZE_DEG)) + 1);
+
+  if((x2 - x1 + 1) * (y2 - y1 + 1) > cells.size())
+  {
+    // Less occupied cells than cells covered by rectangle - iterate over occupied ones
+    for(auto it = cells.constBegin(); it != cells.constEnd(); ++it)
+    {
+      int x = static_cast<int>(it.key() >> 16), y = static_cast<int>(it.key() & 0xffff);
+      if(x >= x1 && x <= x2 && y >= y1 && y <= y2)
+      {
+        for(int objectId : it.value())
+          indexes.append(objectIndexes.value(objectId));
+      }
+    }
+  }
+  else
+  {
+    for(int x = x1; x <= x2; x++)
+    {
+      for(int y = y1; y <= y2; y++)
+      {
+        QHash<quint32, QVector<int> >::const_iterator it = cells.constFind(cellKey(x, y));
+        if(it != cells.constEnd())
+        {
+          for(int objectId : it.value())
+            indexes.append(objectIndexes.value(objectId));
+        }
+      }
+    }
+  }
+}
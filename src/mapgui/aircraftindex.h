@@ -0,0 +1,127 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_AIRCRAFTINDEX_H
+#define LITTLENAVMAP_AIRCRAFTINDEX_H
+
+#include "geo/pos.h"
+
+#include <QHash>
+#include <QVector>
+
+namespace atools {
+namespace geo {
+class Rect;
+}
+namespace fs {
+namespace sc {
+class SimConnectAircraft;
+}
+}
+}
+
+/*
+ * Geographic grid index for AI, multiplayer and online shadow aircraft and ships received from the simulator.
+ *
+ * Updated with each simulator data packet. Only aircraft which moved to another cell or appeared or disappeared
+ * are changed in the grid. Used for culling in the aircraft painters and for hit testing in the screen index
+ * to avoid checking all aircraft of a busy multiplayer session.
+ *
+ * Returns indexes into the aircraft list of the last update.
+ *
+ * Also keeps the movement between the last two packets per aircraft to allow extrapolating positions for
+ * smooth movement between simulator updates.
+ */
+class AircraftIndex
+{
+public:
+  /* Update grid and movement from the AI list of a new data packet. timestampMs is the time of reception. */
+  void update(const QVector<atools::fs::sc::SimConnectAircraft>& aircraft, qint64 timestampMs);
+
+  void clear();
+
+  /* Get indexes of all aircraft in the cells touching rect or a neighbor cell. Result might contain aircraft outside
+   * rect. Rectangles crossing the anti-meridian are allowed. Result is sorted ascending. */
+  void getIndexes(QVector<int>& indexes, const atools::geo::Rect& rect) const;
+
+  int size() const
+  {
+    return objectIndexes.size() + unindexed.size();
+  }
+
+  /* Position extrapolated from the last packet to timestampMs. Uses the movement between the last two packets or
+   * ground speed and heading if only one packet was received. Extrapolation time is limited to avoid aircraft
+   * running away if updates stop. Returns the packet position if aircraft is not moving or not known. */
+  atools::geo::Pos getInterpolatedPos(const atools::fs::sc::SimConnectAircraft& aircraft, qint64 timestampMs) const;
+
+  /* true if any aircraft is moving and has an interpolated position which differs from the packet position */
+  bool hasMovingAircraft() const
+  {
+    return numMoving > 0;
+  }
+
+private:
+  /* Cell size in degrees */
+  static constexpr int CELL_SIZE_DEG = 2;
+
+  /* Ignore movement between packets if interval is longer. Use speed and heading instead. */
+  static constexpr qint64 MAX_PACKET_INTERVAL_MS = 5000;
+
+  /* Limit extrapolation to this time or twice the packet interval */
+  static constexpr qint64 MAX_EXTRAPOLATION_MS = 3000;
+
+  /* Number of cells in x and y direction */
+  static constexpr int CELLS_X = 360 / CELL_SIZE_DEG, CELLS_Y = 180 / CELL_SIZE_DEG;
+
+  /* Get cell key for position. Returns false if position is invalid. */
+  static bool cellKey(quint32& key, const atools::geo::Pos& pos);
+  static quint32 cellKey(int x, int y)
+  {
+    return static_cast<quint32>(x) << 16 | static_cast<quint32>(y);
+  }
+
+  /* Movement of an aircraft in degrees per millisecond from the last packet */
+  struct Motion
+  {
+    atools::geo::Pos pos;
+    qint64 timestampMs, intervalMs;
+    float lonXPerMs, latYPerMs;
+  };
+
+  /* Longitude difference in degrees from -180 to 180 */
+  static float lonXDiff(const atools::geo::Pos& from, const atools::geo::Pos& to);
+
+  void removeFromCell(quint32 key, int objectId);
+  void updateMotion(const atools::fs::sc::SimConnectAircraft& aircraft, int objectId, qint64 timestampMs);
+  void getIndexesForRect(QVector<int>& indexes, const atools::geo::Rect& rect) const;
+
+  /* Object ids per cell */
+  QHash<quint32, QVector<int> > cells;
+
+  /* Cell key and current list index by object id */
+  QHash<int, quint32> objectCells;
+  QHash<int, int> objectIndexes;
+
+  /* Movement by object id */
+  QHash<int, Motion> motions;
+  int numMoving = 0;
+
+  /* List indexes of aircraft having no valid position or a duplicate object id. Always returned. */
+  QVector<int> unindexed;
+};
+
+#endif // LITTLENAVMAP_AIRCRAFTINDEX_H
@@ -548,9 +548,11 @@ void MapPaintWidget::postDatabaseLoad()
 QString MapPaintWidget::createAvitabJson()
 {
   CoordinateConverter conv(viewport());
-  Pos topLeft = conv.sToW(rect().topLeft());
-  Pos bottomRight = conv.sToW(rect().bottomRight());
+  return createAvitabJson(conv.sToW(rect().topLeft()), conv.sToW(rect().bottomRight()));
+}
 
+QString MapPaintWidget::createAvitabJson(const atools::geo::Pos& topLeft, const atools::geo::Pos& bottomRight)
+{
   if(topLeft.isValid() && bottomRight.isValid())
   {
     QJsonObject calibration;
@@ -1249,6 +1251,16 @@ const QVector<atools::fs::sc::SimConnectAircraft>& MapPaintWidget::getAiAircraft
   return screenIndex->getAiAircraft();
 }
 
+QVector<const atools::fs::sc::SimConnectAircraft *> MapPaintWidget::getAiAircraft(const atools::geo::Rect& rect) const
+{
+  return screenIndex->getAiAircraft(rect);
+}
+
+atools::geo::Pos MapPaintWidget::getAiAircraftPos(const atools::fs::sc::SimConnectAircraft& aircraft, qint64 timestampMs) const
+{
+  return screenIndex->getAiAircraftPos(aircraft, timestampMs);
+}
+
 void MapPaintWidget::resizeEvent(QResizeEvent *event)
 {
   if(verbose)
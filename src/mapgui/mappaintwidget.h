@@ -48,6 +48,7 @@ class SimConnectAircraft;
 }
 
 namespace geo {
+class Pos;
 class Rect;
 }
 namespace fs {
@@ -239,6 +240,12 @@ public:
   /* AI aircraft as shown on the map */
   const QVector<atools::fs::sc::SimConnectAircraft>& getAiAircraft() const;
 
+  /* AI aircraft in or near rect using the spatial index in the screen index */
+  QVector<const atools::fs::sc::SimConnectAircraft *> getAiAircraft(const atools::geo::Rect& rect) const;
+
+  /* AI aircraft position interpolated between simulator packets for drawing */
+  atools::geo::Pos getAiAircraftPos(const atools::fs::sc::SimConnectAircraft& aircraft, qint64 timestampMs) const;
+
   /* Get currently loaded KML file paths */
   const QStringList& getKmlFiles() const
   {
@@ -287,6 +294,9 @@ public:
    *  Requires Mercator projection. */
   QString createAvitabJson();
 
+  /* As above for the given image corners */
+  static QString createAvitabJson(const atools::geo::Pos& topLeft, const atools::geo::Pos& bottomRight);
+
   /* Override for MapWidget with empty implementation ========================== */
   virtual void jumpBackToAircraftCancel();
 
@@ -435,6 +445,9 @@ signals:
   void searchMarkChanged(const atools::geo::Pos& mark);
 
 protected:
+  /* Override widget events */
+  virtual void paintEvent(QPaintEvent *paintEvent) override;
+
   /* Internal zooming and centering. Zooms one step out to get a sharper map display if allowAdjust is true */
   void centerPosOnMap(const atools::geo::Pos& pos);
   void setDistanceToMap(double dist, bool allowAdjust = true);
@@ -568,8 +581,6 @@ private:
   /* Set map theme and adjust properties accordingly. themePath is the full path to the DGML */
   void setThemeInternal(const QString& themePath);
 
-  /* Override widget events */
-  virtual void paintEvent(QPaintEvent *paintEvent) override;
 
   void unitsUpdated();
 
@@ -0,0 +1,441 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/mapprefetcher.h"
+
+#include "airspace/airspacecontroller.h"
+#include "app/navapp.h"
+#include "atools.h"
+#include "common/constants.h"
+#include "geo/calculations.h"
+#include "mapgui/maplayer.h"
+#include "mapgui/mappaintwidget.h"
+#include "mapgui/mapthemehandler.h"
+#include "mappainter/mappainterairport.h"
+#include "mappainter/mappaintlayer.h"
+#include "query/airwayquery.h"
+#include "query/mapquery.h"
+#include "query/waypointquery.h"
+#include "route/route.h"
+#include "settings/settings.h"
+#include "ui_mainwindow.h"
+
+#include <marble/MarbleDirs.h>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStringBuilder>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <cmath>
+
+using atools::geo::Pos;
+using atools::geo::Rect;
+using Marble::GeoDataLatLonBox;
+using Marble::GeoDataCoordinates;
+
+/* Maximum number of corridor rectangles */
+static const int MAX_CORRIDOR_RECTS = 50;
+
+/* Clear set of read tile files if it grows larger */
+static const int MAX_TILES_READ = 20000;
+
+/* Steps for processing one corridor rectangle. Each step is a single query or the tile file read. */
+enum PrefetchStep
+{
+  STEP_AIRPORT,
+  STEP_VOR,
+  STEP_NDB,
+  STEP_WAYPOINT,
+  STEP_MARKER,
+  STEP_HOLDING,
+  STEP_ILS,
+  STEP_MSA,
+  STEP_AIRWAY,
+  STEP_AIRSPACE,
+  STEP_TILES,
+  STEP_DONE
+};
+
+MapPrefetcher::MapPrefetcher(MapPaintWidget *mapPaintWidget)
+  : QObject(mapPaintWidget), mapWidget(mapPaintWidget)
+{
+  atools::settings::Settings& settings = atools::settings::Settings::instance();
+  bool enabled = settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "PrefetchCorridor", true).toBool();
+  aheadNm = settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "PrefetchCorridorAheadNm", 200.).toFloat();
+  maxTiles = settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "PrefetchCorridorMaxTiles", 256).toInt();
+  int intervalMs = settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "PrefetchCorridorIntervalMs", 250).toInt();
+  budgetMs = settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "PrefetchCorridorBudgetMs", 10).toInt();
+  followBudgetMs = settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "PrefetchCorridorFollowBudgetMs", 3).toInt();
+
+  qDebug() << Q_FUNC_INFO << "enabled" << enabled << "aheadNm" << aheadNm << "maxTiles" << maxTiles
+           << "intervalMs" << intervalMs << "budgetMs" << budgetMs << "followBudgetMs" << followBudgetMs;
+
+  mapQuery = new MapQuery(NavApp::getDatabaseSim(), NavApp::getDatabaseNav(), NavApp::getDatabaseUser());
+  mapQuery->initQueries();
+
+  // Tracks are not prefetched since they are small and held in memory
+  airwayQuery = new AirwayQuery(NavApp::getDatabaseNav(), false /* track */);
+  airwayQuery->initQueries();
+
+  waypointQuery = new WaypointQuery(NavApp::getDatabaseNav(), false /* track */);
+  waypointQuery->initQueries();
+
+  timer.setInterval(intervalMs);
+  connect(&timer, &QTimer::timeout, this, &MapPrefetcher::prefetchNext);
+
+  if(enabled)
+    timer.start();
+}
+
+MapPrefetcher::~MapPrefetcher()
+{
+  timer.stop();
+  tileFuture.waitForFinished();
+  ATOOLS_DELETE_LOG(waypointQuery);
+  ATOOLS_DELETE_LOG(airwayQuery);
+  ATOOLS_DELETE_LOG(mapQuery);
+}
+
+void MapPrefetcher::preDatabaseLoad()
+{
+  databaseLoading = true;
+  corridor.clear();
+  corridorIndex = 0;
+  step = STEP_AIRPORT;
+
+  mapQuery->deInitQueries();
+  airwayQuery->deInitQueries();
+  waypointQuery->deInitQueries();
+}
+
+void MapPrefetcher::postDatabaseLoad()
+{
+  mapQuery->initQueries();
+  airwayQuery->initQueries();
+  waypointQuery->initQueries();
+
+  databaseLoading = false;
+  routeDirty = true;
+}
+
+void MapPrefetcher::routeChanged()
+{
+  routeDirty = true;
+}
+
+bool MapPrefetcher::isFollowingAircraft() const
+{
+  return NavApp::getMainUi()->actionMapAircraftCenter->isChecked() && NavApp::isConnectedAndAircraft();
+}
+
+void MapPrefetcher::prefetchNext()
+{
+  // Map is scrolled on each simulator update when following the aircraft - done by simDataPainted() then
+  if(!isFollowingAircraft())
+    prefetch(budgetMs);
+}
+
+void MapPrefetcher::simDataPainted()
+{
+  // Use the idle time until the next simulator update but leave most of it to painting
+  if(timer.isActive() && isFollowingAircraft())
+    prefetch(followBudgetMs);
+}
+
+void MapPrefetcher::prefetch(int budget)
+{
+  // Work only if idle and not in the middle of scrolling or zooming
+  if(databaseLoading || !mapWidget->isVisible() || mapWidget->viewContext() != Marble::Still)
+    return;
+
+  if(updateCorridor())
+  {
+    corridorIndex = 0;
+    step = STEP_AIRPORT;
+  }
+
+  // Process steps of the current rectangle until the time budget for this tick is used up
+  QElapsedTimer elapsed;
+  elapsed.start();
+  while(corridorIndex < corridor.size() && elapsed.elapsed() < budget)
+  {
+    if(!prefetchStep(corridor.at(corridorIndex)))
+      // Tile reader still busy - try again on next tick
+      break;
+
+    if(++step == STEP_DONE)
+    {
+      corridorIndex++;
+      step = STEP_AIRPORT;
+    }
+  }
+
+  if(elapsed.elapsed() > 100)
+    qDebug() << Q_FUNC_INFO << "rect" << corridorIndex << "of" << corridor.size() << "took" << elapsed.elapsed() << "ms";
+}
+
+bool MapPrefetcher::updateCorridor()
+{
+  const Route& route = NavApp::getRouteConst();
+  const MapLayer *layer = mapWidget->getMapPaintLayer()->getMapLayer();
+
+  if(route.getSizeWithoutAlternates() < 2 || layer == nullptr)
+  {
+    corridor.clear();
+    return false;
+  }
+
+  // Start at aircraft or at map center when panning along the route
+  Pos center(mapWidget->centerLongitude(), mapWidget->centerLatitude());
+  Pos startPos = NavApp::isConnectedAndAircraft() ? NavApp::getUserAircraftPos() : center;
+
+  float startNm = route.getDistanceFromStart(startPos);
+  if(!(startNm < map::INVALID_DISTANCE_VALUE))
+  {
+    // Off route
+    corridor.clear();
+    return false;
+  }
+
+  bool rebuild = routeDirty || layer != corridorLayer || mapWidget->radius() != corridorRadius ||
+                 mapWidget->getCurrentThemeId() != corridorThemeId ||
+                 std::abs(startNm - corridorStartNm) > corridorStepNm;
+
+  if(!rebuild)
+    return false;
+
+  // Half diagonal of the visible area is used as radius for the corridor rectangles
+  Rect viewRect = mapWidget->getCurrentViewRect();
+  float radiusMeter = center.distanceMeterTo(viewRect.getTopLeft());
+  if(!(radiusMeter > 0.f) || radiusMeter > atools::geo::nmToMeter(2000.f))
+  {
+    // Invalid or too large view - nothing useful to prefetch
+    corridor.clear();
+    return false;
+  }
+
+  routeDirty = false;
+  corridorLayer = layer;
+  corridorRadius = mapWidget->radius();
+  corridorThemeId = mapWidget->getCurrentThemeId();
+  corridorStartNm = startNm;
+  corridorStepNm = std::max(atools::geo::meterToNm(radiusMeter), 1.f);
+
+  // Build rectangles along the route ahead but skip the ones in the visible area
+  corridor.clear();
+  const GeoDataLatLonBox& viewBox = mapWidget->getCurrentViewBoundingBox();
+  float endNm = std::min(startNm + std::max(aheadNm, corridorStepNm * 2.f), route.getTotalDistance());
+  for(float distNm = startNm + corridorStepNm; distNm <= endNm && corridor.size() < MAX_CORRIDOR_RECTS;
+      distNm += corridorStepNm)
+  {
+    Pos pos = route.getPositionAtDistance(distNm);
+    if(!pos.isValid())
+      continue;
+
+    if(viewBox.contains(GeoDataCoordinates(pos.getLonX(), pos.getLatY(), 0., GeoDataCoordinates::Degree)))
+      continue;
+
+    Rect rect(pos, radiusMeter, true /* fast */);
+    corridor.append(GeoDataLatLonBox(rect.getNorth(), rect.getSouth(), rect.getEast(), rect.getWest(),
+                                     GeoDataCoordinates::Degree));
+  }
+
+  qDebug() << Q_FUNC_INFO << "startNm" << corridorStartNm << "stepNm" << corridorStepNm
+           << "rects" << corridor.size();
+  return true;
+}
+
+bool MapPrefetcher::prefetchStep(const GeoDataLatLonBox& rect)
+{
+  const MapLayer *layer = corridorLayer;
+  map::MapTypes types = mapWidget->getShownMapTypes();
+  bool overflow = false;
+
+  switch(step)
+  {
+    // Airports and runways for overview ===========================================
+    case STEP_AIRPORT:
+      if(layer->isAirport() && types.testFlag(map::AIRPORT))
+      {
+        const QList<map::MapAirport> *airports = mapQuery->getAirports(rect, layer, false /* lazy */, types, overflow);
+        if(airports != nullptr && !overflow && layer->isAirportOverviewRunway())
+        {
+          // Runway cache of the display query is keyed by airport id and not affected by the rectangle
+          MapQuery *displayQuery = mapWidget->getMapQuery();
+          for(const map::MapAirport& airport : *airports)
+          {
+            if(airport.longestRunwayLength >= MapPainterAirport::RUNWAY_OVERVIEW_MIN_LENGTH_FEET)
+              displayQuery->getRunwaysForOverview(airport.id);
+          }
+        }
+      }
+      break;
+
+    // Navaids ===========================================
+    case STEP_VOR:
+      if(layer->isVor() && types.testFlag(map::VOR))
+        mapQuery->getVors(rect, layer, false /* lazy */, overflow);
+      break;
+
+    case STEP_NDB:
+      if(layer->isNdb() && types.testFlag(map::NDB))
+        mapQuery->getNdbs(rect, layer, false /* lazy */, overflow);
+      break;
+
+    case STEP_WAYPOINT:
+      if(layer->isWaypoint() && types.testFlag(map::WAYPOINT))
+        waypointQuery->getWaypoints(rect, layer, false /* lazy */, overflow);
+      break;
+
+    case STEP_MARKER:
+      if(layer->isMarker() && types.testFlag(map::MARKER))
+        mapQuery->getMarkers(rect, layer, false /* lazy */, overflow);
+      break;
+
+    case STEP_HOLDING:
+      if(layer->isHolding() && types.testFlag(map::HOLDING))
+        mapQuery->getHoldings(rect, layer, false /* lazy */, overflow);
+      break;
+
+    case STEP_ILS:
+      if(layer->isIls() && types.testFlag(map::ILS))
+        mapQuery->getIls(rect, layer, false /* lazy */, overflow);
+      break;
+
+    case STEP_MSA:
+      if(layer->isAirportMsa() && types.testFlag(map::AIRPORT_MSA))
+        mapQuery->getAirportMsa(rect, layer, false /* lazy */, overflow);
+      break;
+
+    // Airways ===========================================
+    case STEP_AIRWAY:
+      if(layer->isAirway() && (types.testFlag(map::AIRWAYJ) || types.testFlag(map::AIRWAYV)))
+        airwayQuery->getAirways(rect, layer, false /* lazy */);
+      break;
+
+    // Airspaces including geometry ===========================================
+    case STEP_AIRSPACE:
+      if(layer->isAnyAirspace() && types.testFlag(map::AIRSPACE))
+        NavApp::getAirspaceController()->prefetchAirspaces(rect, layer,
+                                                           mapWidget->getMapPaintLayer()->getShownAirspacesTypesByLayer(),
+                                                           NavApp::getRouteConst().getCruiseAltitudeFt(),
+                                                           map::AIRSPACE_SRC_NOT_ONLINE);
+      break;
+
+    // Tiles ===========================================
+    case STEP_TILES:
+      if(tileFuture.isRunning())
+        return false;
+
+      prefetchTiles(rect);
+      break;
+  }
+  return true;
+}
+
+void MapPrefetcher::prefetchTiles(const GeoDataLatLonBox& rect)
+{
+  if(mapWidget->projection() != Marble::Mercator)
+    // Tile scheme is the same for all projections but the level calculation below is valid for Mercator only
+    return;
+
+  int level = tileLevel(mapWidget->radius());
+  QStringList filenames;
+
+  // Current level first then the coarser one and the more detailed one which is needed for zooming in
+  for(int lvl : {level, level - 1, level + 1})
+  {
+    if(lvl >= 0 && filenames.size() < maxTiles)
+      tileFilenames(filenames, rect, lvl);
+  }
+
+  // Read files in background to keep disk access out of the GUI thread
+  if(!filenames.isEmpty())
+    tileFuture = QtConcurrent::run(&MapPrefetcher::readTileFiles, filenames);
+}
+
+void MapPrefetcher::readTileFiles(const QStringList& filenames)
+{
+  // Missing tiles are ignored - downloads are left to Marble
+  for(const QString& filename : filenames)
+  {
+    QFile file(filename);
+    if(file.open(QIODevice::ReadOnly))
+    {
+      file.readAll();
+      file.close();
+    }
+  }
+}
+
+void MapPrefetcher::tileFilenames(QStringList& filenames, const GeoDataLatLonBox& rect, int level)
+{
+  const MapTheme& theme = NavApp::getMapThemeHandler()->getTheme(mapWidget->getCurrentThemeId());
+  if(!theme.isValid() || !theme.isTextureLayer() || !theme.hasMercatorTiles() || theme.getSourceDirs().isEmpty())
+    return;
+
+  if(tilesRead.size() > MAX_TILES_READ)
+    tilesRead.clear();
+
+  QString suffix = theme.getSourceFormat().isEmpty() ? QStringLiteral("png") : theme.getSourceFormat();
+  QString basePath = Marble::MarbleDirs::localPath() % atools::SEP % "maps" % atools::SEP %
+                     theme.getSourceDirs().constFirst() % atools::SEP % QString::number(level) % atools::SEP;
+
+  // Tile numbers as used by OpenStreetMap ==============================
+  int numTilesLevel = 1 << level;
+  auto tileX = [numTilesLevel](double lonDeg) -> int {
+                 return atools::minmax(0, numTilesLevel - 1,
+                                       static_cast<int>(std::floor((lonDeg + 180.) / 360. * numTilesLevel)));
+               };
+  auto tileY = [numTilesLevel](double latDeg) -> int {
+                 double latRad = atools::geo::toRadians(atools::minmax(-85.0511, 85.0511, latDeg));
+                 return atools::minmax(0, numTilesLevel - 1,
+                                       static_cast<int>(std::floor((1. - std::asinh(std::tan(latRad)) / M_PI) / 2. *
+                                                                   numTilesLevel)));
+               };
+
+  int xWest = tileX(rect.west(GeoDataCoordinates::Degree)), xEast = tileX(rect.east(GeoDataCoordinates::Degree));
+  int yNorth = tileY(rect.north(GeoDataCoordinates::Degree)), ySouth = tileY(rect.south(GeoDataCoordinates::Degree));
+
+  // Wrap around at the anti-meridian
+  int numX = (xEast - xWest + numTilesLevel) % numTilesLevel + 1;
+
+  for(int i = 0; i < numX && filenames.size() < maxTiles; i++)
+  {
+    QString columnPath = basePath % QString::number((xWest + i) % numTilesLevel) % atools::SEP;
+    for(int y = yNorth; y <= ySouth && filenames.size() < maxTiles; y++)
+    {
+      QString filename = columnPath % QString::number(y) % "." % suffix;
+
+      // Read tiles only once - also missing ones
+      if(!tilesRead.contains(filename))
+      {
+        tilesRead.insert(filename);
+        filenames.append(filename);
+      }
+    }
+  }
+}
+
+int MapPrefetcher::tileLevel(int radius)
+{
+  // Texture width of a level is 256 * 2^level pixel which should cover the map width in pixel.
+  // Marble's Mercator projection maps 360 degree longitude to 4 * radius pixel.
+  double mapWidthPixel = 4. * radius;
+  return atools::minmax(0, 20, static_cast<int>(std::ceil(std::log2(std::max(mapWidthPixel / 256., 1.)))));
+}
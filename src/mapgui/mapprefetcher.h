@@ -0,0 +1,132 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_MAPPREFETCHER_H
+#define LNM_MAPPREFETCHER_H
+
+#include <QFuture>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+#include <marble/GeoDataLatLonBox.h>
+
+class MapPaintWidget;
+class MapLayer;
+class MapQuery;
+class AirwayQuery;
+class WaypointQuery;
+
+/*
+ * Loads map objects and base map tiles along the flight plan corridor ahead of the aircraft in idle time.
+ *
+ * The corridor starts at the aircraft position if connected or at the map center otherwise and is split into
+ * rectangles of the current view size. Each timer tick processes query steps of the current rectangle until a small
+ * time budget is used up. Nothing is done while the map is moving. While following the aircraft steps are processed
+ * with a reduced budget right after the map was redrawn for a simulator update instead of on timer ticks.
+ *
+ * Airports, navaids, airways and others are queried with separate query objects to keep the map display caches
+ * intact. This warms the SQLite page cache, the runway overview cache of the map query and the airspace geometry cache.
+ *
+ * Marble keeps decoded tiles in a private texture layer cache. The prefetcher therefore reads cached tile files of
+ * the current and neighbouring tile levels from the disk cache in a background thread which makes them available in
+ * the OS file cache. Only themes using the Mercator tile scheme are supported.
+ */
+class MapPrefetcher :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit MapPrefetcher(MapPaintWidget *mapPaintWidget);
+  virtual ~MapPrefetcher() override;
+
+  MapPrefetcher(const MapPrefetcher& other) = delete;
+  MapPrefetcher& operator=(const MapPrefetcher& other) = delete;
+
+  /* Stops prefetching and closes queries */
+  void preDatabaseLoad();
+  void postDatabaseLoad();
+
+  /* Rebuild corridor on next timer tick */
+  void routeChanged();
+
+  /* Map was redrawn after a simulator update. Processes steps with reduced budget when following the aircraft. */
+  void simDataPainted();
+
+private:
+  /* Timer slot processing the next steps of the current corridor rectangle */
+  void prefetchNext();
+
+  /* Process steps of the current rectangle until the time budget is used up */
+  void prefetch(int budget);
+
+  /* true if the map is scrolled on each simulator update */
+  bool isFollowingAircraft() const;
+
+  /* Rebuilds corridor if aircraft moved, route or zoom changed. Returns true if a new corridor was built. */
+  bool updateCorridor();
+
+  /* Run the current step for the rectangle. Returns false if the step has to be repeated later. */
+  bool prefetchStep(const Marble::GeoDataLatLonBox& rect);
+
+  /* Start reading tile files for the rectangle in background */
+  void prefetchTiles(const Marble::GeoDataLatLonBox& rect);
+
+  /* Add not yet read tile files for the rectangle at the given level up to maxTiles */
+  void tileFilenames(QStringList& filenames, const Marble::GeoDataLatLonBox& rect, int level);
+
+  /* Called in background thread */
+  static void readTileFiles(const QStringList& filenames);
+
+  /* Approximation of Marble texture tile level for Mercator tiles */
+  static int tileLevel(int radius);
+
+  MapPaintWidget *mapWidget;
+
+  /* Separate queries to avoid overwriting the map display caches */
+  MapQuery *mapQuery = nullptr;
+  AirwayQuery *airwayQuery = nullptr;
+  WaypointQuery *waypointQuery = nullptr;
+
+  QTimer timer;
+
+  /* Rectangles ahead along the route and index of the next one to process */
+  QVector<Marble::GeoDataLatLonBox> corridor;
+  int corridorIndex = 0;
+
+  /* Next step in the current rectangle. See enum PrefetchStep. */
+  int step = 0;
+
+  /* Parameters used to build the corridor */
+  float corridorStartNm = -1.f, corridorStepNm = 0.f;
+  const MapLayer *corridorLayer = nullptr;
+  int corridorRadius = 0;
+  QString corridorThemeId;
+  bool routeDirty = true, databaseLoading = false;
+
+  /* Tile files already read - cleared when getting too large */
+  QSet<QString> tilesRead;
+  QFuture<void> tileFuture;
+
+  /* From settings */
+  float aheadNm = 200.f;
+  int maxTiles = 256, budgetMs = 10, followBudgetMs = 3;
+};
+
+#endif // LNM_MAPPREFETCHER_H
@@ -24,6 +24,7 @@
 #include "fs/gpx/gpxtypes.h"
 #include "fs/sc/simconnectdata.h"
 #include "logbook/logdatacontroller.h"
+#include "mapgui/aircraftindex.h"
 #include "mapgui/mapairporthandler.h"
 #include "mapgui/mapfunctions.h"
 #include "mapgui/maplayer.h"
@@ -76,6 +77,7 @@ MapScreenIndex::MapScreenIndex(MapPaintWidget *mapPaintWidgetParam, MapPaintLaye
 
   simData = new SimConnectData;
   lastSimData = new SimConnectData;
+  aiAircraftIndex = new AircraftIndex;
   lastUserAircraftForAverage = new SimConnectUserAircraft;
   searchHighlights = new map::MapResult;
   procedureHighlight = new proc::MapProcedureLegs;
@@ -92,6 +94,7 @@ MapScreenIndex::~MapScreenIndex()
   delete movingAverageSimAircraft;
   delete simData;
   delete lastSimData;
+  delete aiAircraftIndex;
   delete lastUserAircraftForAverage;
   delete profileHighlight;
 }
@@ -101,6 +104,7 @@ void MapScreenIndex::copy(const MapScreenIndex& other)
   // Copy content of pointer objects
   *simData = *other.simData;
   *lastSimData = *other.lastSimData;
+  *aiAircraftIndex = *other.aiAircraftIndex;
   *searchHighlights = *other.searchHighlights;
   *procedureLegHighlight = *other.procedureLegHighlight;
   *procedureHighlight = *other.procedureHighlight;
@@ -120,8 +124,10 @@ void MapScreenIndex::copy(const MapScreenIndex& other)
   msaMarks = other.msaMarks;
   routeLines = other.routeLines;
   airwayLines = other.airwayLines;
+  airwayLinesPainted = other.airwayLinesPainted;
   logEntryLines = other.logEntryLines;
   airspacePolygons = other.airspacePolygons;
+  airspacePolygonsPainted = other.airspacePolygonsPainted;
   ilsPolygons = other.ilsPolygons;
   ilsLines = other.ilsLines;
   routePointsEditable = other.routePointsEditable;
@@ -130,27 +136,15 @@ void MapScreenIndex::copy(const MapScreenIndex& other)
   routeDrawnNavaids = other.routeDrawnNavaids;
 }
 
-void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceId>& ids, map::MapAirspaceSources source,
-                                                          const Marble::GeoDataLatLonBox& curBox, bool highlights)
+void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceId>& ids, const Marble::GeoDataLatLonBox& curBox)
 {
   const MapScale *scale = paintLayer->getMapScale();
   AirspaceController *controller = NavApp::getAirspaceController();
 
-  if(paintLayer->getMapLayer() == nullptr)
-    return;
-
-  if(scale->isValid() && controller != nullptr && paintLayer != nullptr)
+  if(scale->isValid() && controller != nullptr)
   {
-    map::MapAirspaceFilter filter = mapWidget->getShownAirspaceTypesByLayer();
-
     AirspaceVector airspaces;
 
-    // Get displayed airspaces ================================
-    bool overflow = false;
-    if(!highlights && paintLayer->getShownMapTypes().testFlag(map::AIRSPACE))
-      controller->getAirspaces(airspaces, curBox, paintLayer->getMapLayer(), filter,
-                               NavApp::getRouteConst().getCruiseAltitudeFt(), false /* lazy */, source, overflow);
-
     // Get highlighted airspaces from info window ================================
     for(const map::MapAirspace& airspace : qAsConst(airspaceHighlights))
     {
@@ -168,9 +162,6 @@ void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceI
     CoordinateConverter conv(mapWidget->viewport());
     for(const map::MapAirspace *airspace : qAsConst(airspaces))
     {
-      if(!(airspace->type & filter.types) && !highlights)
-        continue;
-
       Marble::GeoDataLatLonBox airspacebox = conv.toGdc(airspace->bounding);
 
       // Check if airspace overlaps with current screen and is not already in list
@@ -179,13 +170,11 @@ void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceI
         const atools::geo::LineString *lines = controller->getAirspaceGeometry(airspace->combinedId());
         if(lines != nullptr)
         {
+          // Polygons are already cut at the screen rectangle
           const QVector<QPolygonF *> polys = conv.createPolygons(*lines, mapWidget->rect());
           for(const QPolygonF *poly : qAsConst(polys))
-          {
-            // Cut off all polygon parts that are not visible on screen
-            airspacePolygons.append(std::make_pair(airspace->combinedId(), poly->intersected(QPolygon(mapWidget->rect())).toPolygon()));
-            ids.insert(airspace->combinedId());
-          }
+            airspacePolygons.append(std::make_pair(airspace->combinedId(), poly->toPolygon()));
+          ids.insert(airspace->combinedId());
           conv.releasePolygons(polys);
         }
       }
@@ -211,21 +200,32 @@ void MapScreenIndex::updateAirspaceScreenGeometry(const Marble::GeoDataLatLonBox
   if(paintLayer == nullptr || paintLayer->getMapLayer() == nullptr)
     return;
 
-  // Use ID set to check for duplicates between calls
+  // Use ID set to check for duplicates
   QSet<map::MapAirspaceId> ids;
 
-  // First get geometry from highlights
-  updateAirspaceScreenGeometryInternal(ids, NavApp::getAirspaceController()->getAirspaceSources(), curBox, true /* highlights */);
+  // Get geometry from highlights only - visible airspaces are added by MapPainterAirspace while drawing
+  updateAirspaceScreenGeometryInternal(ids, curBox);
+}
 
-  if(!paintLayer->getMapLayer()->isAnyAirspace() || !paintLayer->getShownMapTypes().testFlag(map::AIRSPACE))
-    return;
+void MapScreenIndex::resetPaintedScreenGeometry()
+{
+  airspacePolygonsPainted.clear();
+  airwayLinesPainted.clear();
+}
 
-  // Do not put into index if nothing is drawn
-  if(mapWidget->isDistanceCutOff())
-    return;
+void MapScreenIndex::addPaintedAirspace(const map::MapAirspaceId& id, const QVector<QPolygonF *>& polygons)
+{
+  for(const QPolygonF *polygon : polygons)
+    airspacePolygonsPainted.append(std::make_pair(id, polygon->toPolygon()));
+}
 
-  // Get geometry from visible airspaces
-  updateAirspaceScreenGeometryInternal(ids, NavApp::getAirspaceController()->getAirspaceSources(), curBox, false /* highlights */);
+void MapScreenIndex::addPaintedAirway(int id, const QVector<QPolygonF *>& polylines)
+{
+  for(const QPolygonF *polyline : polylines)
+  {
+    for(int i = 0; i < polyline->size() - 1; i++)
+      airwayLinesPainted.append(std::make_pair(id, QLine(polyline->at(i).toPoint(), polyline->at(i + 1).toPoint())));
+  }
 }
 
 void MapScreenIndex::updateIlsScreenGeometry(const Marble::GeoDataLatLonBox& curBox)
@@ -369,84 +369,21 @@ void MapScreenIndex::updateAirwayScreenGeometry(const Marble::GeoDataLatLonBox&
 
   airwayLines.clear();
 
-  // Use ID set to check for duplicates between calls
-  QSet<int> ids;
-
-  // First get geometry from highlights
-  updateAirwayScreenGeometryInternal(ids, curBox, true /* highlight */);
-
-  // Get geometry from visible airways
-  updateAirwayScreenGeometryInternal(ids, curBox, false /* highlight */);
-}
-
-void MapScreenIndex::updateAirwayScreenGeometryInternal(QSet<int>& ids, const Marble::GeoDataLatLonBox& curBox, bool highlight)
-{
+  // Get geometry from highlights only - visible airways and tracks are added by MapPainterNav while drawing
   const MapScale *scale = paintLayer->getMapScale();
-  AirwayTrackQuery *airwayTrackQuery = mapWidget->getAirwayTrackQuery();
-
   if(scale->isValid())
   {
+    // Use ID set to check for duplicates
+    QSet<int> ids;
     CoordinateConverter conv(mapWidget->viewport());
-    if(!highlight)
-    {
-      // Get geometry from visible airspaces
-      bool showJet = paintLayer->getShownMapTypes().testFlag(map::AIRWAYJ);
-      bool showVictor = paintLayer->getShownMapTypes().testFlag(map::AIRWAYV);
-      if(paintLayer->getMapLayer()->isAirway() && (showJet || showVictor))
-      {
-        // Airways are visible on map - get them from the cache/database
-        QList<MapAirway> airways;
-        airwayTrackQuery->getAirways(airways, curBox, paintLayer->getMapLayer(), false);
-
-        for(int i = 0; i < airways.size(); i++)
-        {
-          const MapAirway& airway = airways.at(i);
-          if(ids.contains(airway.id))
-            continue;
-
-          if((airway.type == map::AIRWAY_VICTOR && !showVictor) || (airway.type == map::AIRWAY_JET && !showJet))
-            // Not visible by map setting
-            continue;
-
-          updateLineScreenGeometry(airwayLines, airway.id, Line(airway.from, airway.to), curBox, conv);
-          ids.insert(airway.id);
-        }
-      }
-
-      bool showTrack = paintLayer->getShownMapTypes().testFlag(map::TRACK);
-      if(paintLayer->getMapLayer()->isTrack() && showTrack)
-      {
-        // Tracks are visible on map - get them from the cache/database
-        QList<MapAirway> tracks;
-        airwayTrackQuery->getTracks(tracks, curBox, paintLayer->getMapLayer(), false);
-
-        for(int i = 0; i < tracks.size(); i++)
-        {
-          const MapAirway& track = tracks.at(i);
-          if(ids.contains(track.id))
-            continue;
-
-          if(track.isTrack() && !showTrack)
-            // Not visible by map setting
-            continue;
-
-          updateLineScreenGeometry(airwayLines, track.id, Line(track.from, track.to), curBox, conv);
-          ids.insert(track.id);
-        }
-      }
-    }
-    else
+    for(const QList<map::MapAirway>& airwayList : qAsConst(airwayHighlights))
     {
-      // Get geometry from highlights
-      for(const QList<map::MapAirway>& airwayList : qAsConst(airwayHighlights))
+      for(const map::MapAirway& airway : airwayList)
       {
-        for(const map::MapAirway& airway : airwayList)
-        {
-          if(ids.contains(airway.id))
-            continue;
-          updateLineScreenGeometry(airwayLines, airway.id, Line(airway.from, airway.to), curBox, conv);
-          ids.insert(airway.id);
-        }
+        if(ids.contains(airway.id))
+          continue;
+        updateLineScreenGeometry(airwayLines, airway.id, Line(airway.from, airway.to), curBox, conv);
+        ids.insert(airway.id);
       }
     }
   }
@@ -657,6 +594,30 @@ const QVector<atools::fs::sc::SimConnectAircraft>& MapScreenIndex::getAiAircraft
   return simData->getAiAircraftConst();
 }
 
+QVector<const atools::fs::sc::SimConnectAircraft *> MapScreenIndex::getAiAircraft(const atools::geo::Rect& rect) const
+{
+  const QVector<atools::fs::sc::SimConnectAircraft>& aiAircraft = simData->getAiAircraftConst();
+
+  QVector<int> indexes;
+  aiAircraftIndex->getIndexes(indexes, rect);
+
+  QVector<const atools::fs::sc::SimConnectAircraft *> retval;
+  retval.reserve(indexes.size());
+  for(int index : qAsConst(indexes))
+    retval.append(&aiAircraft.at(index));
+  return retval;
+}
+
+atools::geo::Pos MapScreenIndex::getAiAircraftPos(const atools::fs::sc::SimConnectAircraft& aircraft, qint64 timestampMs) const
+{
+  return aiAircraftIndex->getInterpolatedPos(aircraft, timestampMs);
+}
+
+bool MapScreenIndex::hasMovingAiAircraft() const
+{
+  return aiAircraftIndex->hasMovingAircraft();
+}
+
 void MapScreenIndex::clearSimData()
 {
   updateSimData(SimConnectData());
@@ -665,6 +626,7 @@ void MapScreenIndex::clearSimData()
 void MapScreenIndex::updateSimData(const atools::fs::sc::SimConnectData& data)
 {
   *simData = data;
+  aiAircraftIndex->update(simData->getAiAircraftConst(), QDateTime::currentMSecsSinceEpoch());
   updateAverageTurn();
 }
 
@@ -846,17 +808,27 @@ void MapScreenIndex::getAllNearest(const QPoint& point, int maxDistance, map::Ma
   // Check for AI / multiplayer aircraft from simulator ==============================
   int x, y;
 
+  // Get only aircraft near the cursor from the spatial index
+  // Check all if the search square is not completely on the globe or close to the poles
+  Rect searchRect;
+  Pos topLeft = conv.sToW(xs - maxDistance, ys - maxDistance), bottomRight = conv.sToW(xs + maxDistance, ys + maxDistance);
+  if(topLeft.isValid() && bottomRight.isValid() && std::abs(topLeft.getLatY()) < 80.f && std::abs(bottomRight.getLatY()) < 80.f)
+    searchRect = Rect(topLeft.getLonX(), topLeft.getLatY(), bottomRight.getLonX(), bottomRight.getLatY());
+  const QVector<const atools::fs::sc::SimConnectAircraft *> nearAiAircraft = getAiAircraft(searchRect);
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+
   // Add boats ======================================
   result.aiAircraft.clear();
   if(NavApp::isConnected())
   {
     if(shown & map::AIRCRAFT_AI_SHIP && mapLayer->isAiShipLarge())
     {
-      for(const atools::fs::sc::SimConnectAircraft& obj : simData->getAiAircraftConst())
+      for(const atools::fs::sc::SimConnectAircraft *ship : nearAiAircraft)
       {
+        const atools::fs::sc::SimConnectAircraft& obj = *ship;
         if(obj.isValid() && obj.isAnyBoat() && (obj.getModelRadiusCorrected() * 2 > layer::LARGE_SHIP_SIZE || mapLayer->isAiShipSmall()))
         {
-          if(conv.wToS(obj.getPosition(), x, y))
+          if(conv.wToS(getAiAircraftPos(obj, now), x, y))
           {
             if((atools::geo::manhattanDistance(x, y, xs, ys)) < maxDistance)
               insertSortedByDistance(conv, result.aiAircraft, nullptr, xs, ys, map::MapAiAircraft(obj));
@@ -871,8 +843,10 @@ void MapScreenIndex::getAllNearest(const QPoint& point, int maxDistance, map::Ma
   bool hideAiOnGround = OptionData::instance().getFlags().testFlag(opts::MAP_AI_HIDE_GROUND);
 
   // Add AI or injected multiplayer aircraft ======================================
-  for(const atools::fs::sc::SimConnectAircraft& ac : mapWidget->getAiAircraft())
+  for(const atools::fs::sc::SimConnectAircraft *aircraft : nearAiAircraft)
   {
+    const atools::fs::sc::SimConnectAircraft& ac = *aircraft;
+
     // Skip boats
     if(ac.isAnyBoat())
       continue;
@@ -887,7 +861,7 @@ void MapScreenIndex::getAllNearest(const QPoint& point, int maxDistance, map::Ma
 
     if(ac.isValid() && !ac.isAnyBoat() && mapfunc::aircraftVisible(ac, mapLayer, hideAiOnGround))
     {
-      if(conv.wToS(ac.getPosition(), x, y))
+      if(conv.wToS(getAiAircraftPos(ac, now), x, y))
       {
         if((atools::geo::manhattanDistance(x, y, xs, ys)) < maxDistance)
         {
@@ -1257,10 +1231,18 @@ void MapScreenIndex::updateAllGeometry(const Marble::GeoDataLatLonBox& curBox)
 
 void MapScreenIndex::getNearestAirspaces(int xs, int ys, map::MapResult& result) const
 {
-  for(const std::pair<map::MapAirspaceId, QPolygon>& polyPair : airspacePolygons)
+  // Highlights first and then painted airspaces avoiding duplicates
+  QSet<map::MapAirspaceId> ids;
+  for(const QList<std::pair<map::MapAirspaceId, QPolygon> > *polygons : {&airspacePolygons, &airspacePolygonsPainted})
   {
-    if(polyPair.second.containsPoint(QPoint(xs, ys), Qt::OddEvenFill))
-      result.airspaces.append(NavApp::getAirspaceController()->getAirspaceById(polyPair.first));
+    for(const std::pair<map::MapAirspaceId, QPolygon>& polyPair : *polygons)
+    {
+      if(!ids.contains(polyPair.first) && polyPair.second.containsPoint(QPoint(xs, ys), Qt::OddEvenFill))
+      {
+        result.airspaces.append(NavApp::getAirspaceController()->getAirspaceById(polyPair.first));
+        ids.insert(polyPair.first);
+      }
+    }
   }
 }
 
@@ -1334,7 +1316,8 @@ void MapScreenIndex::getNearestIls(int xs, int ys, int maxDistance, map::MapResu
 void MapScreenIndex::getNearestAirways(int xs, int ys, int maxDistance, map::MapResult& result) const
 {
   AirwayTrackQuery *airwayTrackQuery = mapWidget->getAirwayTrackQuery();
-  const QSet<int> nearestIds = nearestLineIds(airwayLines, xs, ys, maxDistance, true /* lineDistanceOnly */);
+  const QSet<int> nearestIds = nearestLineIds(airwayLines, xs, ys, maxDistance, true /* lineDistanceOnly */) +
+                               nearestLineIds(airwayLinesPainted, xs, ys, maxDistance, true /* lineDistanceOnly */);
   for(int id : nearestIds)
     result.airways.append(airwayTrackQuery->getAirwayById(id));
 }
@@ -37,9 +37,12 @@ class MovingAverageTime;
 namespace geo {
 class Line;
 class Pos;
+class Rect;
 }
 }
 
+class AircraftIndex;
+
 namespace proc {
 struct MapProcedureLeg;
 struct MapProcedureLegs;
@@ -79,6 +82,7 @@ class AirportQuery;
 class MapPaintLayer;
 class MapQuery;
 class CoordinateConverter;
+class QPolygonF;
 
 /*
  * Keeps an indes of certain map objects like flight plan lines, airway lines in screen coordinates
@@ -124,8 +128,9 @@ public:
   /* Update geometry after a route or scroll or map change */
   void updateAllGeometry(const Marble::GeoDataLatLonBox& curBox);
   void updateRouteScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
-  void updateAirwayScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
 
+  /* Update only highlighted airways and airspaces. Visible ones are added by the painters while drawing. */
+  void updateAirwayScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
   void updateAirspaceScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
   void updateIlsScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
   void updateLogEntryScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
@@ -134,6 +139,14 @@ public:
   void resetAirspaceOnlineScreenGeometry();
   void resetIlsScreenGeometry();
 
+  /* Clear geometry added by painters. Called by MapPaintLayer::render() before drawing. */
+  void resetPaintedScreenGeometry();
+
+  /* Add screen geometry of an airspace or airway segment as drawn by the painter. Coordinates are already
+   * projected and cut to the screen rectangle. */
+  void addPaintedAirspace(const map::MapAirspaceId& id, const QVector<QPolygonF *>& polygons);
+  void addPaintedAirway(int id, const QVector<QPolygonF *>& polylines);
+
   /* Save and restore distance markers and range rings */
   void saveState() const;
   void restoreState();
@@ -252,6 +265,16 @@ public:
 
   const QVector<atools::fs::sc::SimConnectAircraft>& getAiAircraft() const;
 
+  /* AI aircraft and ships which are in or near rect. Rect can cross the anti-meridian. Uses a spatial index.
+   * Returns all if rect is not valid. Order is the same as in getAiAircraft(). */
+  QVector<const atools::fs::sc::SimConnectAircraft *> getAiAircraft(const atools::geo::Rect& rect) const;
+
+  /* Position of an AI aircraft or ship extrapolated to timestampMs for smooth movement between packets */
+  atools::geo::Pos getAiAircraftPos(const atools::fs::sc::SimConnectAircraft& aircraft, qint64 timestampMs) const;
+
+  /* true if any AI aircraft or ship is moving and needs interpolation */
+  bool hasMovingAiAircraft() const;
+
   void clearSimData();
 
   void updateSimData(const atools::fs::sc::SimConnectData& data);
@@ -285,7 +308,7 @@ public:
   /* For debug functions */
   QList<std::pair<int, QLine> > getAirwayLines() const
   {
-    return airwayLines;
+    return airwayLines + airwayLinesPainted;
   }
 
   const QVector<map::MapRef>& getRouteDrawnNavaidsConst() const
@@ -311,9 +334,7 @@ private:
   void getNearestProcedureHighlights(int xs, int ys, int maxDistance, map::MapResult& result, map::MapObjectQueryTypes types) const;
   void nearestProcedureHighlightsInternal(int xs, int ys, int maxDistance, map::MapResult& result, map::MapObjectQueryTypes types,
                                           const QVector<proc::MapProcedureLegs>& procedureLegs, bool previewAll) const;
-  void updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceId>& ids, map::MapAirspaceSources source,
-                                            const Marble::GeoDataLatLonBox& curBox, bool highlights);
-  void updateAirwayScreenGeometryInternal(QSet<int>& ids, const Marble::GeoDataLatLonBox& curBox, bool highlight);
+  void updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceId>& ids, const Marble::GeoDataLatLonBox& curBox);
 
   void updateLineScreenGeometry(QList<std::pair<int, QLine> >& index, int id, const atools::geo::Line& line,
                                 const Marble::GeoDataLatLonBox& curBox, const CoordinateConverter& conv);
@@ -328,6 +349,9 @@ private:
 
   atools::fs::sc::SimConnectData *simData, *lastSimData;
 
+  /* Spatial index for AI aircraft in simData. Updated with each packet. */
+  AircraftIndex *aiAircraftIndex;
+
   /* Average values for ground speed and turn speed for turn path display. */
   atools::fs::sc::SimConnectUserAircraft *lastUserAircraftForAverage;
   QDateTime lastUserAircraftForAverageTs;
@@ -379,11 +403,13 @@ private:
   QList<std::pair<int, QPoint> > routePointsAll; /* All points */
 
   /* Geometry objects that are cached in screen coordinate system for faster access to tooltips etc. */
-  QList<std::pair<int, QLine> > airwayLines;
+  QList<std::pair<int, QLine> > airwayLines; /* Highlights only */
+  QList<std::pair<int, QLine> > airwayLinesPainted; /* Filled by MapPainterNav */
 
   /* Collects logbook entry route and direct line geometry */
   QList<std::pair<int, QLine> > logEntryLines;
-  QList<std::pair<map::MapAirspaceId, QPolygon> > airspacePolygons;
+  QList<std::pair<map::MapAirspaceId, QPolygon> > airspacePolygons; /* Highlights only */
+  QList<std::pair<map::MapAirspaceId, QPolygon> > airspacePolygonsPainted; /* Filled by MapPainterAirspace */
   QList<std::pair<int, QPolygon> > ilsPolygons;
   QList<std::pair<int, QLine> > ilsLines; /* Index ILS center lines separately to allow
                                            * tooltips when getting the cursor near a line */
@@ -459,7 +459,16 @@ MapTheme MapThemeHandler::loadTheme(const QFileInfo& dgml)
                     theme.online = true;
                   }
                   else if(reader.name() == "sourcedir")
+                  {
+                    if(theme.sourceFormat.isEmpty())
+                      theme.sourceFormat = reader.attributes().value("format").toString().toLower();
                     theme.sourceDirs.append(atools::nativeCleanPath(reader.readElementText().trimmed()));
+                  }
+                  else if(reader.name() == "tileProjection")
+                  {
+                    theme.mercatorTiles = reader.attributes().value("type").toString().compare("Mercator", Qt::CaseInsensitive) == 0;
+                    xmlStream.skipCurrentElement();
+                  }
                   else
                     xmlStream.skipCurrentElement();
                 }
@@ -548,6 +557,8 @@ QDebug operator<<(QDebug out, const MapTheme& theme)
       << "urlName" << theme.urlName
       << "urlRef" << theme.urlRef
       << "sourceDirs" << theme.sourceDirs
+      << "sourceFormat" << theme.sourceFormat
+      << "mercatorTiles" << theme.mercatorTiles
       << "dgmlFilepath" << theme.dgmlFilepath
       << "name" << theme.name
       << "copyright" << theme.copyright
@@ -152,6 +152,24 @@ public:
     return online;
   }
 
+  /* Relative tile directories like "earth/openstreetmap" from element "sourcedir" */
+  const QStringList& getSourceDirs() const
+  {
+    return sourceDirs;
+  }
+
+  /* Lowercase file suffix for tiles from attribute "format" in the first "sourcedir". Empty if not given. */
+  const QString& getSourceFormat() const
+  {
+    return sourceFormat;
+  }
+
+  /* True if tiles use the Mercator scheme "tileProjection" like OpenStreetMap. */
+  bool hasMercatorTiles() const
+  {
+    return mercatorTiles;
+  }
+
 private:
   friend class MapThemeHandler;
   friend QDebug operator<<(QDebug out, const MapTheme& theme);
@@ -159,8 +177,10 @@ private:
   int index = -1;
   QString dgmlFilepath, name, copyright, theme, target, urlName, urlRef;
   QStringList sourceDirs;
+  QString sourceFormat;
   QStringList keys;
-  bool textureLayer = false, geodataLayer = false, discrete = false, visible = false, online = false;
+  bool textureLayer = false, geodataLayer = false, discrete = false, visible = false, online = false,
+       mercatorTiles = false;
 };
 
 /*
@@ -0,0 +1,402 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/maptilerenderer.h"
+
+#include "atools.h"
+#include "exception.h"
+#include "geo/calculations.h"
+#include "mapgui/mappaintwidget.h"
+#include "print/printsupport.h"
+
+#include <marble/HttpDownloadManager.h>
+#include <marble/MarbleModel.h>
+#include <marble/ViewportParams.h>
+
+#include <QApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QProgressDialog>
+#include <QTimer>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <zlib.h>
+
+/* Wait this time for tile downloads per tile */
+static const int TILE_DOWNLOAD_WAIT_MS = 10000;
+
+/* Maximum time to wait for tile downloads for the whole image. Missing tiles are ignored once exceeded. */
+static const int TOTAL_DOWNLOAD_WAIT_MS = 60000;
+
+/* Size of compressed data in each PNG IDAT chunk */
+static const int PNG_CHUNK_SIZE = 256 * 1024;
+
+MapTileRenderer::MapTileRenderer(QWidget *parentWidget, MapPaintWidget& sourceWidget, const QSize& imageSize)
+  : parent(parentWidget), source(sourceWidget), size(imageSize)
+{
+  // Scale globe radius so that the visible area of the source fits into the image
+  double scale = std::min(static_cast<double>(size.width()) / source.width(),
+                          static_cast<double>(size.height()) / source.height());
+  radius = atools::roundToInt(source.radius() * scale);
+
+  // Same as in Marble MercatorProjection
+  rad2Pixel = 2. * radius / M_PI;
+
+  centerLonRad = atools::geo::toRadians(source.centerLongitude());
+  centerLatRad = atools::geo::toRadians(source.centerLatitude());
+  centerMercY = std::atanh(std::sin(centerLatRad));
+
+  qDebug() << Q_FUNC_INFO << "size" << size << "radius" << radius << "source radius" << source.radius()
+           << "center" << source.centerLongitude() << source.centerLatitude();
+}
+
+MapTileRenderer::~MapTileRenderer()
+{
+}
+
+bool MapTileRenderer::isTiledRendering(const MapPaintWidget& sourceWidget, const QSize& imageSize)
+{
+  return sourceWidget.projection() == Marble::Mercator &&
+         static_cast<qint64>(imageSize.width()) * imageSize.height() > MAX_SINGLE_PASS_PIXELS;
+}
+
+atools::geo::Pos MapTileRenderer::imageToWorld(double x, double y) const
+{
+  // Marble uses integer division for the screen center
+  double lonRad = centerLonRad + (x - size.width() / 2) / rad2Pixel;
+  double latRad = std::atan(std::sinh(centerMercY - (y - size.height() / 2) / rad2Pixel));
+  return atools::geo::Pos(atools::geo::toDegree(lonRad), atools::geo::toDegree(latRad)).normalized();
+}
+
+QString MapTileRenderer::createAvitabJson() const
+{
+  return MapPaintWidget::createAvitabJson(imageToWorld(0., 0.), imageToWorld(size.width() - 1, size.height() - 1));
+}
+
+QImage MapTileRenderer::renderTile(MapPaintWidget& tileWidget, int centerX, int centerY)
+{
+  atools::geo::Pos center = imageToWorld(centerX, centerY);
+  tileWidget.centerOn(center.getLonX(), center.getLatY(), false /* animated */);
+
+  // Render once which also triggers downloads of missing map tiles
+  int tileWidgetSize = TILE_SIZE + 2 * TILE_MARGIN;
+  QImage image = tileWidget.getPixmap(tileWidgetSize, tileWidgetSize).toImage();
+
+  // Most tiles are usually cached by the source widget - done if complete or out of download time
+  int remainingMs = TOTAL_DOWNLOAD_WAIT_MS - static_cast<int>(downloadWaitMs);
+  if(tileWidget.renderStatus() == Marble::Complete || remainingMs <= 0 ||
+     (progressDialog != nullptr && progressDialog->wasCanceled()))
+    return image;
+
+  // Wait for downloads and render again
+  QElapsedTimer timer;
+  timer.start();
+
+  QEventLoop eventLoop;
+  QTimer timeout;
+  timeout.setSingleShot(true);
+  QObject::connect(&timeout, &QTimer::timeout, &eventLoop, &QEventLoop::quit);
+
+  // Stop waiting once all download jobs are done
+  QObject::connect(tileWidget.model()->downloadManager(), &Marble::HttpDownloadManager::progressChanged, &eventLoop,
+                   [&eventLoop](int active, int queued) -> void {
+    if(active == 0 && queued == 0)
+      eventLoop.quit();
+  });
+
+  QObject::connect(&tileWidget, &MapPaintWidget::renderStatusChanged, &eventLoop,
+                   [&eventLoop](Marble::RenderStatus status) -> void {
+    if(status == Marble::Complete)
+      eventLoop.quit();
+  });
+
+  if(progressDialog != nullptr)
+    QObject::connect(progressDialog, &QProgressDialog::canceled, &eventLoop, &QEventLoop::quit);
+
+  timeout.start(std::min(TILE_DOWNLOAD_WAIT_MS, remainingMs));
+  eventLoop.exec();
+  downloadWaitMs += timer.elapsed();
+
+  if(downloadWaitMs >= TOTAL_DOWNLOAD_WAIT_MS)
+    qWarning() << Q_FUNC_INFO << "Download time exceeded. Ignoring missing map tiles for remaining tiles.";
+
+  return tileWidget.getPixmap(tileWidgetSize, tileWidgetSize).toImage();
+}
+
+bool MapTileRenderer::renderBands(const std::function<void(QImage& band, int y)>& bandFunc)
+{
+  int columns = (size.width() + TILE_SIZE - 1) / TILE_SIZE;
+  int rows = (size.height() + TILE_SIZE - 1) / TILE_SIZE;
+  int numTiles = columns * rows;
+
+  qDebug() << Q_FUNC_INFO << "columns" << columns << "rows" << rows;
+
+  QProgressDialog progress(tr("Rendering map image ..."), tr("&Cancel"), 0, numTiles, parent);
+  progress.setWindowModality(Qt::WindowModal);
+  progress.setMinimumDuration(0);
+  progress.show();
+  progressDialog = &progress;
+
+  // Avoid any interaction with the source map while the event loop is running
+  bool sourceEnabled = source.isEnabled();
+  source.setEnabled(false);
+  QApplication::processEvents();
+
+  // Create a single map widget clone used for all tiles
+  MapPaintWidget tileWidget(parent, false /* no real widget - hidden */);
+  tileWidget.setActive(); // Activate painting
+  tileWidget.setKeepWorldRect(false); // Position is set explicitly for each tile
+  tileWidget.setAvoidBlurredMap(false); // Would change radius
+  tileWidget.setAdjustOnResize(false);
+  tileWidget.copySettings(source);
+
+  // Resize before setting radius and center
+  int tileWidgetSize = TILE_SIZE + 2 * TILE_MARGIN;
+  tileWidget.resize(tileWidgetSize, tileWidgetSize);
+  tileWidget.setRadius(radius);
+
+  QElapsedTimer timer;
+  timer.start();
+  downloadWaitMs = 0;
+
+  bool canceled = false;
+  try
+  {
+    for(int row = 0; row < rows && !canceled; row++)
+    {
+      int y = row * TILE_SIZE;
+      QImage band(size.width(), std::min(TILE_SIZE, size.height() - y), QImage::Format_RGB888);
+      band.fill(Qt::white);
+
+      QPainter painter(&band);
+      for(int col = 0; col < columns; col++)
+      {
+        int tileIndex = row * columns + col;
+        progress.setLabelText(tr("Rendering map image tile %L1 of %L2 ...").arg(tileIndex + 1).arg(numTiles));
+        progress.setValue(tileIndex);
+        QApplication::processEvents();
+        if(progress.wasCanceled())
+        {
+          canceled = true;
+          break;
+        }
+
+        // Center of tile in image coordinates
+        int x = col * TILE_SIZE;
+        QImage tile = renderTile(tileWidget, x + TILE_SIZE / 2, y + TILE_SIZE / 2);
+
+        // Cut off margin - parts outside of the band are clipped
+        painter.drawImage(QPoint(x, 0), tile, QRect(TILE_MARGIN, TILE_MARGIN, TILE_SIZE, TILE_SIZE));
+      }
+      painter.end();
+
+      if(!canceled)
+      {
+        // Add watermark to the last bands - parts outside of a band are clipped
+        if(y + band.height() + TILE_SIZE >= size.height())
+          PrintSupport::drawWatermark(QPoint(0, size.height() - y), &band);
+
+        bandFunc(band, y);
+      }
+    }
+  }
+  catch(...)
+  {
+    progressDialog = nullptr;
+    source.setEnabled(sourceEnabled);
+    throw;
+  }
+  progressDialog = nullptr;
+  source.setEnabled(sourceEnabled);
+
+  progress.setValue(numTiles);
+
+  qDebug() << Q_FUNC_INFO << "canceled" << canceled << "elapsed" << timer.elapsed() << "ms"
+           << "download wait" << downloadWaitMs << "ms";
+  return !canceled;
+}
+
+bool MapTileRenderer::renderToImage(QImage& image)
+{
+  image = QImage(size, QImage::Format_RGB888);
+  if(image.isNull())
+    throw atools::Exception(tr("Cannot allocate image with size %1 x %2.").arg(size.width()).arg(size.height()));
+
+  QPainter painter(&image);
+  return renderBands([&painter](QImage& band, int y) -> void {
+    painter.drawImage(QPoint(0, y), band);
+  });
+}
+
+bool MapTileRenderer::renderToBmp(const QString& filename)
+{
+  // Rows are padded to four bytes which is the same as the QImage scanline alignment
+  qint64 rowSize = (size.width() * 3LL + 3LL) / 4LL * 4LL;
+  qint64 imageSize = rowSize * size.height();
+  const qint64 HEADER_SIZE = 14 + 40;
+
+  if(imageSize + HEADER_SIZE > std::numeric_limits<quint32>::max())
+    throw atools::Exception(tr("Image with size %1 x %2 is too large for a BMP file.").
+                            arg(size.width()).arg(size.height()));
+
+  QFile file(filename);
+  if(!file.open(QIODevice::WriteOnly))
+    throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2").arg(filename).arg(file.errorString()));
+
+  QDataStream stream(&file);
+  stream.setByteOrder(QDataStream::LittleEndian);
+
+  // File header ============================
+  stream.writeRawData("BM", 2);
+  stream << static_cast<quint32>(HEADER_SIZE + imageSize) << static_cast<quint16>(0) << static_cast<quint16>(0)
+         << static_cast<quint32>(HEADER_SIZE);
+
+  // BITMAPINFOHEADER - negative height for top-down row order to allow writing bands in order ==========
+  stream << static_cast<quint32>(40) << static_cast<qint32>(size.width()) << static_cast<qint32>(-size.height())
+         << static_cast<quint16>(1) << static_cast<quint16>(24) << static_cast<quint32>(0) /* BI_RGB */
+         << static_cast<quint32>(imageSize)
+         << static_cast<qint32>(2835) << static_cast<qint32>(2835) /* 72 DPI */
+         << static_cast<quint32>(0) << static_cast<quint32>(0);
+
+  bool retval = renderBands([&stream, rowSize](QImage& band, int) -> void {
+    // BMP uses BGR order
+    QImage bgr = band.rgbSwapped();
+    for(int line = 0; line < bgr.height(); line++)
+      stream.writeRawData(reinterpret_cast<const char *>(bgr.constScanLine(line)), static_cast<int>(rowSize));
+  });
+
+  if(stream.status() != QDataStream::Ok || file.error() != QFileDevice::NoError)
+    throw atools::Exception(tr("Cannot write file \"%1\". Reason: %2").arg(filename).arg(file.errorString()));
+
+  file.close();
+
+  if(!retval)
+    // Canceled - remove incomplete file
+    file.remove();
+
+  return retval;
+}
+
+/* Write a PNG chunk with length, type, data and CRC */
+static void writePngChunk(QDataStream& stream, const char *type, const char *data, int length)
+{
+  stream << static_cast<quint32>(length);
+  stream.writeRawData(type, 4);
+
+  quint32 crc = static_cast<quint32>(crc32(0L, reinterpret_cast<const Bytef *>(type), 4));
+  if(length > 0)
+  {
+    stream.writeRawData(data, length);
+    crc = static_cast<quint32>(crc32(crc, reinterpret_cast<const Bytef *>(data), static_cast<uInt>(length)));
+  }
+  stream << crc;
+}
+
+bool MapTileRenderer::renderToPng(const QString& filename)
+{
+  QFile file(filename);
+  if(!file.open(QIODevice::WriteOnly))
+    throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2").arg(filename).arg(file.errorString()));
+
+  // PNG uses big endian which is the default for the stream
+  QDataStream stream(&file);
+  stream.writeRawData("\x89PNG\r\n\x1a\n", 8);
+
+  // Header with 8 bit RGB, deflate, no filter and no interlace ============================
+  QByteArray header;
+  QDataStream headerStream(&header, QIODevice::WriteOnly);
+  headerStream << static_cast<quint32>(size.width()) << static_cast<quint32>(size.height())
+               << static_cast<quint8>(8) << static_cast<quint8>(2)
+               << static_cast<quint8>(0) << static_cast<quint8>(0) << static_cast<quint8>(0);
+  writePngChunk(stream, "IHDR", header.constData(), header.size());
+
+  z_stream zstream;
+  std::memset(&zstream, 0, sizeof(zstream));
+  if(deflateInit(&zstream, Z_DEFAULT_COMPRESSION) != Z_OK)
+    throw atools::Exception(tr("Cannot initialize compression for file \"%1\".").arg(filename));
+
+  QByteArray buffer(PNG_CHUNK_SIZE, '\0');
+  zstream.next_out = reinterpret_cast<Bytef *>(buffer.data());
+  zstream.avail_out = static_cast<uInt>(buffer.size());
+
+  // Compress data and write an IDAT chunk each time the buffer is full or the stream is finished
+  auto compress = [&zstream, &buffer, &stream](const uchar *data, int length, int flush) -> void {
+    zstream.next_in = const_cast<Bytef *>(data);
+    zstream.avail_in = static_cast<uInt>(length);
+
+    int result = Z_OK;
+    do
+    {
+      result = deflate(&zstream, flush);
+      if(result == Z_STREAM_ERROR)
+        throw atools::Exception(tr("Error compressing PNG data."));
+
+      if(zstream.avail_out == 0 || result == Z_STREAM_END)
+      {
+        writePngChunk(stream, "IDAT", buffer.constData(), buffer.size() - static_cast<int>(zstream.avail_out));
+        zstream.next_out = reinterpret_cast<Bytef *>(buffer.data());
+        zstream.avail_out = static_cast<uInt>(buffer.size());
+      }
+    } while(zstream.avail_in > 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+  };
+
+  bool retval = false;
+  try
+  {
+    retval = renderBands([&compress](QImage& band, int) -> void {
+      // Each row starts with filter type none
+      const uchar filter = 0;
+      int lineSize = band.width() * 3;
+      for(int line = 0; line < band.height(); line++)
+      {
+        compress(&filter, 1, Z_NO_FLUSH);
+        compress(band.constScanLine(line), lineSize, Z_NO_FLUSH);
+      }
+    });
+
+    if(retval)
+    {
+      compress(nullptr, 0, Z_FINISH);
+      writePngChunk(stream, "IEND", nullptr, 0);
+    }
+  }
+  catch(...)
+  {
+    deflateEnd(&zstream);
+    throw;
+  }
+  deflateEnd(&zstream);
+
+  if(stream.status() != QDataStream::Ok || file.error() != QFileDevice::NoError)
+    throw atools::Exception(tr("Cannot write file \"%1\". Reason: %2").arg(filename).arg(file.errorString()));
+
+  file.close();
+
+  if(!retval)
+    // Canceled - remove incomplete file
+    file.remove();
+
+  return retval;
+}
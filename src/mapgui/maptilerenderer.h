@@ -0,0 +1,113 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_MAPTILERENDERER_H
+#define LNM_MAPTILERENDERER_H
+
+#include "geo/pos.h"
+
+#include <QCoreApplication>
+#include <QSize>
+
+#include <functional>
+
+class MapPaintWidget;
+class QImage;
+class QProgressDialog;
+class QWidget;
+
+/*
+ * Renders a map image of arbitrary size in tiles using a small hidden map paint widget.
+ *
+ * The full image shows the same area as the source widget scaled to the requested size. Tiles are rendered
+ * sequentially into a band of one tile row which is then either copied into the resulting image or streamed to a
+ * file. Memory usage is therefore limited to one band and one tile when writing BMP or PNG files.
+ *
+ * Only the Mercator projection is supported since tile positions are calculated using the projection formula.
+ * All methods have to be called from the main thread and show a modal progress dialog which allows to cancel.
+ * Input to the source widget is disabled while rendering.
+ */
+class MapTileRenderer
+{
+  Q_DECLARE_TR_FUNCTIONS(MapTileRenderer)
+
+public:
+  MapTileRenderer(QWidget *parentWidget, MapPaintWidget& sourceWidget, const QSize& imageSize);
+  ~MapTileRenderer();
+
+  MapTileRenderer(const MapTileRenderer& other) = delete;
+  MapTileRenderer& operator=(const MapTileRenderer& other) = delete;
+
+  /* true if the image is big enough to be rendered in tiles and the projection of source allows tiling */
+  static bool isTiledRendering(const MapPaintWidget& sourceWidget, const QSize& imageSize);
+
+  /* Render the whole image in tiles and add the watermark. Returns false if canceled by user. */
+  bool renderToImage(QImage& image);
+
+  /* Render in tiles and write each band directly into an uncompressed 24 bit BMP file.
+   * Returns false if canceled by user. Throws atools::Exception on IO errors. */
+  bool renderToBmp(const QString& filename);
+
+  /* Render in tiles and compress each band directly into a 24 bit PNG file.
+   * Returns false if canceled by user. Throws atools::Exception on IO errors. */
+  bool renderToPng(const QString& filename);
+
+  /* Create json document with coordinates for AviTab configuration. Returns empty string if the
+   * image corners are not valid. */
+  QString createAvitabJson() const;
+
+  /* Tiles are rendered with this size in pixel plus margin */
+  static constexpr int TILE_SIZE = 1024;
+
+  /* Margin on each side of a tile which is cut off to avoid clipped symbols and labels at tile borders */
+  static constexpr int TILE_MARGIN = 128;
+
+  /* Images with more pixels than this are rendered in tiles */
+  static constexpr qint64 MAX_SINGLE_PASS_PIXELS = 4096LL * 4096LL;
+
+private:
+  /* Render all tile rows and call the function for each band. y is the top position of the band in the image.
+   * Returns false if canceled. */
+  bool renderBands(const std::function<void(QImage& band, int y)>& bandFunc);
+
+  /* Render a tile with the center at the given image position. Renders a second time only if map tiles
+   * had to be downloaded. Waits in an event loop until downloads are done, the render status is complete or the
+   * user cancels. Waiting for downloads is limited per tile and for the whole image. */
+  QImage renderTile(MapPaintWidget& tileWidget, int centerX, int centerY);
+
+  /* Convert image pixel coordinates to world coordinates using the Mercator projection */
+  atools::geo::Pos imageToWorld(double x, double y) const;
+
+  QWidget *parent;
+  MapPaintWidget& source;
+
+  /* Progress dialog of renderBands() or null */
+  QProgressDialog *progressDialog = nullptr;
+  QSize size;
+
+  /* Center of the image in radians and Mercator y value */
+  double centerLonRad = 0., centerLatRad = 0., centerMercY = 0.;
+
+  /* Radius of the globe in pixel for the full image and the resulting conversion factor */
+  int radius = 0;
+  double rad2Pixel = 1.;
+
+  /* Time spent waiting for map tile downloads in all tiles so far */
+  qint64 downloadWaitMs = 0;
+};
+
+#endif // LNM_MAPTILERENDERER_H
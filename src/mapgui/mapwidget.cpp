@@ -45,6 +45,7 @@
 #include "mapgui/mapdetailhandler.h"
 #include "mapgui/maplayersettings.h"
 #include "mapgui/mapmarkhandler.h"
+#include "mapgui/mapprefetcher.h"
 #include "mapgui/mapscreenindex.h"
 #include "mapgui/mapthemehandler.h"
 #include "mapgui/mapthemehandler.h"
@@ -160,6 +161,9 @@ const int FUEL_ON_OFF_TIMEOUT_MS = 1000;
 /* Update rate on tooltip for bearing display */
 const int MAX_SIM_UPDATE_TOOLTIP_MS = 500;
 
+/* Default frame rate for AI movement between simulator packets */
+const int AI_INTERPOLATION_FPS = 10;
+
 /* Disable center waypoint and aircraft if distance to flight plan is larger */
 const float MAX_FLIGHT_PLAN_DIST_FOR_CENTER_NM = 50.f;
 
@@ -213,6 +217,12 @@ MapWidget::MapWidget(MainWindow *parent)
   fuelOnOffTimer.setSingleShot(true);
   connect(&fuelOnOffTimer, &QTimer::timeout, this, &MapWidget::fuelOnOffTimeout);
 
+  // Zero disables interpolation repaints
+  int aiFps = atools::settings::Settings::instance().getAndStoreValue(lnm::SETTINGS_MAPQUERY % "AiInterpolationFps",
+                                                                      AI_INTERPOLATION_FPS).toInt();
+  aiInterpolationTimer.setInterval(aiFps > 0 ? 1000 / std::min(aiFps, 30) : 0);
+  connect(&aiInterpolationTimer, &QTimer::timeout, this, &MapWidget::aiInterpolationTimeout);
+
   resetPaintForDragTimer.setSingleShot(true);
   resetPaintForDragTimer.setInterval(200);
   connect(&resetPaintForDragTimer, &QTimer::timeout, this, &MapWidget::resetPaintForDrag);
@@ -229,6 +239,10 @@ MapWidget::MapWidget(MainWindow *parent)
   mapOverlays.insert("overviewmap", mainWindow->getUi()->actionMapOverlayOverview);
 
   mapVisible = new MapVisible(paintLayer);
+  mapPrefetcher = new MapPrefetcher(this);
+
+  // Queued to run in the gap after the map was drawn when following the aircraft
+  connect(this, &MapWidget::simDataPainted, mapPrefetcher, &MapPrefetcher::simDataPainted, Qt::QueuedConnection);
 }
 
 MapWidget::~MapWidget()
@@ -237,6 +251,7 @@ MapWidget::~MapWidget()
   elevationDisplayTimer.stop();
   takeoffLandingTimer.stop();
   fuelOnOffTimer.stop();
+  aiInterpolationTimer.stop();
 
   qDebug() << Q_FUNC_INFO << "removeEventFilter";
   removeEventFilter(this);
@@ -244,6 +259,7 @@ MapWidget::~MapWidget()
   ATOOLS_DELETE_LOG(jumpBack);
   ATOOLS_DELETE_LOG(mapTooltip);
   ATOOLS_DELETE_LOG(mapVisible);
+  ATOOLS_DELETE_LOG(mapPrefetcher);
   ATOOLS_DELETE_LOG(pushButtonExitFullscreen);
   ATOOLS_DELETE_LOG(takeoffLandingLastAircraft);
   ATOOLS_DELETE_LOG(mapSearchResultTooltip);
@@ -2324,6 +2340,30 @@ void MapWidget::simDataCalcTakeoffLanding(const atools::fs::sc::SimConnectUserAi
   }
 }
 
+void MapWidget::paintEvent(QPaintEvent *paintEvent)
+{
+  MapPaintWidget::paintEvent(paintEvent);
+
+  if(simDataPaintPending)
+  {
+    simDataPaintPending = false;
+    emit simDataPainted();
+  }
+}
+
+void MapWidget::aiInterpolationTimeout()
+{
+  if(!NavApp::isConnected() || !isVisible())
+  {
+    aiInterpolationTimer.stop();
+    return;
+  }
+
+  // Do not interfere with scrolling, zooming or an open context menu
+  if(viewContext() == Marble::Still && !contextMenuActive)
+    update();
+}
+
 void MapWidget::takeoffLandingTimeout()
 {
   const atools::fs::sc::SimConnectUserAircraft aircraft = getScreenIndexConst()->getLastUserAircraft();
@@ -2411,6 +2451,7 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
 
   if(databaseLoadStatus || !aircraft.isValid())
   {
+    aiInterpolationTimer.stop();
     getScreenIndex()->updateLastSimData(atools::fs::sc::SimConnectData());
 
     // Update action states if needed
@@ -2536,6 +2577,15 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
       }
     }
 
+    // Repaint between packets only if moving AI is visible
+    if(aiVisible && aiInterpolationTimer.interval() > 0 && getScreenIndexConst()->hasMovingAiAircraft())
+    {
+      if(!aiInterpolationTimer.isActive())
+        aiInterpolationTimer.start();
+    }
+    else
+      aiInterpolationTimer.stop();
+
     // Check if position has changed significantly
     bool posHasChanged = !lastAircraft.isValid() || // No previous position
                          aircraftPointDiff.manhattanLength() >= deltas.manhattanLengthDelta; // Screen position has changed
@@ -2799,9 +2849,19 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
     // touchdownDetected = false;
 
     if((dataHasChanged || aiVisible) && !contextMenuActive)
+    {
       // Not scrolled or zoomed but needs a redraw
       update();
 
+      // Let the connect client hold back further packets until this one is drawn
+      // Widget gets no paint events if hidden or minimized
+      if(isVisible() && !visibleRegion().isEmpty())
+      {
+        simDataPaintPending = true;
+        emit simDataPaintScheduled();
+      }
+    }
+
     if(!updatesEnabled())
       setUpdatesEnabled(true);
   } // if(now - lastSimUpdateMs > deltas.timeDeltaMs)
@@ -28,6 +28,7 @@
 
 class JumpBack;
 class MainWindow;
+class MapPrefetcher;
 class MapTooltip;
 class MapVisible;
 class QContextMenuEvent;
@@ -246,7 +247,19 @@ public:
 
   void showGridConfiguration();
 
+  /* Loads map data and tiles ahead along the flight plan in idle time */
+  MapPrefetcher *getMapPrefetcher() const
+  {
+    return mapPrefetcher;
+  }
+
 signals:
+  /* Map redraw was requested for a new simulator data packet in simDataChanged() */
+  void simDataPaintScheduled();
+
+  /* Map was redrawn after simDataPaintScheduled() */
+  void simDataPainted();
+
   /* Emitted when connection is established and user aircraft turned from invalid to valid */
   void userAircraftValidChanged();
 
@@ -343,6 +356,9 @@ private:
 
   virtual void resizeEvent(QResizeEvent *event) override;
 
+  /* Emits simDataPainted() if the paint was requested by simDataChanged() */
+  virtual void paintEvent(QPaintEvent *paintEvent) override;
+
   /* Connect menu actions to overlays */
   void connectOverlayMenus();
 
@@ -386,6 +402,9 @@ private:
   void takeoffLandingTimeout();
   void fuelOnOffTimeout();
 
+  /* Repaint to move AI aircraft and ships smoothly between simulator packets */
+  void aiInterpolationTimeout();
+
   void simDataCalcTakeoffLanding(const atools::fs::sc::SimConnectUserAircraft& aircraft,
                                  const atools::fs::sc::SimConnectUserAircraft& last);
   void simDataCalcFuelOnOff(const atools::fs::sc::SimConnectUserAircraft& aircraft,
@@ -499,6 +518,12 @@ private:
    * Calls MapWidget::takeoffLandingTimeout()  */
   QTimer takeoffLandingTimer, fuelOnOffTimer;
 
+  /* Redraw requested by simDataChanged() is pending */
+  bool simDataPaintPending = false;
+
+  /* Repaints map with limited frame rate while moving AI is visible. Calls MapWidget::aiInterpolationTimeout() */
+  QTimer aiInterpolationTimer;
+
   /* Flown distance from takeoff event */
   double takeoffLandingDistanceNm = 0.;
 
@@ -517,6 +542,7 @@ private:
   MainWindow *mainWindow;
 
   MapVisible *mapVisible;
+  MapPrefetcher *mapPrefetcher;
 
   /* Used for distance calculation */
   atools::fs::sc::SimConnectUserAircraft *takeoffLandingLastAircraft;
@@ -29,6 +29,7 @@
 #include "util/paintercontextsaver.h"
 #include "common/unit.h"
 #include "common/textplacement.h"
+#include "mappainter/paintarena.h"
 
 #include <marble/GeoDataLineString.h>
 #include <marble/GeoDataLinearRing.h>
@@ -42,34 +43,12 @@ using namespace Marble;
 using namespace atools::geo;
 using atools::roundToInt;
 
-PaintAirportType::PaintAirportType(const map::MapAirport& ap, float x, float y)
-  : airport(new map::MapAirport(ap)), point(x, y)
+PaintAirportType::PaintAirportType(PaintArena *arena, const map::MapAirport& ap, float x, float y)
+  : airport(arena->create<map::MapAirport>(ap)), point(x, y)
 {
 
 }
 
-PaintAirportType::~PaintAirportType()
-{
-  delete airport;
-}
-
-PaintAirportType& PaintAirportType::operator=(const PaintAirportType& other)
-{
-  if(airport != nullptr && other.airport != nullptr)
-    *airport = *other.airport;
-  else if(airport == nullptr && other.airport != nullptr)
-    airport = new map::MapAirport(*other.airport);
-  else if(airport != nullptr && other.airport == nullptr)
-  {
-    delete airport;
-    airport = nullptr;
-  }
-  // else both nullptr
-
-  point = other.point;
-  return *this;
-}
-
 void PaintContext::szFont(float scale) const
 {
   mapcolors::scaleFont(painter, scale, &defaultFont);
@@ -142,6 +121,7 @@ MapPainter::MapPainter(MapPaintWidget *parentMapWidget, MapScale *mapScale, Pain
 {
   airportQuery = NavApp::getAirportQuerySim();
   symbolPainter = new SymbolPainter();
+  symbolPainter->setTextCollisionGrid(&context->textCollisionGrid);
 }
 
 MapPainter::~MapPainter()
@@ -20,6 +20,7 @@
 
 #include "common/coordinateconverter.h"
 #include "common/mapflags.h"
+#include "common/textcollisiongrid.h"
 #include "options/optiondata.h"
 #include "geo/rect.h"
 
@@ -45,6 +46,7 @@ class MapPaintWidget;
 class MapQuery;
 class MapScale;
 class MapWidget;
+class PaintArena;
 class SymbolPainter;
 class WaypointTrackQuery;
 class Route;
@@ -82,6 +84,9 @@ struct PaintContext
   /* Airports drawn having parking spots which require tooltips and more */
   QSet<int> *shownDetailAirportIds;
 
+  /* Allocator for temporary objects which are needed only while drawing this frame. Cleared after rendering. */
+  PaintArena *arena;
+
   opts::MapScrollDetail mapScrollDetail; /* Option that indicates the detail level when drawFast is true */
   QFont defaultFont /* Default widget font */;
   float distanceNm; /* Zoom distance in NM */
@@ -112,6 +117,9 @@ struct PaintContext
   QVector<map::MapRef> *routeDrawnNavaids; /* All navaids drawn for route and procedures. Points to vector in MapScreenIndex */
   int currentDistanceMarkerId = -1;
 
+  /* Occupied label space for this frame. Route labels are drawn last and always but reserve space too. */
+  TextCollisionGrid textCollisionGrid;
+
   /* Text sizes and line thickness in percent / 100 as set in options dialog */
   float textSizeAircraftAi = 1.f;
   float symbolSizeNavaid = 1.f;
@@ -269,22 +277,13 @@ struct PaintContext
 /* Used to collect airports for drawing. Needs to copy airport since it might be removed from the cache. */
 struct PaintAirportType
 {
-  PaintAirportType(const map::MapAirport& ap, float x, float y);
+  /* Copies the airport into the arena. Copying this struct copies the pointer only. */
+  PaintAirportType(PaintArena *arena, const map::MapAirport& ap, float x, float y);
   PaintAirportType()
   {
   }
 
-  ~PaintAirportType();
-
-  PaintAirportType(const PaintAirportType& other)
-  {
-    this->operator=(other);
-
-  }
-
-  PaintAirportType& operator=(const PaintAirportType& other);
-
-  map::MapAirport *airport = nullptr;
+  const map::MapAirport *airport = nullptr; /* Valid until the end of the frame */
   QPointF point;
 };
 
@@ -26,6 +26,8 @@
 #include "settings/settings.h"
 #include "util/paintercontextsaver.h"
 
+#include <QDateTime>
+
 #include <marble/GeoPainter.h>
 #include <marble/ViewportParams.h>
 
@@ -79,9 +81,11 @@ void MapPainterAircraft::render()
           allAircraft.append(&ac);
       }
 
-      // Get all AI and online shadow aircraft ======================================
-      for(const SimConnectAircraft& ac : mapPaintWidget->getAiAircraft())
+      // Get all AI and online shadow aircraft in the viewport ======================================
+      for(const SimConnectAircraft *aircraft : mapPaintWidget->getAiAircraft(context->viewportRect))
       {
+        const SimConnectAircraft& ac = *aircraft;
+
         // Skip boats
         if(ac.isAnyBoat())
           continue;
@@ -108,12 +112,15 @@ void MapPainterAircraft::render()
       QVector<AiDistType> aiSorted;
       bool hidden = false;
       float x, y;
+      qint64 now = QDateTime::currentMSecsSinceEpoch();
       for(const SimConnectAircraft *ac : allAircraft)
       {
-        if(wToSBuf(ac->getPosition(), x, y, MARGINS, &hidden))
+        // Use position extrapolated from last simulator packet for smooth movement
+        atools::geo::Pos pos = mapPaintWidget->getAiAircraftPos(*ac, now);
+        if(wToSBuf(pos, x, y, MARGINS, &hidden))
         {
           if(!hidden)
-            aiSorted.append({ac, x, y, userPos.distanceMeterTo(ac->getPosition()),
+            aiSorted.append({ac, x, y, userPos.distanceMeterTo(pos),
                              std::abs(userPos.getAltitude() - ac->getActualAltitudeFt())});
         }
       }
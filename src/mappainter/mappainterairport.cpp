@@ -51,7 +51,6 @@ static const int RUNWAY_TEXT_FONT_SIZE = 16;
 static const int RUNWAY_NUMBER_FONT_SIZE = 20;
 static const int RUNWAY_NUMBER_SMALL_FONT_SIZE = 12;
 static const int TAXIWAY_TEXT_MIN_LENGTH = 15;
-static const int RUNWAY_OVERVIEW_MIN_LENGTH_FEET = 8000;
 static const float AIRPORT_DIAGRAM_BACKGROUND_METER = 200.f;
 
 using namespace Marble;
@@ -214,7 +213,7 @@ void MapPainterAirport::collectVisibleAirports(QVector<PaintAirportType>& visibl
 
         if(visibleOnMap)
         {
-          visibleAirports.append(PaintAirportType(airport, x, y));
+          visibleAirports.append(PaintAirportType(context->arena, airport, x, y));
           visibleAirportIds.insert(airport.ident);
         }
       }
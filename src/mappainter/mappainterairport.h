@@ -48,6 +48,9 @@ public:
   /* Needs call of collectVisibleAirports() before */
   virtual void render() override;
 
+  /* Runways are drawn in overview for airports having a runway at least this long */
+  static constexpr int RUNWAY_OVERVIEW_MIN_LENGTH_FEET = 8000;
+
 private:
   /* Pre-calculates visible airports for render() and fills visibleAirports.
    * visibleAirportIds gets all idents of shown airports */
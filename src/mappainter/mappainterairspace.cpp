@@ -25,6 +25,8 @@
 #include "airspace/airspacecontroller.h"
 #include "app/navapp.h"
 #include "mapgui/mapscale.h"
+#include "mapgui/mappaintwidget.h"
+#include "mapgui/mapscreenindex.h"
 #include "util/polygontools.h"
 
 #include <marble/GeoDataLineString.h>
@@ -88,6 +90,7 @@ void MapPainterAirspace::render()
   QVector<DrawAirspace> visibleAirspaces;
   if(!airspaces.isEmpty())
   {
+    MapScreenIndex *screenIndex = mapPaintWidget->getScreenIndex();
     Marble::GeoPainter *painter = context->painter;
 
     painter->setBackgroundMode(Qt::TransparentMode);
@@ -130,6 +133,9 @@ void MapPainterAirspace::render()
           // Add for text placement later
           visibleAirspaces.append(DrawAirspace(airspace, polygons));
 
+          // Publish screen geometry for tooltips and clicks to avoid projecting again
+          screenIndex->addPaintedAirspace(airspace->combinedId(), polygons);
+
 #ifdef DEBUG_DUMP_AIRSPACE
           static QSet<int> airspacesDumped;
 
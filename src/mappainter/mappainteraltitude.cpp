@@ -23,30 +23,84 @@
 #include "fs/common/morareader.h"
 #include "geo/line.h"
 #include "mapgui/maplayer.h"
+#include "mapgui/mappaintwidget.h"
 #include "mapgui/mapscale.h"
 #include "util/paintercontextsaver.h"
 
 #include <QElapsedTimer>
+#include <QPainter>
+#include <QPixmap>
 
 #include <marble/GeoDataLineString.h>
 #include <marble/GeoPainter.h>
 
+#include <cmath>
+
 using namespace Marble;
 using namespace atools::geo;
+using atools::fs::common::MoraReader;
+
+uint qHash(const MapPainterAltitude::TileKey& key)
+{
+  return static_cast<uint>(key.radius) ^ (static_cast<uint>(key.x) << 16) ^ static_cast<uint>(key.y);
+}
 
 MapPainterAltitude::MapPainterAltitude(MapPaintWidget *mapWidget, MapScale *mapScale, PaintContext *paintContext)
   : MapPainter(mapWidget, mapScale, paintContext)
 {
+  tileCache.setMaxCost(CACHE_SIZE_KB);
 }
 
 MapPainterAltitude::~MapPainterAltitude()
 {
 }
 
-void MapPainterAltitude::render()
+void MapPainterAltitude::clearCache()
+{
+  tileCache.clear();
+}
+
+bool MapPainterAltitude::isValidMora(int moraFt100)
+{
+  return moraFt100 > 10 && moraFt100 != MoraReader::OCEAN && moraFt100 != MoraReader::UNKNOWN && moraFt100 != MoraReader::ERROR;
+}
+
+MapPainterAltitude::TileStyle MapPainterAltitude::currentStyle() const
 {
-  using atools::fs::common::MoraReader;
+  TileStyle style;
+
+  // Use width and style from pen but override transparency
+  QColor gridCol = context->darkMap ? mapcolors::minimumAltitudeGridPenDark.color() : mapcolors::minimumAltitudeGridPen.color();
+  gridCol.setAlphaF(1. - context->transparencyMora);
+  style.gridPen = context->darkMap ? mapcolors::minimumAltitudeGridPenDark : mapcolors::minimumAltitudeGridPen;
+  style.gridPen.setColor(gridCol);
 
+  // Do not use transparency but override from options
+  style.textColor = context->darkMap ? mapcolors::minimumAltitudeNumberColorDark : mapcolors::minimumAltitudeNumberColor;
+  style.textColor.setAlphaF(1. - context->transparencyMora);
+
+  style.font = context->painter->font();
+  style.font.setItalic(true);
+  style.textSize = context->textSizeMora;
+  style.pixelRatio = context->painter->device()->devicePixelRatioF();
+  return style;
+}
+
+bool MapPainterAltitude::fontSizes(float cellWidth, float& fontSize) const
+{
+  if(cellWidth > 20.f)
+  {
+    // Adjust minimum and maximum font height based on rectangle width
+    cellWidth = std::max(cellWidth * 0.6f, 25.f);
+    cellWidth = std::min(cellWidth * 0.6f, 150.f);
+    fontSize = cellWidth * context->textSizeMora;
+    return true;
+  }
+  return false;
+}
+
+void MapPainterAltitude::render()
+{
   if(!context->objectDisplayTypes.testFlag(map::MORA))
     return;
 
@@ -57,134 +111,307 @@ void MapPainterAltitude::render()
     {
       atools::util::PainterContextSaver paintContextSaver(context->painter);
 
-      // Use width and style from pen but override transparency
-      QColor gridCol = context->darkMap ? mapcolors::minimumAltitudeGridPenDark.color() : mapcolors::minimumAltitudeGridPen.color();
-      gridCol.setAlphaF(1. - context->transparencyMora);
-      QPen pen = context->darkMap ? mapcolors::minimumAltitudeGridPenDark : mapcolors::minimumAltitudeGridPen;
-      pen.setColor(gridCol);
-      context->painter->setPen(pen);
-
-      // Get covered one degree coordinate rectangles
-      const GeoDataLatLonBox& curBox = context->viewport->viewLatLonAltBox();
-      int west = static_cast<int>(curBox.west(DEG));
-      int east = static_cast<int>(curBox.east(DEG));
-      int north = static_cast<int>(curBox.north(DEG));
-      int south = static_cast<int>(curBox.south(DEG));
-
-      // Split at anit-meridian if needed
-      QVector<std::pair<int, int> > ranges;
-      if(west <= east)
-        ranges.append(std::make_pair(west - 1, east));
+      if(mapPaintWidget->projection() == Marble::Mercator)
+        renderTiles(moraReader);
       else
+        renderDirect(moraReader);
+    } // if(moraReader->isDataAvailable())
+  } // if(context->mapLayer->isMinimumAltitude())
+}
+
+void MapPainterAltitude::renderTiles(MoraReader *moraReader)
+{
+  // Clear all tiles if colors, font or options were changed
+  TileStyle style = currentStyle();
+  if(style != tileStyle)
+  {
+    tileCache.clear();
+    tileStyle = style;
+  }
+
+  // Same as in Marble MercatorProjection
+  int radius = context->viewport->radius();
+  double rad2Pixel = 2. * radius / M_PI;
+
+  // Get offset from Mercator pixel coordinates to screen by using the visible top left corner as reference
+  const GeoDataLatLonBox& curBox = context->viewport->viewLatLonAltBox();
+  double refLonX = curBox.west(DEG), refLatY = curBox.north(DEG);
+  bool visibleDummy;
+  QPointF refScreen = wToSF(GeoDataCoordinates(refLonX, refLatY, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
+  QPointF offset = refScreen - QPointF(toRadians(refLonX) * rad2Pixel, -std::atanh(std::sin(toRadians(refLatY))) * rad2Pixel);
+
+  // Mercator world covers -2 * radius to 2 * radius vertically
+  double worldTop = std::max(-offset.y(), -2. * radius), worldBottom = std::min(context->viewport->height() - offset.y(), 2. * radius);
+  int tileXStart = static_cast<int>(std::floor(-offset.x() / TILE_SIZE));
+  int tileXEnd = static_cast<int>(std::floor((context->viewport->width() - offset.x()) / TILE_SIZE));
+  int tileYStart = static_cast<int>(std::floor(worldTop / TILE_SIZE));
+  int tileYEnd = static_cast<int>(std::floor(worldBottom / TILE_SIZE));
+
+  QVector<TileKey> keys;
+  bool missing = false;
+  for(int tileY = tileYStart; tileY <= tileYEnd; tileY++)
+  {
+    for(int tileX = tileXStart; tileX <= tileXEnd; tileX++)
+    {
+      TileKey key = {radius, tileX, tileY};
+      missing |= !tileCache.contains(key);
+      keys.append(key);
+    }
+  }
+
+  if(missing && context->drawFast)
+  {
+    // Radius changes with every frame while zooming - draw grid only and do not fill the cache with tiles
+    // which are never used again
+    renderDirect(moraReader);
+    return;
+  }
+
+  for(const TileKey& key : qAsConst(keys))
+  {
+    QPixmap *tile = tileCache.object(key);
+    if(tile == nullptr)
+    {
+      tile = createTile(moraReader, key);
+      tileCache.insert(key, tile, std::max(tile->width() * tile->height() * 4 / 1024, 1));
+    }
+
+    // Tiles are transparent where no grid is drawn
+    if(!tile->isNull())
+      context->painter->drawPixmap(QPointF(key.x * TILE_SIZE, key.y * TILE_SIZE) + offset, *tile);
+  }
+}
+
+QPixmap *MapPainterAltitude::createTile(MoraReader *moraReader, const TileKey& key) const
+{
+  double rad2Pixel = 2. * key.radius / M_PI;
+
+  // Conversion from degree to Mercator pixel coordinates and back
+  auto worldX = [rad2Pixel](double lonX) -> double {
+                  return toRadians(lonX) * rad2Pixel;
+                };
+  auto worldY = [rad2Pixel](double latY) -> double {
+                  return -std::atanh(std::sin(toRadians(atools::minmax(-89.9, 89.9, latY)))) * rad2Pixel;
+                };
+  auto lonXDeg = [rad2Pixel](double x) -> double {
+                   return toDegree(x / rad2Pixel);
+                 };
+  auto latYDeg = [rad2Pixel](double y) -> double {
+                   return toDegree(std::atan(std::sinh(-y / rad2Pixel)));
+                 };
+
+  double x0 = key.x * TILE_SIZE, y0 = key.y * TILE_SIZE;
+
+  // Fonts for big thousands and small hundreds numbers - cell width is the same for all latitudes in Mercator
+  float fontSize = 0.f;
+  bool drawText = fontSizes(static_cast<float>(worldX(1.) - worldX(0.)), fontSize);
+  QFont font = tileStyle.font, smallFont = tileStyle.font;
+  if(drawText)
+  {
+    font.setPixelSize(atools::roundToInt(fontSize));
+    smallFont.setPixelSize(std::max(atools::roundToInt(fontSize * .6f), 1));
+  }
+  QFontMetricsF fontmetrics(font), smallFontmetrics(smallFont);
+  drawText &= fontmetrics.height() > 4;
+
+  // Margin around the tile in pixel covering the grid pen and labels which are placed around the cell center.
+  // All cells overlapping the tile extended by the margin are drawn.
+  double margin = tileStyle.gridPen.widthF();
+  if(drawText)
+    margin = std::max(margin, std::max(fontmetrics.width("88") + smallFontmetrics.width("8"), fontmetrics.height()));
+
+  // Covered cells plus the ones having labels overlapping the tile border
+  int west = static_cast<int>(std::floor(lonXDeg(x0 - margin)));
+  int east = static_cast<int>(std::floor(lonXDeg(x0 + TILE_SIZE + margin)));
+  int north = std::min(static_cast<int>(std::ceil(latYDeg(y0 - margin))), 90);
+  int south = std::max(static_cast<int>(std::floor(latYDeg(y0 + TILE_SIZE + margin))), -89);
+
+  // Collect cells ======================================================
+  QVector<QRectF> rects;
+  QVector<QPointF> centers;
+  QVector<int> altitudes;
+  for(int laty = south; laty <= north; laty++)
+  {
+    for(int lonx = west; lonx <= east; lonx++)
+    {
+      // Normalize for tiles beyond the anti-meridian
+      int lonxNorm = ((lonx + 180) % 360 + 360) % 360 - 180;
+      int moraFt100 = moraReader->getMoraFt(lonxNorm, laty);
+      if(isValidMora(moraFt100))
       {
-        ranges.append(std::make_pair(west - 1, 179));
-        ranges.append(std::make_pair(-180, east));
+        QPointF topLeft(worldX(lonx), worldY(laty));
+        rects.append(QRectF(topLeft, QPointF(worldX(lonx + 1.), worldY(laty - 1.))));
+        centers.append(QPointF(worldX(lonx + .5), worldY(laty - .5)));
+        altitudes.append(moraFt100);
       }
+    }
+  }
+
+  QPixmap *tile = new QPixmap;
+  if(rects.isEmpty())
+    // Nothing to draw - keep an empty pixmap in the cache
+    return tile;
+
+  *tile = QPixmap(QSize(TILE_SIZE, TILE_SIZE) * tileStyle.pixelRatio);
+  tile->setDevicePixelRatio(tileStyle.pixelRatio);
+  tile->fill(Qt::transparent);
+
+  QPainter painter(tile);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setRenderHint(QPainter::TextAntialiasing);
+  painter.translate(-x0, -y0);
+
+  // Draw rectangles ================================================================
+  painter.setPen(tileStyle.gridPen);
+  painter.setBrush(Qt::NoBrush);
+  for(const QRectF& rect : qAsConst(rects))
+    painter.drawRect(rect);
+
+  // Draw texts =================================================================
+  if(drawText)
+  {
+    painter.setPen(tileStyle.textColor);
+
+    // Draw big thousands numbers ===============================
+    painter.setFont(font);
+    QVector<QPointF> baseline;
+    for(int i = 0; i < centers.size(); i++)
+    {
+      QString numTxt = QString::number(altitudes.at(i) / 10);
+      qreal w = fontmetrics.width(numTxt);
+      QPointF pt = centers.at(i) + QPointF(-w * 0.7, fontmetrics.height() / 2. - fontmetrics.descent());
+      painter.drawText(pt, numTxt);
+      baseline.append(QPointF(pt.x() + w, pt.y()));
+    }
+
+    // Draw smaller hundreds numbers ==============================
+    painter.setFont(smallFont);
+    for(int i = 0; i < centers.size(); i++)
+    {
+      int alt = altitudes.at(i);
+      QPointF pt = baseline.at(i);
+      pt.setY(pt.y() + smallFontmetrics.ascent() / 3.f);
+      painter.drawText(pt, QString::number(alt - (alt / 10 * 10)));
+    }
+  }
+  return tile;
+}
+
+void MapPainterAltitude::renderDirect(MoraReader *moraReader)
+{
+  TileStyle style = currentStyle();
+  context->painter->setPen(style.gridPen);
+
+  // Get covered one degree coordinate rectangles
+  const GeoDataLatLonBox& curBox = context->viewport->viewLatLonAltBox();
+  int west = static_cast<int>(curBox.west(DEG));
+  int east = static_cast<int>(curBox.east(DEG));
+  int north = static_cast<int>(curBox.north(DEG));
+  int south = static_cast<int>(curBox.south(DEG));
+
+  // Split at anit-meridian if needed
+  QVector<std::pair<int, int> > ranges;
+  if(west <= east)
+    ranges.append(std::make_pair(west - 1, east));
+  else
+  {
+    ranges.append(std::make_pair(west - 1, 179));
+    ranges.append(std::make_pair(-180, east));
+  }
 
-      // Altitude values
-      QVector<int> altitudes;
-      // Minimum rectangle width on screen in pixel
-      float minWidth = std::numeric_limits<float>::max();
-      // Center points for rectangles for text placement
-      QVector<GeoDataCoordinates> centers;
+  // Altitude values
+  QVector<int> altitudes;
+  // Minimum rectangle width on screen in pixel
+  float minWidth = std::numeric_limits<float>::max();
+  // Center points for rectangles for text placement
+  QVector<GeoDataCoordinates> centers;
 
-      // Draw rectangles and collect other values for text placement ================================
-      for(int laty = south; laty <= north + 1; laty++)
+  // Draw rectangles and collect other values for text placement ================================
+  for(int laty = south; laty <= north + 1; laty++)
+  {
+    // Iterate over anti-meridian split
+    for(const std::pair<int, int>& range : ranges)
+    {
+      for(int lonx = range.first; lonx <= range.second; lonx++)
       {
-        // Iterate over anti-meridian split
-        for(const std::pair<int, int>& range : ranges)
+        int moraFt100 = moraReader->getMoraFt(lonx, laty);
+        if(isValidMora(moraFt100))
         {
-          for(int lonx = range.first; lonx <= range.second; lonx++)
+          // Build rectangle
+          float lonxF = static_cast<float>(lonx);
+          float latyF = static_cast<float>(laty);
+          drawLine(context->painter, Line(lonxF, latyF, lonxF + 1.f, latyF));
+          drawLine(context->painter, Line(lonxF + 1.f, latyF, lonxF + 1, latyF - 1.f));
+          drawLine(context->painter, Line(lonxF + 1.f, latyF - 1, lonxF, latyF - 1.f));
+          drawLine(context->painter, Line(lonxF, latyF - 1.f, lonxF, latyF));
+
+          if(!context->drawFast)
           {
-            int moraFt100 = moraReader->getMoraFt(lonx, laty);
-            if(moraFt100 > 10 && moraFt100 != MoraReader::OCEAN && moraFt100 != MoraReader::UNKNOWN &&
-               moraFt100 != MoraReader::ERROR)
-            {
-              // Build rectangle
-              float lonxF = static_cast<float>(lonx);
-              float latyF = static_cast<float>(laty);
-              drawLine(context->painter, Line(lonxF, latyF, lonxF + 1.f, latyF));
-              drawLine(context->painter, Line(lonxF + 1.f, latyF, lonxF + 1, latyF - 1.f));
-              drawLine(context->painter, Line(lonxF + 1.f, latyF - 1, lonxF, latyF - 1.f));
-              drawLine(context->painter, Line(lonxF, latyF - 1.f, lonxF, latyF));
-
-              if(!context->drawFast)
-              {
-                // Calculate rectangle screen width
-                bool visibleDummy;
-                QPointF leftPt = wToSF(GeoDataCoordinates(lonx, laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
-                QPointF rightPt = wToSF(GeoDataCoordinates(lonx + 1., laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
-
-                minWidth = std::min(static_cast<float>(QLineF(leftPt, rightPt).length()), minWidth);
-
-                centers.append(GeoDataCoordinates(lonx + .5, laty - .5, 0, DEG));
-                altitudes.append(moraFt100);
-              }
-            }
-          } // for(int lonx = range.first; lonx <= range.second; lonx++)
-        } // for(const std::pair<int, int>& range : ranges)
-      } // for(int laty = south; laty <= north + 1; laty++)
-
-      // Draw texts =================================================================
-      if(!context->drawFast && minWidth > 20.f)
-      {
-        // Adjust minimum and maximum font height based on rectangle width
-        minWidth = std::max(minWidth * 0.6f, 25.f);
-        minWidth = std::min(minWidth * 0.6f, 150.f);
+            // Calculate rectangle screen width
+            bool visibleDummy;
+            QPointF leftPt = wToSF(GeoDataCoordinates(lonx, laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
+            QPointF rightPt = wToSF(GeoDataCoordinates(lonx + 1., laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
 
-        // Do not use transparency but override from options
-        QColor textCol = context->darkMap ? mapcolors::minimumAltitudeNumberColorDark : mapcolors::minimumAltitudeNumberColor;
-        textCol.setAlphaF(1. - context->transparencyMora);
-        context->painter->setPen(textCol);
+            minWidth = std::min(static_cast<float>(QLineF(leftPt, rightPt).length()), minWidth);
 
-        float fontSize = minWidth * context->textSizeMora;
-        QFont font = context->painter->font();
-        font.setItalic(true);
-        font.setPixelSize(atools::roundToInt(fontSize));
-        context->painter->setFont(font);
+            centers.append(GeoDataCoordinates(lonx + .5, laty - .5, 0, DEG));
+            altitudes.append(moraFt100);
+          }
+        }
+      } // for(int lonx = range.first; lonx <= range.second; lonx++)
+    } // for(const std::pair<int, int>& range : ranges)
+  } // for(int laty = south; laty <= north + 1; laty++)
 
-        QFontMetricsF fontmetrics = context->painter->fontMetrics();
+  // Draw texts =================================================================
+  float fontSize;
+  if(!context->drawFast && fontSizes(minWidth, fontSize))
+  {
+    context->painter->setPen(style.textColor);
+
+    QFont font = style.font;
+    font.setPixelSize(atools::roundToInt(fontSize));
+    context->painter->setFont(font);
+
+    QFontMetricsF fontmetrics = context->painter->fontMetrics();
+
+    if(fontmetrics.height() > 4)
+    {
+      // Draw big thousands numbers ===============================
+      bool visible, hidden;
+      QVector<QPointF> baseline;
+      for(int i = 0; i < centers.size(); i++)
+      {
+        QPointF pt = wToSF(centers.at(i), DEFAULT_WTOS_SIZE, &visible, &hidden);
 
-        if(fontmetrics.height() > 4)
+        if(!hidden)
         {
-          // Draw big thousands numbers ===============================
-          bool visible, hidden;
-          QVector<QPointF> baseline;
-          for(int i = 0; i < centers.size(); i++)
-          {
-            QPointF pt = wToSF(centers.at(i), DEFAULT_WTOS_SIZE, &visible, &hidden);
-
-            if(!hidden)
-            {
-              QString numTxt = QString::number(altitudes.at(i) / 10);
-              qreal w = fontmetrics.width(numTxt);
-              pt += QPointF(-w * 0.7, fontmetrics.height() / 2. - fontmetrics.descent());
-
-              context->painter->drawText(pt, numTxt);
-              baseline.append(QPointF(pt.x() + w, pt.y()));
-            }
-            else
-              baseline.append(QPointF());
-          }
+          QString numTxt = QString::number(altitudes.at(i) / 10);
+          qreal w = fontmetrics.width(numTxt);
+          pt += QPointF(-w * 0.7, fontmetrics.height() / 2. - fontmetrics.descent());
 
-          // Draw smaller hundreds numbers ==============================
-          font.setPixelSize(atools::roundToInt(fontSize * .6f));
-          context->painter->setFont(font);
-          fontmetrics = context->painter->fontMetrics();
+          context->painter->drawText(pt, numTxt);
+          baseline.append(QPointF(pt.x() + w, pt.y()));
+        }
+        else
+          baseline.append(QPointF());
+      }
 
-          for(int i = 0; i < centers.size(); i++)
-          {
-            QPointF pt = baseline.at(i);
-            if(!pt.isNull())
-            {
-              int alt = altitudes.at(i);
-              QString smallNumTxt = QString::number(alt - (alt / 10 * 10));
-              pt.setY(pt.y() + fontmetrics.ascent() / 3.f);
-              context->painter->drawText(pt, smallNumTxt);
-            }
-          }
-        } // if(fontmetrics.height() > ...)
-      } // if(!context->drawFast)
-    } // if(moraReader->isDataAvailable())
-  } // if(context->mapLayer->isMinimumAltitude())
+      // Draw smaller hundreds numbers ==============================
+      font.setPixelSize(atools::roundToInt(fontSize * .6f));
+      context->painter->setFont(font);
+      fontmetrics = context->painter->fontMetrics();
+
+      for(int i = 0; i < centers.size(); i++)
+      {
+        QPointF pt = baseline.at(i);
+        if(!pt.isNull())
+        {
+          int alt = altitudes.at(i);
+          QString smallNumTxt = QString::number(alt - (alt / 10 * 10));
+          pt.setY(pt.y() + fontmetrics.ascent() / 3.f);
+          context->painter->drawText(pt, smallNumTxt);
+        }
+      }
+    } // if(fontmetrics.height() > ...)
+  } // if(!context->drawFast)
 }
@@ -20,10 +20,27 @@
 
 #include "mappainter/mappainter.h"
 
+#include <QCache>
+#include <QFont>
+#include <QPixmap>
+
 class SymbolPainter;
 
+namespace atools {
+namespace fs {
+namespace common {
+class MoraReader;
+}
+}
+}
+
 /*
  * Draws MORA (minimum off route altitude) data and grid on the map
+ *
+ * The Mercator projection uses cached raster tiles containing grid and labels. Tiles are aligned to the
+ * Mercator pixel grid of the current globe radius and are simply copied to the screen. The cache is cleared when
+ * the database or the drawing style changes. Other projections and fast drawing while zooming without cached tiles
+ * draw the grid directly.
  */
 class MapPainterAltitude :
   public MapPainter
@@ -34,6 +51,78 @@ public:
 
   virtual void render() override;
 
+  /* Clear raster tiles after loading MORA data */
+  void clearCache();
+
+private:
+  /* Cache key for raster tiles. x and y are tile numbers in the Mercator pixel grid. */
+  struct TileKey
+  {
+    int radius, x, y;
+
+    bool operator==(const MapPainterAltitude::TileKey& other) const
+    {
+      return radius == other.radius && x == other.x && y == other.y;
+    }
+
+    bool operator!=(const MapPainterAltitude::TileKey& other) const
+    {
+      return !operator==(other);
+    }
+
+  };
+
+  friend uint qHash(const MapPainterAltitude::TileKey& key);
+
+  /* Everything affecting the tile contents except MORA data. Cache is cleared if this changes. */
+  struct TileStyle
+  {
+    QPen gridPen;
+    QColor textColor;
+    QFont font;
+    float textSize = 1.f;
+    qreal pixelRatio = 1.;
+
+    bool operator==(const MapPainterAltitude::TileStyle& other) const
+    {
+      return gridPen == other.gridPen && textColor == other.textColor && font == other.font &&
+             qFuzzyCompare(textSize, other.textSize) && qFuzzyCompare(pixelRatio, other.pixelRatio);
+    }
+
+    bool operator!=(const MapPainterAltitude::TileStyle& other) const
+    {
+      return !operator==(other);
+    }
+
+  };
+
+  /* Draw cached raster tiles for Mercator projection */
+  void renderTiles(atools::fs::common::MoraReader *moraReader);
+
+  /* Draw grid and labels directly for other projections */
+  void renderDirect(atools::fs::common::MoraReader *moraReader);
+
+  /* Paint grid and labels into a new raster tile */
+  QPixmap *createTile(atools::fs::common::MoraReader *moraReader, const TileKey& key) const;
+
+  /* Get font sizes for big and small numbers based on the cell width in pixel.
+   * Returns false if cells are too small for text. */
+  bool fontSizes(float cellWidth, float& fontSize) const;
+
+  /* Style used for grid and text based on options and dark map state */
+  TileStyle currentStyle() const;
+
+  /* Valid MORA value for drawing */
+  static bool isValidMora(int moraFt100);
+
+  /* Tile size in logical pixel */
+  static const int TILE_SIZE = 256;
+
+  /* Tile cache size in kB */
+  static const int CACHE_SIZE_KB = 64 * 1024;
+
+  QCache<TileKey, QPixmap> tileCache;
+  TileStyle tileStyle;
 };
 
 #endif // LITTLENAVMAP_MAPPAINTERALTITUDE_H
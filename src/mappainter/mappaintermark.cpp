@@ -36,7 +36,8 @@
 #include "route/route.h"
 #include "util/paintercontextsaver.h"
 #include "common/textplacement.h"
-#include "fs/userdata/logdatamanager.h"
+#include "logbook/logdatacontroller.h"
+#include "logbook/loggeometrycache.h"
 
 #include <marble/GeoDataLineString.h>
 #include <marble/GeoDataLinearRing.h>
@@ -49,6 +50,9 @@ const float MAX_COMPASS_ROSE_RADIUS_NM = 500.f;
 const float MIN_COMPASS_ROSE_RADIUS_NM = 0.2f;
 const double MIN_VIEW_DISTANCE_COMPASS_ROSE_KM = 6400.;
 
+/* Maximum number of selected logbook entries which show flight plan and trail */
+const int MAX_LOG_ENTRIES_ROUTE_TRAIL = 500;
+
 #ifdef DEBUG_INFORMATION_MEASUREMENT
 const int DISTMARK_DEG_PRECISION = 3;
 #else
@@ -411,12 +415,20 @@ void MapPainterMark::paintLogEntries(const QList<map::MapLogbookEntry>& entries)
 
   float minAltitude = std::numeric_limits<float>::max(), maxAltitude = std::numeric_limits<float>::min();
   // Collect visible feature parts ==========================================================================
-  atools::fs::userdata::LogdataManager *logdataManager = NavApp::getLogdataManager();
+  LogdataController *logdataController = NavApp::getLogdataController();
   QVector<const MapLogbookEntry *> visibleLogEntries, allLogEntries;
-  ageo::LineString visibleRouteGeometries;
-  QStringList visibleRouteTexts;
+  QVector<ageo::LineString> visibleRouteGeometries;
+  QVector<QStringList> visibleRouteTexts;
   QVector<ageo::LineString> visibleTrailGeometries;
-  bool showRouteAndTrail = entries.size() == 1;
+
+  // Show flight plan and trail details for a limited number of selected entries
+  bool showRouteAndTrail = entries.size() <= MAX_LOG_ENTRIES_ROUTE_TRAIL;
+
+  // Waypoint symbols, names and arrows only if one entry is selected
+  bool showRouteDetails = entries.size() == 1;
+
+  // Select level of detail for trails depending on zoom
+  int trailLevel = LogGeometryCache::levelForPixelPerNm(scale->getPixelForNm(1.f));
 
   for(const MapLogbookEntry& logEntry : entries)
   {
@@ -427,48 +439,35 @@ void MapPainterMark::paintLogEntries(const QList<map::MapLogbookEntry>& entries)
     if(resolves(logEntry.bounding()))
       visibleLogEntries.append(&logEntry);
 
-    // Show details only if one entry is selected - only direct connection for more than one selection
     if(showRouteAndTrail)
     {
-      // Get cached data
-      const atools::fs::gpx::GpxData *gpxData = logdataManager->getGpxData(logEntry.id);
+      // Get cached and simplified geometry which is created only once per entry
+      // Geometry is null if nothing is attached or if not loaded yet. The map is redrawn once loaded.
+      // Line strings are implicitly shared and copied since the cache might remove the geometry on the next call
+      const LogGeometry *geometry = logdataController->getLogGeometry(logEntry.id);
 
-      // Geometry might be null in case of cache overflow
-      // Geometry has to be copied since cache in LogDataManager might remove it any time
-      if(gpxData != nullptr)
+      if(geometry != nullptr)
       {
         // Flight plan =========================================================
-        if(!gpxData->flightplan.isEmpty() && context->objectDisplayTypes.testFlag(map::LOGBOOK_ROUTE) && resolves(gpxData->flightplanRect))
+        if(geometry->hasRoute() && context->objectDisplayTypes.testFlag(map::LOGBOOK_ROUTE) && resolves(geometry->routeRect))
         {
-          for(const atools::fs::pln::FlightplanEntry& entry : gpxData->flightplan)
-          {
-            visibleRouteGeometries.append(entry.getPosition());
-            visibleRouteTexts.append(entry.getIdent());
-          }
+          visibleRouteGeometries.append(geometry->route);
+          visibleRouteTexts.append(geometry->routeIdents);
         }
 
         // Trail =========================================================
-        // Limit number of visible tracks
-        if(!gpxData->trails.isEmpty() && context->objectDisplayTypes.testFlag(map::LOGBOOK_TRACK) && resolves(gpxData->trailRect))
+        if(geometry->hasTrail() && context->objectDisplayTypes.testFlag(map::LOGBOOK_TRACK) && resolves(geometry->trailRect))
         {
-          maxAltitude = std::max(maxAltitude, gpxData->maxTrailAltitude);
-          minAltitude = std::min(minAltitude, gpxData->minTrailAltitude);
+          maxAltitude = std::max(maxAltitude, geometry->maxTrailAltitude);
+          minAltitude = std::min(minAltitude, geometry->minTrailAltitude);
 
-          for(const atools::fs::gpx::TrailPoints& points : gpxData->trails)
+          for(const ageo::LineString& lineString : geometry->getTrail(trailLevel))
           {
-            if(!points.isEmpty())
-            {
-              ageo::LineString lineString;
-              for(const atools::fs::gpx::TrailPoint& point : points)
-                lineString.append(point.pos.asPos());
-
-              if(resolves(lineString.boundingRect()))
-                visibleTrailGeometries.append(lineString);
-            }
+            if(resolves(lineString.boundingRect()))
+              visibleTrailGeometries.append(lineString);
           }
         }
       }
-      break;
     }
   }
 
@@ -487,24 +486,27 @@ void MapPainterMark::paintLogEntries(const QList<map::MapLogbookEntry>& entries)
     painter->setPen(QPen(routeLogEntryOutlineColor, outerlinewidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
 
     // Draw outline for all selected entries ===============
-    // Draw one route
-    drawPolyline(painter, visibleRouteGeometries);
+    for(const ageo::LineString& route : visibleRouteGeometries)
+      drawPolyline(painter, route);
 
     // Draw line for all selected entries ===============
     // Use a lighter pen for the flight plan legs ======================================
     QPen routePen(routeLogEntryColor, lineWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
     routePen.setColor(routeLogEntryColor.lighter(130));
     painter->setPen(routePen);
-    drawPolyline(painter, visibleRouteGeometries);
+    for(const ageo::LineString& route : visibleRouteGeometries)
+      drawPolyline(painter, route);
 
-    if(!mapPaintWidget->isDistanceCutOff())
+    if(showRouteDetails && !mapPaintWidget->isDistanceCutOff())
     {
-      for(int i = 0; i < visibleRouteGeometries.size(); i++)
+      const ageo::LineString& route = visibleRouteGeometries.constFirst();
+      const QStringList& routeTexts = visibleRouteTexts.constFirst();
+      for(int i = 0; i < route.size(); i++)
       {
         // Draw waypoint symbols and text for route preview =========
-        const QString& name = visibleRouteTexts.at(i);
+        const QString& name = routeTexts.at(i);
         float x, y;
-        if(wToS(visibleRouteGeometries.at(i), x, y))
+        if(wToS(route.at(i), x, y))
         {
           symbolPainter->drawLogbookPreviewSymbol(context->painter, x, y, symbolSize);
 
@@ -512,17 +514,13 @@ void MapPainterMark::paintLogEntries(const QList<map::MapLogbookEntry>& entries)
             symbolPainter->textBoxF(context->painter, {name}, routeLogEntryOutlineColor, x + symbolSize / 2 + 2, y, textatt::LOG_BG_COLOR);
         }
       }
-    }
 
-    if(!mapPaintWidget->isDistanceCutOff())
-    {
       painter->setPen(QPen(routeLogEntryOutlineColor, (outerlinewidth - lineWidth) / 2., Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
       painter->setBrush(Qt::white);
       QPolygonF arrow = buildArrow(outerlinewidth);
-      for(int i = 1; i < visibleRouteGeometries.size(); i++)
+      for(int i = 1; i < route.size(); i++)
         // Draw waypoint symbols and text for route preview =========
-        paintArrowAlongLine(painter, ageo::Line(visibleRouteGeometries.at(i),
-                                                visibleRouteGeometries.at(i - 1)), arrow, 0.5f /* pos*/, 40.f /* minLengthPx */);
+        paintArrowAlongLine(painter, ageo::Line(route.at(i), route.at(i - 1)), arrow, 0.5f /* pos*/, 40.f /* minLengthPx */);
     }
   }
 
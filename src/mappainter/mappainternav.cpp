@@ -22,6 +22,8 @@
 #include "common/textplacement.h"
 #include "util/paintercontextsaver.h"
 #include "mapgui/maplayer.h"
+#include "mapgui/mappaintwidget.h"
+#include "mapgui/mapscreenindex.h"
 #include "query/mapquery.h"
 #include "query/airwaytrackquery.h"
 #include "query/waypointtrackquery.h"
@@ -209,6 +211,7 @@ void MapPainterNav::paintAirways(const QList<map::MapAirway> *airways, bool fast
   QPolygonF arrowAirway = buildArrow(static_cast<float>(linewidthAirway * 2.5));
   QPolygonF arrowTrack = buildArrow(static_cast<float>(linewidthTrack * 2.5));
   Marble::GeoPainter *painter = context->painter;
+  MapScreenIndex *screenIndex = mapPaintWidget->getScreenIndex();
 
   context->startTimer(track ? "Track draw" : "Airway draw");
   for(int i = 0; i < airways->size(); i++)
@@ -242,7 +245,14 @@ void MapPainterNav::paintAirways(const QList<map::MapAirway> *airways, bool fast
       if(context->objCount())
         return;
 
-      drawLine(painter, Line(airway.from, airway.to));
+      // Draw and publish screen geometry for tooltips and clicks to avoid projecting again
+      const QVector<QPolygonF *> polylines = createPolylines(LineString(airway.from, airway.to), context->screenRect);
+      if(!polylines.isEmpty())
+      {
+        drawPolylines(painter, polylines);
+        screenIndex->addPaintedAirway(airway.id, polylines);
+        releasePolylines(polylines);
+      }
 
       if(!fast)
       {
@@ -24,6 +24,8 @@
 #include "mapgui/mappaintwidget.h"
 #include "util/paintercontextsaver.h"
 
+#include <QDateTime>
+
 #include <marble/GeoPainter.h>
 
 using atools::fs::sc::SimConnectAircraft;
@@ -54,12 +56,16 @@ void MapPainterShip::render()
       atools::util::PainterContextSaver saver(context->painter);
       bool hidden = false;
       float x, y;
+      qint64 now = QDateTime::currentMSecsSinceEpoch();
 
-      for(const SimConnectAircraft& ac : mapPaintWidget->getAiAircraft())
+      // Get only ships in the viewport from index
+      for(const SimConnectAircraft *ship : mapPaintWidget->getAiAircraft(context->viewportRect))
       {
+        const SimConnectAircraft& ac = *ship;
+
         if(ac.isAnyBoat() && (ac.getModelRadiusCorrected() * 2 > layer::LARGE_SHIP_SIZE || context->mapLayer->isAiShipSmall()))
         {
-          if(wToSBuf(ac.getPosition(), x, y, MARGINS, &hidden))
+          if(wToSBuf(mapPaintWidget->getAiAircraftPos(ac, now), x, y, MARGINS, &hidden))
           {
             if(!hidden)
               paintAiVehicle(ac, x, y, false /* forceLabelNearby */);
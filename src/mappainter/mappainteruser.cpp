@@ -129,7 +129,9 @@ void MapPainterUser::paintUserpoints(const QList<MapUserpoint>& userpoints, bool
               break;
           }
 
-          symbolPainter->textBoxF(context->painter, texts, QPen(Qt::black), xpos, ypos, textatts, fill ? 255 : 0);
+          // Drop label if overlapping others
+          symbolPainter->textBoxF(context->painter, texts, QPen(Qt::black), xpos, ypos,
+                                  textatts | textatt::COLLISION_CHECK, fill ? 255 : 0);
 
         } // if(context->mapLayer->isUserpointInfo() && !drawFast)
       } // if(icons->hasType(userpoint.type) || context->userPointTypeUnknown)
@@ -72,7 +72,7 @@ void MapPainterWeather::render()
       visibleOnMap = wToS(airport.position, x, y, scale->getScreeenSizeForRect(airport.bounding), &hidden);
 
       if(!hidden && visibleOnMap)
-        visibleAirportWeather.append(PaintAirportType(airport, x, y));
+        visibleAirportWeather.append(PaintAirportType(context->arena, airport, x, y));
     }
   }
 
@@ -84,7 +84,7 @@ void MapPainterWeather::render()
       const MapAirport& airport = context->route->getDepartureAirportLeg().getAirport();
       visibleOnMap = wToS(airport.position, x, y, scale->getScreeenSizeForRect(airport.bounding), &hidden);
       if(!hidden && visibleOnMap)
-        visibleAirportWeather.append(PaintAirportType(airport, x, y));
+        visibleAirportWeather.append(PaintAirportType(context->arena, airport, x, y));
     }
 
     if(context->route->getDestinationAirportLeg().isAirport())
@@ -92,7 +92,7 @@ void MapPainterWeather::render()
       const MapAirport& airport = context->route->getDestinationAirportLeg().getAirport();
       visibleOnMap = wToS(airport.position, x, y, scale->getScreeenSizeForRect(airport.bounding), &hidden);
       if(!hidden && visibleOnMap)
-        visibleAirportWeather.append(PaintAirportType(airport, x, y));
+        visibleAirportWeather.append(PaintAirportType(context->arena, airport, x, y));
     }
 
     QVector<MapAirport> alternates = context->route->getAlternateAirports();
@@ -100,7 +100,7 @@ void MapPainterWeather::render()
     {
       visibleOnMap = wToS(airport.position, x, y, scale->getScreeenSizeForRect(airport.bounding), &hidden);
       if(!hidden && visibleOnMap)
-        visibleAirportWeather.append(PaintAirportType(airport, x, y));
+        visibleAirportWeather.append(PaintAirportType(context->arena, airport, x, y));
     }
   }
 
@@ -22,6 +22,7 @@
 #include "geo/calculations.h"
 #include "mapgui/maplayersettings.h"
 #include "mapgui/mapscale.h"
+#include "mapgui/mapscreenindex.h"
 #include "mapgui/mapwidget.h"
 #include "mappainter/mappainteraircraft.h"
 #include "mappainter/mappainterairport.h"
@@ -45,6 +46,7 @@
 #include "userdata/userdatacontroller.h"
 
 #include <QElapsedTimer>
+#include <QPicture>
 
 #include <marble/GeoPainter.h>
 
@@ -122,11 +124,13 @@ void MapPaintLayer::copySettings(const MapPaintLayer& other)
 void MapPaintLayer::preDatabaseLoad()
 {
   databaseLoadStatus = true;
+  mapPainterAltitude->clearCache();
 }
 
 void MapPaintLayer::postDatabaseLoad()
 {
   databaseLoadStatus = false;
+  mapPainterAltitude->clearCache();
 }
 
 void MapPaintLayer::setShowMapObjects(map::MapTypes type, map::MapTypes mask)
@@ -298,6 +302,9 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
   Q_UNUSED(renderPos)
   Q_UNUSED(layer)
 
+  // Painters add geometry of visible airspaces and airways again
+  mapPaintWidget->getScreenIndex()->resetPaintedScreenGeometry();
+
   if(!databaseLoadStatus && !mapPaintWidget->isNoNavPaint())
   {
     // Update map scale for screen distance approximation
@@ -320,6 +327,7 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
       // Prepare context =====================================================
       context = PaintContext();
       context.shownDetailAirportIds = &shownDetailAirportIds;
+      context.arena = &paintArena;
       context.route = &NavApp::getRouteConst();
       context.mapLayer = mapLayer;
       context.mapLayerRoute = mapLayerRoute;
@@ -538,6 +546,12 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
       // =========================================================================
       // Draw ====================================
 
+      // Record flight plan and marks including logbook first. Their labels are always drawn and reserve space
+      // before the droppable navaid, airport and userpoint labels are placed. Pictures are drawn at layer position.
+      QPicture routePicture, markPicture;
+      recordLayer(routePicture, mapPainterRoute, painter, viewport);
+      recordLayer(markPicture, mapPainterMark, painter, viewport);
+
       // Altitude below all others
       mapPainterAltitude->render();
 
@@ -576,11 +590,14 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
       if(!context.isObjectOverflow())
         mapPainterUser->render();
 
+      // Place and draw navaid, airport and userpoint labels by priority above their symbols but below the flight plan
+      context.textCollisionGrid.drawDeferred(painter);
+
       if(!context.isObjectOverflow())
         mapPainterWind->render();
 
       // if(!context.isOverflow()) always paint route even if number of objects is too large
-      mapPainterRoute->render();
+      painter->drawPicture(0, 0, routePicture);
 
       if(!context.isObjectOverflow())
         mapPainterWeather->render();
@@ -593,12 +610,15 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
 
       mapPainterAircraft->render();
 
-      mapPainterMark->render();
+      painter->drawPicture(0, 0, markPicture);
 
       resetNoAntiAliasFont(&context);
       context.endTimer("All");
 
       mapPainterTop->render();
+
+      // Release all temporary objects at once
+      paintArena.clear();
     } // if(!noRender())
 
     if(!mapPaintWidget->isPrinting() && mapPaintWidget->isVisibleWidget())
@@ -608,6 +628,24 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
   return true;
 }
 
+void MapPaintLayer::recordLayer(QPicture& picture, MapPainter *mapPainter, GeoPainter *painter, ViewportParams *viewport)
+{
+  // Painter clips to the device size which is the bounding rectangle for pictures
+  picture.setBoundingRect(QRect(0, 0, viewport->width(), viewport->height()));
+
+  GeoPainter recordPainter(&picture, viewport, painter->mapQuality());
+  recordPainter.setRenderHints(painter->renderHints());
+  recordPainter.setFont(painter->font());
+  recordPainter.setBackground(painter->background());
+  recordPainter.setBackgroundMode(painter->backgroundMode());
+
+  context.painter = &recordPainter;
+  mapPainter->render();
+  context.painter = painter;
+
+  recordPainter.end();
+}
+
 void MapPaintLayer::setNoAntiAliasFont(PaintContext *context)
 {
   if(context->viewContext == Marble::Animation)
@@ -19,6 +19,7 @@
 #define LITTLENAVMAP_MAPPAINTLAYER_H
 
 #include "mappainter/mappainter.h"
+#include "mappainter/paintarena.h"
 
 #include <QPen>
 
@@ -32,6 +33,7 @@ class ViewportParams;
 
 class MapPainter;
 class MapLayer;
+class QPicture;
 class MapWidget;
 class MapLayerSettings;
 class MapScale;
@@ -206,6 +208,10 @@ private:
   /* Restore normal font anti-aliasing for default and painter font */
   void resetNoAntiAliasFont(PaintContext *context);
 
+  /* Render layer of mapPainter into picture using a painter with the same state as painter. Labels drawn by the
+   * layer reserve their space in the text collision grid. The picture is drawn later at the layer position. */
+  void recordLayer(QPicture& picture, MapPainter *mapPainter, Marble::GeoPainter *painter, Marble::ViewportParams *viewport);
+
   /* Map objects currently shown */
   map::MapTypes objectTypes = map::NONE;
   map::MapDisplayTypes objectDisplayTypes = map::DISPLAY_TYPE_NONE;
@@ -226,6 +232,9 @@ private:
 
   PaintContext context;
 
+  /* Temporary objects of the painters for one frame */
+  PaintArena paintArena;
+
   /* All painters */
   MapPainterAirport *mapPainterAirport;
   MapPainterMsa *mapPainterMsa;
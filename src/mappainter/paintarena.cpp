@@ -0,0 +1,89 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mappainter/paintarena.h"
+
+#include <QDebug>
+
+PaintArena::PaintArena()
+{
+  blocks.append(new char[BLOCK_SIZE]);
+}
+
+PaintArena::~PaintArena()
+{
+  clear();
+  deleteBlocks(blocks);
+}
+
+void PaintArena::deleteBlocks(QVector<char *>& blockList)
+{
+  for(char *block : qAsConst(blockList))
+    delete[] block;
+  blockList.clear();
+}
+
+void *PaintArena::allocate(size_t size, size_t alignment)
+{
+  numObjects++;
+  bytesUsed += size;
+
+  if(size > BLOCK_SIZE / 4)
+  {
+    // Give large objects their own block to avoid wasting the rest of a regular one
+    char *block = new char[size];
+    largeBlocks.append(block);
+    return block;
+  }
+
+  // Align offset for type
+  size_t offset = (blockOffset + alignment - 1) & ~(alignment - 1);
+
+  if(offset + size > BLOCK_SIZE)
+  {
+    // Current block is full - continue with next or a new one
+    blockIndex++;
+    if(blockIndex >= blocks.size())
+      blocks.append(new char[BLOCK_SIZE]);
+    offset = 0;
+  }
+
+  blockOffset = offset + size;
+  return blocks.at(blockIndex) + offset;
+}
+
+void PaintArena::clear()
+{
+#ifdef DEBUG_INFORMATION_PAINT
+  qDebug() << Q_FUNC_INFO << "objects" << numObjects << "bytes" << bytesUsed << "blocks" << blocks.size()
+           << "large blocks" << largeBlocks.size();
+#endif
+
+  // Destroy in reverse order of creation
+  for(int i = destructors.size() - 1; i >= 0; i--)
+    destructors.at(i).destroy(destructors.at(i).object);
+
+  // Keeps capacity
+  destructors.clear();
+
+  deleteBlocks(largeBlocks);
+
+  blockIndex = 0;
+  blockOffset = 0;
+  numObjects = 0;
+  bytesUsed = 0;
+}
@@ -0,0 +1,103 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_PAINTARENA_H
+#define LITTLENAVMAP_PAINTARENA_H
+
+#include <QVector>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Bump allocator for short lived objects which are needed only while painting one frame.
+ *
+ * Objects are placed one after another in large blocks and are released all at once by clear() which is called
+ * at the end of MapPaintLayer::render(). Destructors are called for types which need one.
+ * Blocks are kept and reused for the next frame. Not thread safe.
+ */
+class PaintArena
+{
+public:
+  PaintArena();
+  ~PaintArena();
+
+  PaintArena(const PaintArena& other) = delete;
+  PaintArena& operator=(const PaintArena& other) = delete;
+
+  /* Construct object in the arena. Pointer is valid until clear() is called. Never delete the object. */
+  template<typename TYPE, typename ... ARGS>
+  TYPE *create(ARGS&& ... args)
+  {
+    TYPE *object = new (allocate(sizeof(TYPE), alignof(TYPE)))TYPE(std::forward<ARGS>(args) ...);
+
+    if(!std::is_trivially_destructible<TYPE>::value)
+      destructors.append({object, &PaintArena::destroy<TYPE>});
+    return object;
+  }
+
+  /* Destroy all objects and free oversized blocks. Keeps the regular blocks for the next frame. */
+  void clear();
+
+  /* Number of objects created since last clear() */
+  int getNumObjects() const
+  {
+    return numObjects;
+  }
+
+  /* Bytes used since last clear() */
+  size_t getBytesUsed() const
+  {
+    return bytesUsed;
+  }
+
+private:
+  template<typename TYPE>
+  static void destroy(void *object)
+  {
+    static_cast<TYPE *>(object)->~TYPE();
+  }
+
+  /* Free memory of all blocks in list */
+  static void deleteBlocks(QVector<char *>& blockList);
+
+  /* Get aligned memory from the current block and start a new one if exhausted */
+  void *allocate(size_t size, size_t alignment);
+
+  /* Size of a block. Fits about 500 airports */
+  static constexpr size_t BLOCK_SIZE = 256 * 1024;
+
+  struct Destructor
+  {
+    void *object;
+    void (*destroy)(void *object);
+  };
+
+  /* Regular blocks having BLOCK_SIZE and objects larger than a block */
+  QVector<char *> blocks, largeBlocks;
+
+  /* Index into blocks and offset into the current block */
+  int blockIndex = 0;
+  size_t blockOffset = 0;
+
+  QVector<Destructor> destructors;
+  int numObjects = 0;
+  size_t bytesUsed = 0;
+};
+
+#endif // LITTLENAVMAP_PAINTARENA_H
@@ -414,11 +414,11 @@ void PrintSupport::restoreState()
   printDialog->setRouteTableColumns(NavApp::getRouteController()->getAllRouteColumns());
 }
 
-void PrintSupport::drawWatermark(const QPoint& pos, QPixmap *pixmap)
+void PrintSupport::drawWatermark(const QPoint& pos, QPaintDevice *device)
 {
   // Watermark for images
   QPainter painter;
-  painter.begin(pixmap);
+  painter.begin(device);
   QFont font = painter.font();
   font.setPixelSize(9);
   painter.setFont(font);
@@ -23,7 +23,7 @@
 
 class MainWindow;
 class QPrinter;
-class QPixmap;
+class QPaintDevice;
 class QPainter;
 class QPrintPreviewDialog;
 class QTextDocument;
@@ -69,7 +69,7 @@ public:
 
   /* Draw program name, version and date into an image */
   static void drawWatermark(const QPoint& pos, QPainter *painter);
-  static void drawWatermark(const QPoint& pos, QPixmap *pixmap);
+  static void drawWatermark(const QPoint& pos, QPaintDevice *device);
 
 private:
   /* Draw map */
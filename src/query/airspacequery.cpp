@@ -44,6 +44,7 @@ AirspaceQuery::AirspaceQuery(SqlDatabase *sqlDb, map::MapAirspaceSources src)
   atools::settings::Settings& settings = atools::settings::Settings::instance();
 
   airspaceLineCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "AirspaceLineCache", 10000).toInt());
+  airspaceLinePrefetchCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "AirspaceLinePrefetchCache", 2000).toInt());
   onlineCenterGeoCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "OnlineCenterGeoCache", 10000).toInt());
   onlineCenterGeoFileCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY % "OnlineCenterGeoFileCache", 10000).toInt());
 
@@ -238,6 +239,33 @@ void AirspaceQuery::airspaceGeometry(LineString *lines, const QByteArray& bytes)
   geometry.swapGeometry(*lines);
 }
 
+void AirspaceQuery::prefetchAirspaces(const GeoDataLatLonBox& rect, const MapLayer *mapLayer, const map::MapAirspaceFilter& filter,
+                                      float flightPlanAltitude)
+{
+  // Save display cache and parameters - list is implicitly shared and cheap to copy
+  query::SimpleRectCache<map::MapAirspace> savedCache = airspaceCache;
+  map::MapAirspaceFilter savedFilter = lastAirspaceFilter;
+  float savedAltitude = lastFlightplanAltitude;
+
+  airspaceCache.clear();
+  bool overflow = false;
+  const QList<map::MapAirspace> *airspaces = getAirspaces(rect, mapLayer, filter, flightPlanAltitude, false /* lazy */, overflow);
+  if(airspaces != nullptr && !overflow && query::valid(Q_FUNC_INFO, airspaceLinesByIdQuery))
+  {
+    // Load and decode geometry blobs into the separate prefetch cache to avoid evicting displayed geometry
+    for(const map::MapAirspace& airspace : *airspaces)
+    {
+      if(!airspaceLineCache.contains(airspace.id) && !airspaceLinePrefetchCache.contains(airspace.id))
+        airspaceLinePrefetchCache.insert(airspace.id, loadAirspaceGeometryById(airspace.id));
+    }
+  }
+
+  // Restore display cache
+  airspaceCache = savedCache;
+  lastAirspaceFilter = savedFilter;
+  lastFlightplanAltitude = savedAltitude;
+}
+
 const LineString *AirspaceQuery::getAirspaceGeometryById(int airspaceId)
 {
   if(!query::valid(Q_FUNC_INFO, airspaceLinesByIdQuery))
@@ -247,19 +275,29 @@ const LineString *AirspaceQuery::getAirspaceGeometryById(int airspaceId)
     return airspaceLineCache.object(airspaceId);
   else
   {
-    LineString *linestring = new LineString;
-
-    airspaceLinesByIdQuery->bindValue(":id", airspaceId);
-    airspaceLinesByIdQuery->exec();
-    if(airspaceLinesByIdQuery->next())
-      airspaceGeometry(linestring, airspaceLinesByIdQuery->value("geometry").toByteArray());
-    airspaceLinesByIdQuery->finish();
+    // Move prefetched geometry to the display cache or load it
+    LineString *linestring = airspaceLinePrefetchCache.take(airspaceId);
+    if(linestring == nullptr)
+      linestring = loadAirspaceGeometryById(airspaceId);
     airspaceLineCache.insert(airspaceId, linestring);
 
     return linestring;
   }
 }
 
+LineString *AirspaceQuery::loadAirspaceGeometryById(int airspaceId)
+{
+  LineString *linestring = new LineString;
+
+  airspaceLinesByIdQuery->bindValue(":id", airspaceId);
+  airspaceLinesByIdQuery->exec();
+  if(airspaceLinesByIdQuery->next())
+    airspaceGeometry(linestring, airspaceLinesByIdQuery->value("geometry").toByteArray());
+  airspaceLinesByIdQuery->finish();
+
+  return linestring;
+}
+
 const LineString *AirspaceQuery::getAirspaceGeometryByFile(QString callsign)
 {
   if(airspaceGeoByFileQuery != nullptr)
@@ -519,6 +557,7 @@ void AirspaceQuery::clearCache()
 {
   airspaceCache.clear();
   airspaceLineCache.clear();
+  airspaceLinePrefetchCache.clear();
   onlineCenterGeoCache.clear();
   onlineCenterGeoFileCache.clear();
 
@@ -69,6 +69,11 @@ public:
                                               const map::MapAirspaceFilter& filter, float flightPlanAltitude, bool lazy, bool& overflow);
   const atools::geo::LineString *getAirspaceGeometryById(int airspaceId);
 
+  /* Loads airspaces and their geometry for the rectangle into a separate prefetch cache and warms database pages.
+   * Keeps the current map display caches untouched. */
+  void prefetchAirspaces(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer, const map::MapAirspaceFilter& filter,
+                         float flightPlanAltitude);
+
   /* Query raw geometry blob by online callsign (name) and facility type */
   const atools::geo::LineString *getAirspaceGeometryByName(QString callsign, const QString& facilityType);
 
@@ -95,6 +100,9 @@ private:
   const atools::geo::LineString *airspaceGeometryByNameInternal(const QString& callsign, const QString& facilityType);
   void airspaceGeometry(atools::geo::LineString* lines, const QByteArray& bytes);
 
+  /* Load and decode geometry without using caches. Caller takes ownership. */
+  atools::geo::LineString *loadAirspaceGeometryById(int airspaceId);
+
   MapTypesFactory *mapTypesFactory;
   atools::sql::SqlDatabase *db;
 
@@ -105,6 +113,9 @@ private:
 
   /* ID/object caches */
   QCache<int, atools::geo::LineString> airspaceLineCache;
+
+  /* Geometry loaded by prefetchAirspaces() which is moved to airspaceLineCache on first use */
+  QCache<int, atools::geo::LineString> airspaceLinePrefetchCache;
   QCache<QString, atools::geo::LineString> onlineCenterGeoCache, onlineCenterGeoFileCache;
 
   static int queryMaxRows;
@@ -140,6 +140,8 @@ void Route::copy(const Route& other)
   destRunwayIlsFlightPlanTable = other.destRunwayIlsFlightPlanTable;
   destRunwayEnd = other.destRunwayEnd;
 
+  legSignatures = other.legSignatures;
+
   // Update flightplan pointers to this instance
   for(RouteLeg& routeLeg : *this)
     routeLeg.setFlightplan(&flightplan);
@@ -162,6 +164,7 @@ void Route::clearAll()
   destRunwayIlsFlightPlanTable.clear();
   destRunwayEnd = map::MapRunwayEnd();
   objectIndex.clear();
+  legSignatures.clear();
 
   totalDistance = 0.f;
 }
@@ -1947,15 +1950,105 @@ void Route::updateDepartureAndDestination(bool clearInvalidStart)
 
 void Route::updateAll()
 {
+  // Cheap passes which need the whole route
   updateIndicesAndOffsets();
   removeDuplicateRouteLegs();
+
+  // Detect changes after removing duplicates - following passes update only changed legs and neighbours
+  updateDirtyLegs();
+
   validateAirways();
   updateMagvar();
   updateDistancesAndCourse();
   updateBoundingRect();
   updateWaypointNames();
   updateDepartureAndDestination(false /* clearInvalidStart */);
-  updateApproachIls();
+
+  // Database queries for ILS only if anything changed at the destination
+  if(arrivalDirty)
+    updateApproachIls();
+
+  // Remember state for next update including changes done above like airway corrections
+  legSignatures.clear();
+  legSignatures.reserve(size());
+  for(int i = 0; i < size(); i++)
+    legSignatures.append(legSignature(i));
+
+  // Outside of this method all legs count as dirty
+  dirtyLegs.clear();
+  arrivalDirty = true;
+}
+
+Route::LegSignature Route::legSignature(int index) const
+{
+  const RouteLeg& leg = at(index);
+  return {map::MapRef(leg.getId(), leg.getMapType()), leg.getPosition(), leg.getDeparturePosition(), leg.getAirwayName()};
+}
+
+void Route::updateDirtyLegs()
+{
+  int num = size(), numOld = legSignatures.size();
+
+  if(legSignatures.isEmpty() || isEmpty())
+  {
+    // Nothing known about the previous state
+    dirtyLegs = QBitArray(num, true);
+    arrivalDirty = true;
+    return;
+  }
+
+  // Find unchanged head and tail =====================================
+  int minSize = std::min(num, numOld);
+  int head = 0;
+  while(head < minSize && legSignatures.at(head) == legSignature(head))
+    head++;
+
+  int tail = 0;
+  while(tail < minSize - head && legSignatures.at(numOld - 1 - tail) == legSignature(num - 1 - tail))
+    tail++;
+
+  dirtyLegs = QBitArray(num, false);
+
+  if(head == num && num == numOld)
+    // Nothing changed
+    arrivalDirty = false;
+  else
+  {
+    // Changed range plus one neighbour on each side since legs depend on the previous one
+    int from = std::max(head - 1, 0), to = std::min(num - tail, num - 1);
+    dirtyLegs.fill(true, from, to + 1);
+
+    // Any change at the arrival procedures or destination has to update destination airport, alternates and ILS
+    int arrivalStart = getDestinationAirportLegIndex();
+    if(starLegsOffset != map::INVALID_INDEX_VALUE)
+      arrivalStart = std::min(arrivalStart, starLegsOffset);
+    if(approachLegsOffset != map::INVALID_INDEX_VALUE)
+      arrivalStart = std::min(arrivalStart, approachLegsOffset);
+
+    arrivalDirty = arrivalStart == map::INVALID_INDEX_VALUE || to >= arrivalStart;
+    if(arrivalDirty && arrivalStart != map::INVALID_INDEX_VALUE && arrivalStart < num)
+      dirtyLegs.fill(true, arrivalStart, num);
+  }
+
+  for(int i = 0; i < num; i++)
+  {
+    const RouteLeg& leg = at(i);
+    if(leg.isAnyProcedure())
+      // Procedure legs are cheap and take their values from the procedures which might have changed
+      dirtyLegs.setBit(i);
+    else if(leg.getGeometry().isEmpty())
+    {
+      // Newly created leg which was never calculated but has the same values as the old one
+      dirtyLegs.setBit(i);
+      if(i < num - 1)
+        dirtyLegs.setBit(i + 1);
+    }
+  }
+
+#ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << "head" << head << "tail" << tail << "dirty" << dirtyLegs.count(true) << "of" << num
+           << "arrivalDirty" << arrivalDirty;
+#endif
 }
 
 void Route::updateWaypointNames()
@@ -2180,19 +2273,27 @@ void Route::updateDistancesAndCourse()
   {
     RouteLeg& leg = (*this)[i];
 
+    // Unchanged legs keep their values but are still needed for the total distance
+    bool dirty = isLegDirty(i);
+
     if(leg.isAlternate())
+    {
       // Update all alternate distances from destination airport
-      leg.updateDistanceAndCourse(i, &getDestinationAirportLeg());
+      if(dirty)
+        leg.updateDistanceAndCourse(i, &getDestinationAirportLeg());
+    }
     else
     {
       if(isAirportAfterArrival(i))
       {
         // Update with distance from previous or last procedure leg like runway
-        leg.updateDistanceAndCourse(i, beforeDestAirport != nullptr ? beforeDestAirport : last);
+        if(dirty)
+          leg.updateDistanceAndCourse(i, beforeDestAirport != nullptr ? beforeDestAirport : last);
         continue;
       }
 
-      leg.updateDistanceAndCourse(i, last);
+      if(dirty)
+        leg.updateDistanceAndCourse(i, last);
 
       if(!leg.getProcedureLeg().isMissed())
         // Do not sum up missed legs
@@ -2213,7 +2314,10 @@ void Route::updateMagvar()
 {
   // get magvar from internal database objects (waypoints, VOR and others)
   for(int i = 0; i < size(); i++)
-    (*this)[i].updateMagvar(i > 0 ? &at(i - 1) : nullptr);
+  {
+    if(isLegDirty(i))
+      (*this)[i].updateMagvar(i > 0 ? &at(i - 1) : nullptr);
+  }
 }
 
 void Route::updateLegAltitudes()
@@ -2222,6 +2326,11 @@ void Route::updateLegAltitudes()
   altitude->calculateAll(NavApp::getAircraftPerformance(), getCruiseAltitudeFt());
 }
 
+void Route::updateLegAltitudesWind()
+{
+  altitude->calculateWind(NavApp::getAircraftPerformance(), getCruiseAltitudeFt());
+}
+
 /* Update the bounding rect using marble functions to catch anti meridian overlap */
 void Route::updateBoundingRect()
 {
@@ -2583,7 +2692,7 @@ void Route::validateAirways()
 
   // Check arrival airway ===========================================================================
   int arrivaLegsOffset = map::INVALID_INDEX_VALUE;
-  if(arrivalRouteToProcLegs(arrivaLegsOffset))
+  if(arrivalRouteToProcLegs(arrivaLegsOffset) && (isLegDirty(arrivaLegsOffset - 1) || isLegDirty(arrivaLegsOffset)))
   {
     const RouteLeg& routeLeg = value(arrivaLegsOffset - 1);
     RouteLeg& arrivalLeg = (*this)[arrivaLegsOffset];
@@ -2622,7 +2731,8 @@ void Route::validateAirways()
 
   // Check departure airway ===========================================================================
   int startIndexAfterProcedure = map::INVALID_INDEX_VALUE;
-  if(departureProcToRouteLegs(startIndexAfterProcedure))
+  if(departureProcToRouteLegs(startIndexAfterProcedure) &&
+     (isLegDirty(startIndexAfterProcedure - 1) || isLegDirty(startIndexAfterProcedure)))
   {
     // remove duplicates between end of SID and route: only legs that have the navaid at the end of the leg
     const RouteLeg& departureLeg = value(startIndexAfterProcedure - 1);
@@ -2728,6 +2838,9 @@ void Route::createRouteLegsFromFlightplan()
 {
   clear();
 
+  // Loaded plan - update all legs
+  legSignatures.clear();
+
   const RouteLeg *lastLeg = nullptr;
 
   // Create map objects first and calculate total distance
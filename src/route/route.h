@@ -23,6 +23,8 @@
 
 #include "fs/pln/flightplan.h"
 
+#include <QBitArray>
+
 class CoordinateConverter;
 class FlightplanEntryBuilder;
 class RouteAltitude;
@@ -479,7 +481,9 @@ public:
   const atools::geo::Pos getPrevPositionAt(int i) const;
 
   /* Update distance, course, bounding rect and total distance for route map objects.
-   *  Also calculates maximum number of user points. */
+   *  Also calculates maximum number of user points.
+   *  Recalculates only legs which were changed since the last call plus their neighbours.
+   *  All legs are updated after createRouteLegsFromFlightplan() or clearAll(). */
   void updateAll();
 
   /* Use an expensive heuristic to update the missing regions in all airports
@@ -642,9 +646,13 @@ public:
   int getNumAltitudeLegs() const;
   bool isValidProfile() const;
 
-  /* Calculate route leg altitudes that are needed for the elevation profile */
+  /* Calculate route leg altitudes that are needed for the elevation profile.
+   * Does nothing if neither route, performance nor options changed since last call. */
   void updateLegAltitudes();
 
+  /* Update trip time, fuel and wind after wind data changes. Keeps the altitude profile if possible. */
+  void updateLegAltitudesWind();
+
   /* general distance in NM which is either cross track, previous or next waypoint */
   float getDistanceToFlightPlan() const;
   bool isTooFarToFlightPlan() const;
@@ -771,6 +779,15 @@ private:
   /* Update and calculate magnetic variation for all route map objects */
   void updateMagvar();
 
+  /* Compare legs with the state of the last call to updateAll() and fill dirtyLegs */
+  void updateDirtyLegs();
+
+  /* True if leg at index has to be recalculated. Always true outside of updateAll(). */
+  bool isLegDirty(int index) const
+  {
+    return dirtyLegs.isEmpty() || index >= dirtyLegs.size() || dirtyLegs.testBit(index);
+  }
+
   /* Get indexes to nearest approach or route leg and cross track distance to the nearest ofthem in nm */
   void copy(const Route& other);
   void nearestAllLegIndex(const map::PosCourse& pos, float& crossTrackDistanceMeter, int& index) const;
@@ -826,6 +843,37 @@ private:
 
   /* Ref to flight plan leg  index map */
   QHash<map::MapRef, int> objectIndex;
+
+  /* All values of a leg that are used as input by the update methods called in updateAll() */
+  struct LegSignature
+  {
+    map::MapRef ref;
+    atools::geo::Pos position, departurePosition;
+    QString airway;
+
+    bool operator==(const LegSignature& other) const
+    {
+      return ref == other.ref && position == other.position && departurePosition == other.departurePosition &&
+             airway == other.airway;
+    }
+
+    bool operator!=(const LegSignature& other) const
+    {
+      return !(*this == other);
+    }
+
+  };
+
+  LegSignature legSignature(int index) const;
+
+  /* Leg state after last call of updateAll(). Empty forces update of all legs. */
+  QVector<LegSignature> legSignatures;
+
+  /* Legs to recalculate. Only valid while updateAll() is running. */
+  QBitArray dirtyLegs;
+
+  /* Any arrival procedure leg or destination changed. Only valid while updateAll() is running. */
+  bool arrivalDirty = true;
 };
 
 QDebug operator<<(QDebug out, const Route& route);
@@ -40,6 +40,9 @@ const float AT_RESTRICTION_TOLERANCE_FT = 10.f;
 const float MIN_CRUISE_ALTITUDE_FT = 100.f;
 const float MIN_FLIGHTPLAN_DIST_NM = 0.5f;
 
+// Recalculate profile on wind changes if wind corrected climb or descent speed differs more than this
+const float WIND_SPEED_RECALC_TOLERANCE_KTS = 2.f;
+
 using atools::interpolate;
 namespace ageo = atools::geo;
 
@@ -214,6 +217,8 @@ void RouteAltitude::clearAll()
   averageGroundSpeed = 0.f;
   unflyableLegs = false;
   validProfile = false;
+  calculatedSignature.clear();
+  calculatedWindGeneration = -1;
 }
 
 const RouteAltitudeLeg& RouteAltitude::value(int i) const
@@ -989,12 +994,95 @@ void RouteAltitude::collectErrors(const QStringList& altRestrErrors)
                            "<li>Cruise altitude violates one or more procedure altitude restrictions.</li></ul>"));
 }
 
+QVector<float> RouteAltitude::inputSignature(const atools::fs::perf::AircraftPerf& perf, float cruiseAltitudeFt) const
+{
+  QVector<float> signature;
+  signature.reserve(route->size() * 16 + 32);
+
+  // Options and global values ================================================
+  signature << cruiseAltitudeFt << simplify << calcTopOfDescent << calcTopOfClimb
+            << route->size() << route->getSizeWithoutAlternates() << route->getTotalDistance()
+            << route->getDestinationLegIndex() << route->getDestinationAirportLegIndex();
+
+  // Performance values used for profile and trip ================================================
+  signature << perf.getClimbSpeed() << perf.getCruiseSpeed() << perf.getDescentSpeed()
+            << perf.getClimbVertSpeed() << perf.getDescentVertSpeed()
+            << perf.getClimbFuelFlow() << perf.getCruiseFuelFlow() << perf.getDescentFuelFlow()
+            << perf.getAlternateSpeed() << perf.getAlternateFuelFlow()
+            << perf.isJetFuel() << perf.useFuelAsVolume();
+
+  // Route legs ================================================
+  for(int i = 0; i < route->size(); i++)
+  {
+    const RouteLeg& leg = route->value(i);
+    const atools::geo::Pos& pos = leg.getPosition();
+    signature << pos.getLonX() << pos.getLatY() << leg.getDistanceTo() << leg.getAltitude()
+              << leg.isAlternate() << leg.isAnyProcedure() << leg.getRunwayEnd().isValid();
+
+    if(leg.isAnyProcedure())
+    {
+      const proc::MapProcedureLeg& procLeg = leg.getProcedureLeg();
+      const proc::MapAltRestriction& restriction = leg.getProcedureLegAltRestr();
+      signature << static_cast<int>(leg.getProcedureType()) << procLeg.isMissed() << procLeg.verticalAngle
+                << restriction.descriptor << restriction.alt1 << restriction.alt2 << restriction.verticalAngleAlt
+                << restriction.forceFinal << procLeg.geometry.size();
+    }
+  }
+  return signature;
+}
+
+int RouteAltitude::currentWindGeneration()
+{
+  const WindReporter *windReporter = NavApp::getWindReporter();
+  return windReporter != nullptr ? windReporter->getWindGeneration() : 0;
+}
+
+void RouteAltitude::calculateWind(const atools::fs::perf::AircraftPerf& perf, float cruiseAltitudeFt)
+{
+  if(!validProfile || calculatedSignature.isEmpty() || calculatedSignature != inputSignature(perf, cruiseAltitudeFt))
+  {
+    // Route or performance changed too or there is no valid profile to reuse
+    calculateAll(perf, cruiseAltitudeFt);
+    return;
+  }
+
+  float climbSpeedLast = climbSpeedWindCorrected, descentSpeedLast = descentSpeedWindCorrected;
+
+  // Profile is kept - only update time, fuel and wind
+  calculateTrip(perf);
+  calculatedWindGeneration = currentWindGeneration();
+
+#ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << "climb speed" << climbSpeedLast << climbSpeedWindCorrected
+           << "descent speed" << descentSpeedLast << descentSpeedWindCorrected;
+#endif
+
+  // Wind changes climb and descent rates and therefore TOC and TOD - need full recalculation
+  if(std::abs(climbSpeedWindCorrected - climbSpeedLast) > WIND_SPEED_RECALC_TOLERANCE_KTS ||
+     std::abs(descentSpeedWindCorrected - descentSpeedLast) > WIND_SPEED_RECALC_TOLERANCE_KTS)
+  {
+    calculatedSignature.clear();
+    calculateAll(perf, cruiseAltitudeFt);
+  }
+}
+
 void RouteAltitude::calculateAll(const atools::fs::perf::AircraftPerf& perf, float cruiseAltitudeFt)
 {
 #ifdef DEBUG_INFORMATION
   qDebug() << Q_FUNC_INFO << perf.getAircraftType() << cruiseAltitudeFt;
 #endif
 
+  // Nothing changed since last call including wind - reuse solution including errors
+  QVector<float> signature = inputSignature(perf, cruiseAltitudeFt);
+  int windGeneration = currentWindGeneration();
+  if(!calculatedSignature.isEmpty() && calculatedSignature == signature && calculatedWindGeneration == windGeneration)
+  {
+#ifdef DEBUG_INFORMATION
+    qDebug() << Q_FUNC_INFO << "Using cached solution";
+#endif
+    return;
+  }
+
   // Get default climb speed
   climbSpeedWindCorrected = perf.getClimbSpeed();
   cruiseSpeedWindCorrected = perf.getCruiseSpeed();
@@ -1098,6 +1186,10 @@ void RouteAltitude::calculateAll(const atools::fs::perf::AircraftPerf& perf, flo
     }
   } // if(!invalid)
 
+  // Remember input values - clearAll() resets these
+  calculatedSignature = signature;
+  calculatedWindGeneration = windGeneration;
+
 #ifdef DEBUG_INFORMATION
   qDebug() << Q_FUNC_INFO;
   qDebug() << "windDirection" << windDirectionAvg << "windSpeed" << windSpeedAvg << "windHead" << windHeadAvg
@@ -147,6 +147,11 @@ public:
    * value in feet. */
   void calculateAll(const atools::fs::perf::AircraftPerf& perf, float cruiseAltitudeFt);
 
+  /* Recalculate trip time, fuel and wind after a change of wind data only. Reuses the cached climb and descent
+   * solution and falls back to calculateAll() if the route or performance has changed or if the new wind changes the
+   * wind corrected climb or descent speeds significantly. */
+  void calculateWind(const atools::fs::perf::AircraftPerf& perf, float cruiseAltitudeFt);
+
   /* Get interpolated altitude value in ft for the given distance to destination in NM.
    *  Not for missed and alternate legs. */
   float getAltitudeForDistance(float distanceToDest) const;
@@ -201,7 +206,7 @@ public:
     simplify = value;
   }
 
-  /* Reset all except route pointer */
+  /* Reset all except route pointer. Also invalidates the cached solution. */
   void clearAll();
 
   /* Calculate TOD ramp if true. Otherwise uses cruise altitude */
@@ -462,6 +467,13 @@ private:
 
   float windCorrectedGroundSpeed(atools::grib::Wind& wind, float course, float speed);
 
+  /* Collect all route, performance and option values used by calculate() and calculateTrip() except wind.
+   * Used together with the wind generation to detect if a call to calculateAll() can reuse the previous solution. */
+  QVector<float> inputSignature(const atools::fs::perf::AircraftPerf& perf, float cruiseAltitudeFt) const;
+
+  /* Wind generation of the wind reporter or 0 if not available yet */
+  static int currentWindGeneration();
+
   /* NM from start */
   float distanceTopOfClimb = map::INVALID_DISTANCE_VALUE, distanceTopOfDescent = map::INVALID_DISTANCE_VALUE;
 
@@ -501,6 +513,12 @@ private:
   /* Contains a list of messages if the calculation result violates altitude restrictions
    * which can happen if the cruise altitude is too low */
   QStringList errors;
+
+  /* Input values used for the last calculation. Empty if calculation has to be done. */
+  QVector<float> calculatedSignature;
+
+  /* Wind generation from WindReporter used for the last calculation. -1 if none. */
+  int calculatedWindGeneration = -1;
 };
 
 QDebug operator<<(QDebug out, const RouteAltitude& obj);
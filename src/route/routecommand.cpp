@@ -18,6 +18,9 @@
 #include "route/routecommand.h"
 #include "route/routecontroller.h"
 
+using atools::fs::pln::Flightplan;
+using atools::fs::pln::FlightplanEntry;
+
 RouteCommand::RouteCommand(RouteController *routeController,
                            const atools::fs::pln::Flightplan& flightplanBefore, const QString& text,
                            rctype::RouteCmdType rcType)
@@ -33,12 +36,38 @@ RouteCommand::~RouteCommand()
 
 void RouteCommand::setFlightplanAfter(const atools::fs::pln::Flightplan& flightplanAfter)
 {
-  planAfterChange = flightplanAfter;
+  const Flightplan& before = planBeforeChange;
+  const Flightplan& after = flightplanAfter;
+
+  // Find length of common head and tail =====================================
+  int minSize = std::min(before.size(), after.size());
+  int head = 0;
+  while(head < minSize && entriesEqual(before.at(head), after.at(head)))
+    head++;
+
+  int tail = 0;
+  while(tail < minSize - head && entriesEqual(before.at(before.size() - 1 - tail), after.at(after.size() - 1 - tail)))
+    tail++;
+
+  // Undo replaces changed range in plan after with entries from plan before
+  deltaUndo.index = head;
+  deltaUndo.numRemove = after.size() - tail - head;
+  deltaUndo.entries = before.mid(head, before.size() - tail - head);
+  deltaUndo.header = headerOf(before);
+
+  // Redo does the reverse
+  deltaRedo.index = head;
+  deltaRedo.numRemove = before.size() - tail - head;
+  deltaRedo.entries = after.mid(head, after.size() - tail - head);
+  deltaRedo.header = headerOf(after);
+
+  // Not needed anymore
+  planBeforeChange = Flightplan();
 }
 
 void RouteCommand::undo()
 {
-  controller->changeRouteUndo(planBeforeChange);
+  controller->changeRouteUndo(deltaUndo);
 }
 
 void RouteCommand::redo()
@@ -47,5 +76,24 @@ void RouteCommand::redo()
     // Skip first redo - I need to do the initial changes myself
     firstRedoExecuted = true;
   else
-    controller->changeRouteRedo(planAfterChange);
+    controller->changeRouteRedo(deltaRedo);
+}
+
+Flightplan RouteCommand::headerOf(const Flightplan& flightplan)
+{
+  Flightplan header(flightplan);
+  header.clear();
+  return header;
+}
+
+bool RouteCommand::entriesEqual(const FlightplanEntry& entry1, const FlightplanEntry& entry2)
+{
+  return entry1.getWaypointType() == entry2.getWaypointType() &&
+         entry1.getFlags() == entry2.getFlags() &&
+         entry1.getIdent() == entry2.getIdent() &&
+         entry1.getRegion() == entry2.getRegion() &&
+         entry1.getAirway() == entry2.getAirway() &&
+         entry1.getName() == entry2.getName() &&
+         entry1.getComment() == entry2.getComment() &&
+         entry1.getPosition().almostEqual(entry2.getPosition());
 }
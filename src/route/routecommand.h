@@ -25,9 +25,23 @@
 
 class RouteController;
 
+/*
+ * Structural difference between two flight plans not containing procedure entries.
+ * Applying means replacing the entries in range [index, index + numRemove) in the current plan with entries and
+ * taking all other fields and properties from header.
+ */
+struct RouteDelta
+{
+  int index = 0, numRemove = 0;
+  QList<atools::fs::pln::FlightplanEntry> entries;
+
+  /* Plan without entries */
+  atools::fs::pln::Flightplan header;
+};
+
 /*
  * Flight plan undo command including a few workaround for QUndoCommand inflexibilities.
- * Keeps a copy of the flight plan before and after the change.
+ * Keeps only the changed range of entries and the header fields for undo and redo.
  */
 class RouteCommand :
   public QUndoCommand
@@ -40,15 +54,26 @@ public:
   virtual void undo() override;
   virtual void redo() override;
 
-  /* Need to keep both versions in a redundant way since linking between commands is not reliable */
+  /* Need to keep both versions in a redundant way since linking between commands is not reliable.
+   * Calculates the deltas for undo and redo and drops the copy of the plan before. */
   void setFlightplanAfter(const atools::fs::pln::Flightplan& flightplanAfter);
 
 private:
+  /* Create a copy of the plan without entries */
+  static atools::fs::pln::Flightplan headerOf(const atools::fs::pln::Flightplan& flightplan);
+
+  /* Compare all fields which are not updated by recalculation. Altitude is ignored. */
+  static bool entriesEqual(const atools::fs::pln::FlightplanEntry& entry1, const atools::fs::pln::FlightplanEntry& entry2);
+
   /* Avoid the first redo action when inserting the command. This not usable for complex interactions. */
   bool firstRedoExecuted = false;
   RouteController *controller;
   rctype::RouteCmdType type;
-  atools::fs::pln::Flightplan planBeforeChange, planAfterChange;
+
+  /* Only valid between constructor and setFlightplanAfter() */
+  atools::fs::pln::Flightplan planBeforeChange;
+
+  RouteDelta deltaUndo, deltaRedo;
 };
 
 #endif // LITTLENAVMAP_ROUTECOMMAND_H
@@ -829,8 +829,8 @@ void RouteController::windUpdated()
 
   if(!route.isEmpty())
   {
-    // Get type, speed and cruise altitude from widgets
-    route.updateLegAltitudes();
+    // Recalculates only trip values if profile is not affected by new wind
+    route.updateLegAltitudesWind();
 
     updateModelTimeFuelWindAlt();
     updateModelHighlightsAndErrors();
@@ -3237,24 +3237,24 @@ void RouteController::tableSelectionChanged(const QItemSelection&, const QItemSe
     emit showPos(route.value(selectionModel->currentIndex().row()).getPosition(), map::INVALID_DISTANCE_VALUE, false /* doubleClick */);
 }
 
-void RouteController::changeRouteUndo(const atools::fs::pln::Flightplan& newFlightplan)
+void RouteController::changeRouteUndo(const RouteDelta& delta)
 {
   // Keep our own index as a workaround
   undoIndex--;
 
   qDebug() << "changeRouteUndo undoIndex" << undoIndex << "undoIndexClean" << undoIndexClean;
-  changeRouteUndoRedo(newFlightplan);
+  changeRouteUndoRedo(delta);
 }
 
-void RouteController::changeRouteRedo(const atools::fs::pln::Flightplan& newFlightplan)
+void RouteController::changeRouteRedo(const RouteDelta& delta)
 {
   // Keep our own index as a workaround
   undoIndex++;
   qDebug() << "changeRouteRedo undoIndex" << undoIndex << "undoIndexClean" << undoIndexClean;
-  changeRouteUndoRedo(newFlightplan);
+  changeRouteUndoRedo(delta);
 }
 
-void RouteController::changeRouteUndoRedo(const atools::fs::pln::Flightplan& newFlightplan)
+void RouteController::changeRouteUndoRedo(const RouteDelta& delta)
 {
   int currentRow = tableViewRoute->currentIndex().isValid() ? tableViewRoute->currentIndex().row() : -1;
 
@@ -3262,12 +3262,34 @@ void RouteController::changeRouteUndoRedo(const atools::fs::pln::Flightplan& new
   atools::util::ContextSaverBool saver(ignoreFollowSelection);
 
   clearAllErrors();
-  route.clearAll();
-  route.setFlightplan(newFlightplan);
 
-  // Change format in plan according to last saved format
-  route.createRouteLegsFromFlightplan();
-  loadProceduresFromFlightplan(false /* clearOldProcedureProperties */, false /* cleanupRoute */, false /* autoresolveTransition */);
+  if(!changeRouteUndoRedoInPlace(delta))
+  {
+    // Build the new plan from the current one without procedures and the delta =================
+    Flightplan current = route.getFlightplanConst();
+    current.removeProcedureEntries();
+
+    if(delta.index + delta.numRemove > current.size())
+    {
+      // Should never happen since the undo stack is always in sync with the plan
+      qWarning() << Q_FUNC_INFO << "Invalid delta index" << delta.index << "numRemove" << delta.numRemove
+                 << "plan size" << current.size();
+      return;
+    }
+
+    Flightplan newFlightplan(delta.header);
+    newFlightplan.append(current.mid(0, delta.index));
+    newFlightplan.append(delta.entries);
+    newFlightplan.append(current.mid(delta.index + delta.numRemove));
+
+    route.clearAll();
+    route.setFlightplan(newFlightplan);
+
+    // Change format in plan according to last saved format
+    route.createRouteLegsFromFlightplan();
+    loadProceduresFromFlightplan(false /* clearOldProcedureProperties */, false /* cleanupRoute */, false /* autoresolveTransition */);
+  }
+
   route.updateAll();
   route.updateAirwaysAndAltitude(false /* adjustRouteAltitude */);
   route.updateLegAltitudes();
@@ -3289,6 +3311,72 @@ void RouteController::changeRouteUndoRedo(const atools::fs::pln::Flightplan& new
   emit routeChanged(true /* geometryChanged */);
 }
 
+bool RouteController::changeRouteUndoRedoInPlace(const RouteDelta& delta)
+{
+  const Flightplan& flightplan = route.getFlightplanConst();
+
+  // Procedures are defined by properties - need to reload if these change
+  if(flightplan.getPropertiesConst() != delta.header.getPropertiesConst())
+    return false;
+
+  // Map indexes of plan without procedures to route indexes and find destination =================
+  QVector<int> planToRouteIndex;
+  int destinationIndex = -1;
+  for(int i = 0; i < flightplan.size(); i++)
+  {
+    const FlightplanEntry& entry = flightplan.at(i);
+    if(!(entry.getFlags() & atools::fs::pln::entry::PROCEDURE))
+    {
+      if(!(entry.getFlags() & atools::fs::pln::entry::ALTERNATE))
+        destinationIndex = planToRouteIndex.size();
+      planToRouteIndex.append(i);
+    }
+  }
+
+  // Departure, destination and alternates have to stay untouched ===================
+  if(delta.index < 1 || delta.index + delta.numRemove >= destinationIndex)
+    return false;
+
+  // En-route legs are consecutive in the route without any procedure legs in between
+  int routeIndex = planToRouteIndex.at(delta.index);
+  for(int i = 1; i <= delta.numRemove; i++)
+  {
+    if(planToRouteIndex.at(delta.index + i) != routeIndex + i)
+      return false;
+  }
+
+#ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << "routeIndex" << routeIndex << "numRemove" << delta.numRemove << "insert" << delta.entries.size();
+#endif
+
+  // Take header fields from delta and keep all entries including procedures ============
+  Flightplan newFlightplan(delta.header);
+  newFlightplan.append(flightplan.mid(0, routeIndex));
+  newFlightplan.append(delta.entries);
+  newFlightplan.append(flightplan.mid(routeIndex + delta.numRemove));
+  route.setFlightplan(newFlightplan);
+
+  // Avoid callback selection changed which can result in crashes due to inconsistent route
+  blockModel();
+
+  // Remove and create only the changed legs - all other legs keep their database objects
+  for(int i = 0; i < delta.numRemove; i++)
+    route.removeLegAt(routeIndex);
+
+  for(int i = 0; i < delta.entries.size(); i++)
+  {
+    int index = routeIndex + i;
+    RouteLeg routeLeg(&route.getFlightplan());
+    routeLeg.createFromDatabaseByEntry(index, &route.value(index - 1));
+    route.insert(index, routeLeg);
+  }
+
+  unBlockModel();
+
+  route.updateIndicesAndOffsets();
+  return true;
+}
+
 void RouteController::styleChanged()
 {
   tabHandlerRoute->styleChanged();
@@ -62,6 +62,7 @@ class QTableView;
 class QTextCursor;
 class RouteCalcDialog;
 class RouteCommand;
+struct RouteDelta;
 class RouteLabel;
 class SymbolPainter;
 class UnitStringTool;
@@ -381,10 +382,10 @@ private:
   bool saveFlightplanLnmSelectionAs(const QString& filename, int from, int to) const;
 
   /* Called by undo command */
-  void changeRouteUndo(const atools::fs::pln::Flightplan& newFlightplan);
+  void changeRouteUndo(const RouteDelta& delta);
 
   /* Called by undo command */
-  void changeRouteRedo(const atools::fs::pln::Flightplan& newFlightplan);
+  void changeRouteRedo(const RouteDelta& delta);
 
   /* Save undo state before and after change */
   RouteCommand *preChange(const QString& text = QString(), rctype::RouteCmdType rcType = rctype::EDIT);
@@ -448,8 +449,12 @@ private:
   void updateFlightplanFromWidgets(atools::fs::pln::Flightplan& flightplan);
   void updateFlightplanFromWidgets();
 
-  /* Used by undo/redo */
-  void changeRouteUndoRedo(const atools::fs::pln::Flightplan& newFlightplan);
+  /* Used by undo/redo. Applies the delta in place if possible or rebuilds the whole route otherwise. */
+  void changeRouteUndoRedo(const RouteDelta& delta);
+
+  /* Apply delta to route legs and flight plan entries if only en-route legs are affected and procedures
+   * are not changed. Returns false if route has to be rebuilt. */
+  bool changeRouteUndoRedoInPlace(const RouteDelta& delta);
 
   void tableCopyClipboardTriggered();
 
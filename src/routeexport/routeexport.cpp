@@ -41,12 +41,30 @@
 
 #include <QBitArray>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QProcessEnvironment>
 #include <QXmlStreamReader>
 #include <QStringBuilder>
+#include <QSaveFile>
+#include <QTemporaryDir>
+#include <QtConcurrent/QtConcurrentMap>
 
 using atools::fs::pln::FlightplanIO;
 
+/* Flight plan file export collected during multiexport and written in a background thread */
+struct RouteExport::ExportJob
+{
+  QString filename;
+  atools::fs::pln::Flightplan flightplan;
+  ExportFuncType exportFunc;
+
+  /* Format type for formatExportedCallback() once the file is written or -1 */
+  int formatType;
+
+  /* Set by the background thread if the export failed */
+  std::exception_ptr exception;
+};
+
 RouteExport::RouteExport(MainWindow *parent)
   : mainWindow(parent)
 {
@@ -62,10 +80,16 @@ RouteExport::RouteExport(MainWindow *parent)
   connect(multiExportDialog, &RouteMultiExportDialog::saveSelectedButtonClicked, this, &RouteExport::routeMultiExport);
 
   connect(NavApp::navAppInstance(), &QGuiApplication::fontChanged, multiExportDialog, &RouteMultiExportDialog::fontChanged);
+
+  // Background file writing for multiexport finished
+  connect(&exportWatcher, &QFutureWatcher<void>::finished, this, &RouteExport::routeMultiExportFinished);
 }
 
 RouteExport::~RouteExport()
 {
+  qDebug() << Q_FUNC_INFO << "wait for export jobs";
+  exportWatcher.waitForFinished();
+
   qDebug() << Q_FUNC_INFO << "delete exportAllDialog";
   delete multiExportDialog;
   multiExportDialog = nullptr;
@@ -111,11 +135,33 @@ void RouteExport::exportType(RouteExportFormat format)
 
 void RouteExport::formatExportedCallback(const RouteExportFormat& format, const QString& filename)
 {
-  exported.insert(format.getType(), filename);
+  if(multiExportRunning && exportJobIndex.contains(filename))
+  {
+    // File is written later in background - report in routeMultiExportFinished()
+    ExportJobList& jobs = exportJobs[exportJobIndex.value(filename)];
+    if(!jobs.isEmpty())
+      jobs.last().formatType = format.getType();
+  }
+  else
+    exported.insert(format.getType(), filename);
+}
+
+void RouteExport::statusMessage(const QString& message)
+{
+  if(!multiExportRunning)
+    mainWindow->setStatusMessage(message);
 }
 
 void RouteExport::routeMultiExport()
 {
+  if(exportWatcher.isRunning())
+  {
+    // Export again with the current flight plan once the running export is done
+    multiExportPending = true;
+    mainWindow->setStatusMessage(tr("Flight plan export still running. Exporting again when done."));
+    return;
+  }
+
   exported.clear();
 
   // Collect path errors first =======================
@@ -145,22 +191,132 @@ void RouteExport::routeMultiExport()
     if(routeValidate(exportFormatMap->getSelected(), true /* multi */))
     {
       // Export all button or menu item
-      int numExported = 0;
+      // Formats using FlightplanIO are only collected in exportJobs and written in background threads.
+      // Adjusted routes are shared between formats using the same options.
+      QElapsedTimer timer;
+      timer.start();
+      exportJobs.clear();
+      exportJobIndex.clear();
+      multiExportRunning = true;
+      numMultiExported = 0;
       for(const RouteExportFormat& fmt : exportFormatMap->getSelected())
       {
         if(fmt.isSelected() && fmt.isPathValid() && fmt.isPatternValid())
-          numExported += fmt.copyForMultiSave().callExport();
+          numMultiExported += fmt.copyForMultiSave().callExport();
       }
-      if(numExported == 0)
-        mainWindow->setStatusMessage(tr("No flight plan exported."));
+      multiExportRunning = false;
+      adjustedRouteCache.clear();
+
+      qDebug() << Q_FUNC_INFO << "Prepared" << numMultiExported << "formats with" << exportJobs.size() << "background jobs in"
+               << timer.elapsed() << "ms";
+
+      if(exportJobs.isEmpty())
+        routeMultiExportFinished();
       else
-        mainWindow->setStatusMessage(tr("Exported %1 flight plans.").arg(numExported));
+      {
+        mainWindow->setStatusMessage(tr("Exporting %1 flight plans ...").arg(numMultiExported));
+        exportWatcher.setFuture(QtConcurrent::map(exportJobs, &RouteExport::exportJobThread));
+      }
     }
+  }
+}
+
+void RouteExport::exportJobThread(ExportJobList& jobs)
+{
+  // Jobs for the same file are run one after the other in order of collection
+  for(ExportJob& job : jobs)
+  {
+    try
+    {
+      // Let FlightplanIO write into a temporary folder since it opens the file on its own.
+      // Copy the result using QSaveFile which replaces the target atomically when committing.
+      // Keeps the filename which is used by some formats.
+      QFileInfo fileinfo(job.filename);
+      QTemporaryDir tempDir;
+
+      if(tempDir.isValid())
+      {
+        FlightplanIO flightplanIO;
+        QString tempFilename = tempDir.filePath(fileinfo.fileName());
+        job.exportFunc(flightplanIO, job.flightplan, tempFilename);
 
-    // Check if native LNMPLN was exported, update filename and change status of the file if
-    if(exported.contains(rexp::LNMPLN))
-      mainWindow->routeSaveLnmExported(exported.value(rexp::LNMPLN));
-    exported.clear();
+        QFile tempFile(tempFilename);
+        if(!tempFile.open(QIODevice::ReadOnly))
+          throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2").arg(tempFilename).arg(tempFile.errorString()));
+
+        QSaveFile saveFile(job.filename);
+        if(!saveFile.open(QIODevice::WriteOnly))
+          throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2").arg(job.filename).arg(saveFile.errorString()));
+
+        saveFile.write(tempFile.readAll());
+        if(!saveFile.commit())
+          throw atools::Exception(tr("Cannot write file \"%1\". Reason: %2").arg(job.filename).arg(saveFile.errorString()));
+      }
+      else
+      {
+        // No temporary folder available - write file directly
+        qWarning() << Q_FUNC_INFO << "Cannot create temporary folder" << tempDir.errorString();
+        FlightplanIO flightplanIO;
+        job.exportFunc(flightplanIO, job.flightplan, job.filename);
+      }
+    }
+    catch(...)
+    {
+      // Report in main thread
+      job.exception = std::current_exception();
+    }
+  }
+}
+
+void RouteExport::routeMultiExportFinished()
+{
+  // Show errors from background jobs in main thread and report written files
+  int numErrors = 0;
+  for(const ExportJobList& jobs : qAsConst(exportJobs))
+  {
+    for(const ExportJob& job : jobs)
+    {
+      if(job.exception)
+      {
+        numErrors++;
+        qWarning() << Q_FUNC_INFO << "Export failed for" << job.filename;
+
+        try
+        {
+          std::rethrow_exception(job.exception);
+        }
+        catch(atools::Exception& e)
+        {
+          atools::gui::ErrorHandler(mainWindow).handleException(e);
+        }
+        catch(...)
+        {
+          atools::gui::ErrorHandler(mainWindow).handleUnknownException();
+        }
+      }
+      else if(job.formatType != -1)
+        exported.insert(job.formatType, job.filename);
+    }
+  }
+  exportJobs.clear();
+  exportJobIndex.clear();
+
+  int numExported = numMultiExported - numErrors;
+  if(numExported <= 0)
+    mainWindow->setStatusMessage(tr("No flight plan exported."));
+  else
+    mainWindow->setStatusMessage(tr("Exported %1 flight plans.").arg(numExported));
+
+  // Check if native LNMPLN was exported, update filename and change status of the file if
+  if(exported.contains(rexp::LNMPLN))
+    mainWindow->routeSaveLnmExported(exported.value(rexp::LNMPLN));
+  exported.clear();
+
+  if(multiExportPending)
+  {
+    // Save All was triggered again while writing
+    multiExportPending = false;
+    routeMultiExport();
   }
 }
 
@@ -326,20 +482,20 @@ bool RouteExport::routeExportInternalPln(const RouteExportFormat& format)
       switch(format.getType())
       {
         case rexp::PLNANNOTATED:
-          result = exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC, std::bind(&FlightplanIO::savePlnAnnotated, flightplanIO, _1, _2));
+          result = exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC, std::bind(&FlightplanIO::savePlnAnnotated, _1, _2, _3));
           break;
 
         case rexp::PLN:
-          result = exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC, std::bind(&FlightplanIO::savePln, flightplanIO, _1, _2));
+          result = exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC, std::bind(&FlightplanIO::savePln, _1, _2, _3));
           break;
 
         case rexp::PLNMSFS:
-          result = exportFlighplan(routeFile, rf::DEFAULT_OPTS_MSFS, std::bind(&FlightplanIO::savePlnMsfs, flightplanIO, _1, _2));
+          result = exportFlighplan(routeFile, rf::DEFAULT_OPTS_MSFS, std::bind(&FlightplanIO::savePlnMsfs, _1, _2, _3));
           break;
 
         case rexp::PLNISG:
           result = exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::ISG_USER_WP_NAMES | rf::REMOVE_RUNWAY_PROC,
-                                   std::bind(&FlightplanIO::savePlnIsg, flightplanIO, _1, _2));
+                                   std::bind(&FlightplanIO::savePlnIsg, _1, _2, _3));
           break;
 
         default:
@@ -348,8 +504,8 @@ bool RouteExport::routeExportInternalPln(const RouteExportFormat& format)
 
       if(result)
       {
-        mainWindow->setStatusMessage(tr("Flight plan saved as %1PLN.").
-                                     arg(format.getType() == rexp::PLNANNOTATED ? tr("annotated ") : QString()));
+        statusMessage(tr("Flight plan saved as %1PLN.").
+                        arg(format.getType() == rexp::PLNANNOTATED ? tr("annotated ") : QString()));
         formatExportedCallback(format, routeFile);
         return true;
       }
@@ -369,9 +525,9 @@ bool RouteExport::routeExportFms3IniBuildsMulti(const RouteExportFormat& format)
     {
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_FMS3 | rf::REMOVE_RUNWAY_PROC,
-                         std::bind(&FlightplanIO::saveIniBuildsMsfs, flightplanIO, _1, _2)))
+                         std::bind(&FlightplanIO::saveIniBuildsMsfs, _1, _2, _3)))
       {
-        mainWindow->setStatusMessage(tr("Flight plan saved as FMS 3."));
+        statusMessage(tr("Flight plan saved as FMS 3."));
         formatExportedCallback(format, routeFile);
         return true;
       }
@@ -390,9 +546,9 @@ bool RouteExport::routeExportFms3Multi(const RouteExportFormat& format)
     if(!routeFile.isEmpty())
     {
       using namespace std::placeholders;
-      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_FMS3, std::bind(&FlightplanIO::saveFms3, flightplanIO, _1, _2)))
+      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_FMS3, std::bind(&FlightplanIO::saveFms3, _1, _2, _3)))
       {
-        mainWindow->setStatusMessage(tr("Flight plan saved as FMS 3."));
+        statusMessage(tr("Flight plan saved as FMS 3."));
         formatExportedCallback(format, routeFile);
         return true;
       }
@@ -411,9 +567,9 @@ bool RouteExport::routeExportCivaFmsMulti(const RouteExportFormat& format)
     if(!routeFile.isEmpty())
     {
       using namespace std::placeholders;
-      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_CIVA_FMS, std::bind(&FlightplanIO::saveCivaFms, flightplanIO, _1, _2)))
+      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_CIVA_FMS, std::bind(&FlightplanIO::saveCivaFms, _1, _2, _3)))
       {
-        mainWindow->setStatusMessage(tr("Flight plan saved for CIVA Navigation System."));
+        statusMessage(tr("Flight plan saved for CIVA Navigation System."));
         formatExportedCallback(format, routeFile);
         return true;
       }
@@ -446,9 +602,9 @@ bool RouteExport::routeExportFms11(const RouteExportFormat& format)
     if(!routeFile.isEmpty())
     {
       using namespace std::placeholders;
-      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_FMS11, std::bind(&FlightplanIO::saveFms11, flightplanIO, _1, _2)))
+      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_FMS11, std::bind(&FlightplanIO::saveFms11, _1, _2, _3)))
       {
-        mainWindow->setStatusMessage(tr("Flight plan saved as FMS 11."));
+        statusMessage(tr("Flight plan saved as FMS 11."));
         formatExportedCallback(format, routeFile);
         return true;
       }
@@ -491,7 +647,7 @@ bool RouteExport::routeExportInternalFlp(const RouteExportFormat& format, bool c
           exportFunc = &FlightplanIO::saveCrjFlp;
       }
 
-      if(exportFlighplan(routeFile, options, std::bind(exportFunc, flightplanIO, _1, _2)))
+      if(exportFlighplan(routeFile, options, std::bind(exportFunc, _1, _2, _3)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -517,7 +673,7 @@ bool RouteExport::routeExportFlightgear(const RouteExportFormat& format)
     if(!routeFile.isEmpty())
     {
       using namespace std::placeholders;
-      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS, std::bind(&FlightplanIO::saveFlightGear, flightplanIO, _1, _2)))
+      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS, std::bind(&FlightplanIO::saveFlightGear, _1, _2, _3)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -671,7 +827,7 @@ bool RouteExport::routeExportRteMulti(const RouteExportFormat& format)
     {
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC,
-                         std::bind(&FlightplanIO::saveRte, flightplanIO, _1, _2)))
+                         std::bind(&FlightplanIO::saveRte, _1, _2, _3)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -694,7 +850,7 @@ bool RouteExport::routeExportFprMulti(const RouteExportFormat& format)
     {
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC,
-                         std::bind(&FlightplanIO::saveFpr, flightplanIO, _1, _2)))
+                         std::bind(&FlightplanIO::saveFpr, _1, _2, _3)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -758,7 +914,7 @@ bool RouteExport::routeExportFltplanMulti(const RouteExportFormat& format)
     {
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC,
-                         std::bind(&FlightplanIO::saveFltplan, flightplanIO, _1, _2)))
+                         std::bind(&FlightplanIO::saveFltplan, _1, _2, _3)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -844,7 +1000,7 @@ bool RouteExport::routeExportBbsMulti(const RouteExportFormat& format)
     {
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC,
-                         std::bind(&FlightplanIO::saveBbsPln, flightplanIO, _1, _2)))
+                         std::bind(&FlightplanIO::saveBbsPln, _1, _2, _3)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -868,7 +1024,7 @@ bool RouteExport::routeExportFeelthereFplMulti(const RouteExportFormat& format)
 
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC,
-                         std::bind(&FlightplanIO::saveFeelthereFpl, flightplanIO, _1, _2, groundSpeed)))
+                         std::bind(&FlightplanIO::saveFeelthereFpl, _1, _2, _3, groundSpeed)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -888,7 +1044,7 @@ bool RouteExport::routeExportLeveldRteMulti(const RouteExportFormat& format)
     {
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC,
-                         std::bind(&FlightplanIO::saveLeveldRte, flightplanIO, _1, _2)))
+                         std::bind(&FlightplanIO::saveLeveldRte, _1, _2, _3)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -910,7 +1066,7 @@ bool RouteExport::routeExportEfbrMulti(const RouteExportFormat& format)
       QString cycle = NavApp::getDatabaseAiracCycleNav();
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC,
-                         std::bind(&FlightplanIO::saveEfbr, flightplanIO, _1, _2, route, cycle, QString(), QString())))
+                         std::bind(&FlightplanIO::saveEfbr, _1, _2, _3, route, cycle, QString(), QString())))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -930,7 +1086,7 @@ bool RouteExport::routeExportQwRteMulti(const RouteExportFormat& format)
     {
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC,
-                         std::bind(&FlightplanIO::saveQwRte, flightplanIO, _1, _2)))
+                         std::bind(&FlightplanIO::saveQwRte, _1, _2, _3)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -950,7 +1106,7 @@ bool RouteExport::routeExportMdrMulti(const RouteExportFormat& format)
     {
       using namespace std::placeholders;
       if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC,
-                         std::bind(&FlightplanIO::saveMdr, flightplanIO, _1, _2)))
+                         std::bind(&FlightplanIO::saveMdr, _1, _2, _3)))
       {
         formatExportedCallback(format, routeFile);
         return true;
@@ -1005,25 +1161,13 @@ bool RouteExport::routeExportIflyMulti(const RouteExportFormat& format)
     QString routeFile = exportFileMulti(format);
     if(!routeFile.isEmpty())
     {
-      try
-      {
-        flightplanIO->saveIfly(buildAdjustedRoute(rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC).getFlightplanConst(), routeFile);
-      }
-      catch(atools::Exception& e)
-      {
-        NavApp::closeSplashScreen();
-        atools::gui::ErrorHandler(mainWindow).handleException(e);
-        return false;
-      }
-      catch(...)
+      using namespace std::placeholders;
+      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_NO_PROC | rf::REMOVE_RUNWAY_PROC,
+                         std::bind(&FlightplanIO::saveIfly, _1, _2, _3)))
       {
-        NavApp::closeSplashScreen();
-        atools::gui::ErrorHandler(mainWindow).handleUnknownException();
-        return false;
+        formatExportedCallback(format, routeFile);
+        return true;
       }
-
-      formatExportedCallback(format, routeFile);
-      return true;
     }
   }
   return false;
@@ -1037,25 +1181,13 @@ bool RouteExport::routeExportPms50Multi(const RouteExportFormat& format)
     QString routeFile = exportFileMulti(format);
     if(!routeFile.isEmpty())
     {
-      try
-      {
-        flightplanIO->savePlnMsfs(buildAdjustedRoute(rf::DEFAULT_OPTS_MSFS | rf::REMOVE_RUNWAY_PROC).getFlightplanConst(), routeFile);
-      }
-      catch(atools::Exception& e)
-      {
-        NavApp::closeSplashScreen();
-        atools::gui::ErrorHandler(mainWindow).handleException(e);
-        return false;
-      }
-      catch(...)
+      using namespace std::placeholders;
+      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS_MSFS | rf::REMOVE_RUNWAY_PROC,
+                         std::bind(&FlightplanIO::savePlnMsfs, _1, _2, _3)))
       {
-        NavApp::closeSplashScreen();
-        atools::gui::ErrorHandler(mainWindow).handleUnknownException();
-        return false;
+        formatExportedCallback(format, routeFile);
+        return true;
       }
-
-      formatExportedCallback(format, routeFile);
-      return true;
     }
   }
   return false;
@@ -1069,26 +1201,13 @@ bool RouteExport::routeExportIsgMulti(const RouteExportFormat& format)
     QString routeFile = exportFileMulti(format);
     if(!routeFile.isEmpty())
     {
-      try
-      {
-        Route route = buildAdjustedRoute(rf::DEFAULT_OPTS | rf::ISG_USER_WP_NAMES);
-        flightplanIO->savePlnIsg(route.getFlightplanConst(), routeFile);
-      }
-      catch(atools::Exception& e)
-      {
-        NavApp::closeSplashScreen();
-        atools::gui::ErrorHandler(mainWindow).handleException(e);
-        return false;
-      }
-      catch(...)
+      using namespace std::placeholders;
+      if(exportFlighplan(routeFile, rf::DEFAULT_OPTS | rf::ISG_USER_WP_NAMES,
+                         std::bind(&FlightplanIO::savePlnIsg, _1, _2, _3)))
       {
-        NavApp::closeSplashScreen();
-        atools::gui::ErrorHandler(mainWindow).handleUnknownException();
-        return false;
+        formatExportedCallback(format, routeFile);
+        return true;
       }
-
-      formatExportedCallback(format, routeFile);
-      return true;
     }
   }
   return false;
@@ -1561,8 +1680,9 @@ bool RouteExport::exportFlighplanAsRxpGns(const QString& filename, bool saveAsUs
 
   try
   {
-    // Regions are required for the export
+    // Regions are required for the export - routes cached for multiexport do not have them
     NavApp::getRoute().updateAirportRegions();
+    adjustedRouteCache.clear();
     FlightplanIO().saveGarminFpl(buildAdjustedRoute(rf::DEFAULT_OPTS_NO_PROC).getFlightplanConst(), filename,
                                  saveAsUserWaypoints);
   }
@@ -1814,13 +1934,23 @@ bool RouteExport::exportFlighplanAsIvap(const RouteExportData& exportData, const
   }
 }
 
-bool RouteExport::exportFlighplan(const QString& filename, rf::RouteAdjustOptions options,
-                                  std::function<void(const atools::fs::pln::Flightplan& plan,
-                                                     const QString& file)> exportFunc)
+bool RouteExport::exportFlighplan(const QString& filename, rf::RouteAdjustOptions options, ExportFuncType exportFunc)
 {
   try
   {
-    exportFunc(buildAdjustedRoute(options).getFlightplanConst(), filename);
+    if(multiExportRunning)
+    {
+      // Write file later in background thread - jobs writing the same file are run in the same thread
+      if(!exportJobIndex.contains(filename))
+      {
+        exportJobIndex.insert(filename, exportJobs.size());
+        exportJobs.append(ExportJobList());
+      }
+      exportJobs[exportJobIndex.value(filename)].append({filename, buildAdjustedRoute(options).getFlightplanConst(),
+                                                         exportFunc, -1, nullptr});
+    }
+    else
+      exportFunc(*flightplanIO, buildAdjustedRoute(options).getFlightplanConst(), filename);
   }
   catch(atools::Exception& e)
   {
@@ -2053,6 +2183,10 @@ Route RouteExport::buildAdjustedRoute(rf::RouteAdjustOptions options)
       options |= rf::SAVE_AIRWAY_WP;
   }
 
+  // Reuse routes for formats with the same options while running multiexport
+  if(multiExportRunning && adjustedRouteCache.contains(static_cast<int>(options)))
+    return adjustedRouteCache.value(static_cast<int>(options));
+
   Route adjustedRoute = NavApp::getRouteConst().updatedAltitudes().adjustedToOptions(options);
 
   // Update airway structures
@@ -2061,6 +2195,9 @@ Route RouteExport::buildAdjustedRoute(rf::RouteAdjustOptions options)
   atools::fs::pln::Flightplan& routeFlightplan = adjustedRoute.getFlightplan();
   routeFlightplan.setCruiseAltitudeFt(adjustedRoute.getCruiseAltitudeFt());
 
+  if(multiExportRunning)
+    adjustedRouteCache.insert(static_cast<int>(options), adjustedRoute);
+
   return adjustedRoute;
 }
 
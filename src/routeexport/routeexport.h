@@ -21,6 +21,7 @@
 #include "route/routeflags.h"
 #include "routeexport/routeexportflags.h"
 
+#include <QFutureWatcher>
 #include <QHash>
 #include <QObject>
 #include <functional>
@@ -52,6 +53,9 @@ class RouteExportFormatMap;
 /*
  * Covers all flight plan export and export related functions including validation and warning dialogs.
  *
+ * Multiexport prepares all formats in the main thread and shares adjusted routes between formats having the
+ * same options. Formats written by FlightplanIO are then saved concurrently in background threads.
+ *
  * Does not contain save, save as or open methods for LNMPLN.
  */
 class RouteExport :
@@ -271,9 +275,29 @@ private:
   bool exportFlighplanAsRxpGns(const QString& filename, bool saveAsUserWaypoints);
   bool exportFlighplanAsRxpGtn(const QString& filename, bool saveAsUserWaypoints, bool gfpCoordinates);
 
-  /* Generic export using callback and also doing exception handling. */
-  bool exportFlighplan(const QString& filename, rf::RouteAdjustOptions options,
-                       std::function<void(const atools::fs::pln::Flightplan&, const QString&)> exportFunc);
+  /* Export function getting a FlightplanIO instance owned by the caller, the flight plan and the filename */
+  typedef std::function<void(atools::fs::pln::FlightplanIO&, const atools::fs::pln::Flightplan&, const QString&)> ExportFuncType;
+
+  /* File export collected in multiexport */
+  struct ExportJob;
+
+  /* All jobs writing the same file */
+  typedef QVector<ExportJob> ExportJobList;
+
+  /* Generic export using callback and also doing exception handling.
+   * Only adds a job to exportJobs if multiexport is running. */
+  bool exportFlighplan(const QString& filename, rf::RouteAdjustOptions options, ExportFuncType exportFunc);
+
+  /* Runs in background thread. Writes the files of all jobs in order replacing the target atomically
+   * and stores exceptions in the jobs. */
+  static void exportJobThread(ExportJobList& jobs);
+
+  /* Called when all background jobs are done. Shows errors and status message, reports exported files
+   * and starts a pending multiexport. */
+  void routeMultiExportFinished();
+
+  /* Show status message if not collecting jobs for multiexport */
+  void statusMessage(const QString& message);
 
   /* Shows dialog for IVAP data before exporting */
   bool routeExportIvapInternal(re::RouteExportType type, const RouteExportFormat& format,
@@ -326,6 +350,21 @@ private:
   /* Filled by "formatExportedCallback" when doing a multi export using routeMultiExport() */
   QHash<int, QString> exported;
 
+  /* Jobs collected by exportFlighplan() during multiexport and the watcher for the background threads */
+  QVector<ExportJobList> exportJobs;
+  QFutureWatcher<void> exportWatcher;
+  int numMultiExported = 0;
+
+  /* Maps filename to index in exportJobs */
+  QHash<QString, int> exportJobIndex;
+
+  /* Multiexport was requested while background jobs were running */
+  bool multiExportPending = false;
+
+  /* Routes adjusted to options as key. Filled by buildAdjustedRoute() during multiexport */
+  QHash<int, Route> adjustedRouteCache;
+  bool multiExportRunning = false;
+
   /* true if any formats are selected for multiexport */
   bool selected = false;
 
@@ -0,0 +1,191 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "routestring/routestringbatch.h"
+
+#include "app/navapp.h"
+#include "atools.h"
+#include "common/constants.h"
+#include "exception.h"
+#include "fs/pln/flightplan.h"
+#include "geo/calculations.h"
+#include "gui/errorhandler.h"
+#include "route/flightplanentrybuilder.h"
+#include "routestring/routestringreader.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringBuilder>
+#include <QTextStream>
+
+using atools::fs::pln::Flightplan;
+using atools::fs::pln::FlightplanEntry;
+
+RouteStringBatch::RouteStringBatch()
+{
+  options = rs::DEFAULT_OPTIONS;
+  options.setFlag(rs::REPORT, false);
+
+  entryBuilder = new FlightplanEntryBuilder;
+  reader = new RouteStringReader(entryBuilder);
+  reader->setPlaintextMessages(true);
+  reader->setCacheLookups(true);
+}
+
+RouteStringBatch::~RouteStringBatch()
+{
+  delete reader;
+  delete entryBuilder;
+}
+
+QVector<RouteStringBatch::Result> RouteStringBatch::parse(const QStringList& routeStrings)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  QVector<Result> results;
+  results.reserve(routeStrings.size());
+
+  int numValid = 0;
+  for(const QString& routeString : routeStrings)
+  {
+    Result result;
+    result.routeString = routeString;
+
+    Flightplan flightplan;
+    result.valid = reader->createRouteFromString(routeString, options, &flightplan);
+    result.messages = reader->getAllMessages();
+
+    // Remove empty separator lines
+    result.messages.removeAll(QString());
+
+    if(result.valid)
+    {
+      result.departureIdent = flightplan.getDepartureIdent();
+      result.destinationIdent = flightplan.getDestinationIdent();
+      result.numEntries = flightplan.size();
+      result.cruiseAltitudeFt = flightplan.getCruiseAltitudeFt();
+
+      // Sum up great circle distances between all entries
+      for(int i = 1; i < flightplan.size(); i++)
+        result.distanceNm += atools::geo::meterToNm(flightplan.at(i - 1).getPosition().distanceMeterTo(flightplan.at(i).getPosition()));
+      numValid++;
+    }
+    results.append(result);
+  }
+
+  numParsedSinceClear += routeStrings.size();
+
+  qDebug() << Q_FUNC_INFO << "Parsed" << routeStrings.size() << "route strings," << numValid << "valid in"
+           << timer.elapsed() << "ms";
+
+  return results;
+}
+
+void RouteStringBatch::clearCache()
+{
+  // Disabling deletes the cache
+  reader->setCacheLookups(false);
+  reader->setCacheLookups(true);
+  numParsedSinceClear = 0;
+}
+
+QStringList RouteStringBatch::splitLines(const QString& text)
+{
+  QStringList lines;
+  for(const QString& line : text.split('\n'))
+  {
+    QString str = line.trimmed();
+    if(!str.isEmpty() && !str.startsWith('#'))
+      lines.append(str);
+  }
+  return lines;
+}
+
+void RouteStringBatch::parseStartup(QWidget *parent)
+{
+  QString file = NavApp::getStartupOptionStr(lnm::STARTUP_PARSE_ROUTES);
+  if(!file.isEmpty())
+  {
+    qDebug() << Q_FUNC_INFO << file;
+    try
+    {
+      if(atools::checkFile(Q_FUNC_INFO, file, true /* warn */))
+      {
+        QFileInfo fileinfo(file);
+        parseFile(file, fileinfo.absolutePath() % QDir::separator() % fileinfo.completeBaseName() % "_parsed.csv");
+      }
+    }
+    catch(atools::Exception& e)
+    {
+      NavApp::closeSplashScreen();
+      atools::gui::ErrorHandler(parent).handleException(e);
+    }
+    catch(...)
+    {
+      NavApp::closeSplashScreen();
+      atools::gui::ErrorHandler(parent).handleUnknownException();
+    }
+  }
+}
+
+/* Quote CSV field if needed */
+static QString csvField(QString str)
+{
+  if(str.contains(';') || str.contains('"') || str.contains('\n'))
+    return '"' % str.replace('"', "\"\"") % '"';
+  else
+    return str;
+}
+
+void RouteStringBatch::parseFile(const QString& inputFile, const QString& outputFile)
+{
+  QStringList routeStrings;
+  QFile inFile(inputFile);
+  if(inFile.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    QTextStream stream(&inFile);
+    stream.setCodec("UTF-8");
+    routeStrings = splitLines(stream.readAll());
+    inFile.close();
+  }
+  else
+    throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2").arg(inputFile).arg(inFile.errorString()));
+
+  QVector<Result> results = RouteStringBatch().parse(routeStrings);
+
+  QFile outFile(outputFile);
+  if(outFile.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    QTextStream stream(&outFile);
+    stream.setCodec("UTF-8");
+    stream << "route;valid;departure;destination;entries;distance_nm;cruise_altitude_ft;messages" << endl;
+
+    for(const Result& result : qAsConst(results))
+      stream << csvField(result.routeString) << ';' << (result.valid ? 1 : 0) << ';'
+             << csvField(result.departureIdent) << ';' << csvField(result.destinationIdent) << ';'
+             << result.numEntries << ';' << QString::number(result.distanceNm, 'f', 1) << ';'
+             << atools::roundToInt(result.cruiseAltitudeFt) << ';' << csvField(result.messages.join(' ')) << endl;
+    outFile.close();
+    qInfo() << Q_FUNC_INFO << "Wrote" << results.size() << "results to" << outputFile;
+  }
+  else
+    throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2").arg(outputFile).arg(outFile.errorString()));
+}
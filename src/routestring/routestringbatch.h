@@ -0,0 +1,98 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_ROUTESTRINGBATCH_H
+#define LNM_ROUTESTRINGBATCH_H
+
+#include "routestring/routestringtypes.h"
+
+#include <QCoreApplication>
+#include <QVector>
+
+class RouteStringReader;
+class FlightplanEntryBuilder;
+class QWidget;
+
+/*
+ * Parses a large number of route descriptions like filed online network flight plans in one run.
+ *
+ * Uses a single RouteStringReader with lookup caching enabled. This way airports, navaids and airways
+ * are fetched only once for all route strings. The cache is kept across calls to parse() until clearCache().
+ *
+ * Has to be used in the main thread since it accesses the navdata queries.
+ */
+class RouteStringBatch
+{
+  Q_DECLARE_TR_FUNCTIONS(RouteStringBatch)
+
+public:
+  /* Result for one route string */
+  struct Result
+  {
+    QString routeString, departureIdent, destinationIdent;
+
+    /* Plain text errors and warnings */
+    QStringList messages;
+
+    int numEntries = 0;
+    float distanceNm = 0.f, cruiseAltitudeFt = 0.f;
+
+    /* true if a flight plan could be created */
+    bool valid = false;
+  };
+
+  RouteStringBatch();
+  ~RouteStringBatch();
+
+  RouteStringBatch(const RouteStringBatch& other) = delete;
+  RouteStringBatch& operator=(const RouteStringBatch& other) = delete;
+
+  /* Parse all route strings and return one result for each */
+  QVector<Result> parse(const QStringList& routeStrings);
+
+  /* Options for the reader. Final report is omitted by default. */
+  void setOptions(rs::RouteStringOptions value)
+  {
+    options = value;
+  }
+
+  /* Drop all cached airports, navaids and airways. Needed after switching the database. */
+  void clearCache();
+
+  /* Number of route strings parsed since creation or the last call of clearCache() */
+  int getNumParsedSinceClear() const
+  {
+    return numParsedSinceClear;
+  }
+
+  /* Split text into route strings. One per line while empty lines and lines starting with "#" are ignored. */
+  static QStringList splitLines(const QString& text);
+
+  /* Parses the file given by command line option and writes results to a CSV file next to it */
+  static void parseStartup(QWidget *parent);
+
+  /* Read route strings from inputFile and write results to outputFile as CSV. Throws an exception on IO errors. */
+  static void parseFile(const QString& inputFile, const QString& outputFile);
+
+private:
+  FlightplanEntryBuilder *entryBuilder;
+  RouteStringReader *reader;
+  rs::RouteStringOptions options;
+  int numParsedSinceClear = 0;
+};
+
+#endif // LNM_ROUTESTRINGBATCH_H
@@ -34,6 +34,7 @@
 #include "util/htmlbuilder.h"
 
 #include <QElapsedTimer>
+#include <QHash>
 #include <QRegularExpression>
 #include <QStringBuilder>
 
@@ -131,6 +132,24 @@ struct RouteStringReader::ParseEntry
 };
 
 // ========================================================================================
+struct RouteStringReader::LookupCache
+{
+  /* Key is item plus waypoint matching flag */
+  QHash<QString, MapResult> waypointResults;
+
+  /* Key is airport ident */
+  QHash<QString, map::MapAirport> airports;
+
+  /* Key is airway and waypoint name plus track usage flag */
+  QHash<QString, QList<map::MapWaypoint> > airwayWaypoints;
+
+  /* Key is airway name plus track usage flag */
+  QHash<QString, QList<map::MapAirwayWaypoint> > airwayWaypointLists;
+
+  /* Key is both waypoint ids and airway name plus track usage flag */
+  QHash<QString, QList<map::MapAirway> > waypointAirways;
+};
+
 RouteStringReader::RouteStringReader(FlightplanEntryBuilder *flightplanEntryBuilder)
   : entryBuilder(flightplanEntryBuilder)
 {
@@ -149,6 +168,18 @@ RouteStringReader::~RouteStringReader()
 {
   delete airwayQuery;
   delete waypointQuery;
+  delete lookupCache;
+}
+
+void RouteStringReader::setCacheLookups(bool value)
+{
+  if(value && lookupCache == nullptr)
+    lookupCache = new LookupCache;
+  else if(!value)
+  {
+    delete lookupCache;
+    lookupCache = nullptr;
+  }
 }
 
 bool RouteStringReader::createRouteFromString(const QString& routeString, rs::RouteStringOptions options,
@@ -162,7 +193,8 @@ bool RouteStringReader::createRouteFromString(const QString& routeString, rs::Ro
   QElapsedTimer timer;
   timer.start();
 
-  airwayQuery->setUseTracks(!(options & rs::NO_TRACKS));
+  useTracks = !(options & rs::NO_TRACKS);
+  airwayQuery->setUseTracks(useTracks);
   waypointQuery->setUseTracks(false);
 
   logMessages.clear();
@@ -400,7 +432,7 @@ bool RouteStringReader::createRouteFromString(const QString& routeString, rs::Ro
 
               // Airway reference precedes waypoint
               QList<map::MapAirway> airways;
-              airwayQuery->getAirwaysForWaypoints(airways, lastRef.id, wp.id, item);
+              airwaysForWaypoints(airways, lastRef.id, wp.id, item);
               if(!airways.isEmpty())
                 atools::insertInto(*mapObjectRefs, insertPos,
                                    map::MapRefExt(airways.constFirst().id, map::AIRWAY, airways.constFirst().name));
@@ -458,7 +490,7 @@ bool RouteStringReader::createRouteFromString(const QString& routeString, rs::Ro
           {
             // Insert airway entry leading towards following waypoint
             QList<map::MapAirway> airways;
-            airwayQuery->getAirwaysForWaypoints(airways, lastRef.id, curRef.id, lastParseEntry->airway);
+            airwaysForWaypoints(airways, lastRef.id, curRef.id, lastParseEntry->airway);
             if(!airways.isEmpty())
               atools::insertInto(*mapObjectRefs, mapObjectRefs->size() - insertOffset,
                                  map::MapRefExt(airways.constFirst().id, map::AIRWAY, airways.constFirst().name));
@@ -840,6 +872,12 @@ void RouteStringReader::extractAirportIdentDestination(QString item, QString& ai
 
 void RouteStringReader::airportSim(map::MapAirport& airport, const QString& ident)
 {
+  if(lookupCache != nullptr && lookupCache->airports.contains(ident))
+  {
+    airport = lookupCache->airports.value(ident);
+    return;
+  }
+
   airport = map::MapAirport();
   airportQuerySim->getAirportByIdent(airport, ident);
   if(!airport.isValid())
@@ -850,6 +888,9 @@ void RouteStringReader::airportSim(map::MapAirport& airport, const QString& iden
     if(!airports.isEmpty())
       airport = airports.constFirst();
   }
+
+  if(lookupCache != nullptr)
+    lookupCache->airports.insert(ident, airport);
 }
 
 QString RouteStringReader::sidStarAbbrev(QString sid)
@@ -1377,7 +1418,7 @@ atools::geo::Pos RouteStringReader::findFirstCoordinate(const QStringList& items
           for(const map::MapWaypoint& w : qAsConst(result.waypoints))
           {
             QList<map::MapWaypoint> waypoints;
-            airwayQuery->getWaypointsForAirway(waypoints, secondItem, w.ident);
+            waypointsForAirway(waypoints, secondItem, w.ident);
             if(!waypoints.isEmpty())
               lastPos = w.getPosition();
           }
@@ -1528,7 +1569,7 @@ void RouteStringReader::filterWaypoints(MapResult& result, atools::geo::Pos& las
         {
           QList<map::MapWaypoint> waypoints;
           // Get all waypoints for first
-          airwayQuery->getWaypointsForAirway(waypoints, airwayName, waypointIdent);
+          waypointsForAirway(waypoints, airwayName, waypointIdent);
 
           if(!waypoints.isEmpty())
           {
@@ -1631,14 +1672,14 @@ void RouteStringReader::filterAirways(QList<ParseEntry>& resultList, int i)
     }
 
     // Get all waypoints for first
-    airwayQuery->getWaypointsForAirway(waypoints, airwayName, waypointNameStart);
+    waypointsForAirway(waypoints, airwayName, waypointNameStart);
 
     if(!waypoints.isEmpty())
     {
       QList<map::MapAirwayWaypoint> allAirwayWaypoints;
 
       // Get all waypoints for the airway sorted by fragment and sequence
-      airwayQuery->getWaypointListForAirwayName(allAirwayWaypoints, airwayName);
+      waypointListForAirwayName(allAirwayWaypoints, airwayName);
 
 #ifdef DEBUG_INFORMATION
       for(const map::MapAirwayWaypoint& w : qAsConst(allAirwayWaypoints))
@@ -1717,6 +1758,81 @@ void RouteStringReader::filterAirways(QList<ParseEntry>& resultList, int i)
 }
 
 void RouteStringReader::findWaypoints(MapResult& result, const QString& item, bool matchWaypoints)
+{
+  if(lookupCache != nullptr)
+  {
+    QString key = item % (matchWaypoints ? QLatin1String("|M") : QLatin1String("|"));
+    auto it = lookupCache->waypointResults.constFind(key);
+    if(it != lookupCache->waypointResults.constEnd())
+      result = it.value();
+    else
+    {
+      findWaypointsInternal(result, item, matchWaypoints);
+      lookupCache->waypointResults.insert(key, result);
+    }
+  }
+  else
+    findWaypointsInternal(result, item, matchWaypoints);
+}
+
+void RouteStringReader::waypointsForAirway(QList<map::MapWaypoint>& waypoints, const QString& airwayName,
+                                           const QString& waypointName)
+{
+  if(lookupCache != nullptr)
+  {
+    QString key = airwayName % '|' % waypointName % (useTracks ? QLatin1String("|T") : QLatin1String("|"));
+    auto it = lookupCache->airwayWaypoints.constFind(key);
+    if(it != lookupCache->airwayWaypoints.constEnd())
+      waypoints = it.value();
+    else
+    {
+      airwayQuery->getWaypointsForAirway(waypoints, airwayName, waypointName);
+      lookupCache->airwayWaypoints.insert(key, waypoints);
+    }
+  }
+  else
+    airwayQuery->getWaypointsForAirway(waypoints, airwayName, waypointName);
+}
+
+void RouteStringReader::waypointListForAirwayName(QList<map::MapAirwayWaypoint>& waypoints, const QString& airwayName)
+{
+  if(lookupCache != nullptr)
+  {
+    QString key = airwayName % (useTracks ? QLatin1String("|T") : QLatin1String("|"));
+    auto it = lookupCache->airwayWaypointLists.constFind(key);
+    if(it != lookupCache->airwayWaypointLists.constEnd())
+      waypoints = it.value();
+    else
+    {
+      airwayQuery->getWaypointListForAirwayName(waypoints, airwayName);
+      lookupCache->airwayWaypointLists.insert(key, waypoints);
+    }
+  }
+  else
+    airwayQuery->getWaypointListForAirwayName(waypoints, airwayName);
+}
+
+void RouteStringReader::airwaysForWaypoints(QList<map::MapAirway>& airways, int waypointId1, int waypointId2,
+                                            const QString& airwayName)
+{
+  if(lookupCache != nullptr)
+  {
+    QString key = QString::number(waypointId1) % '|' % QString::number(waypointId2) % '|' % airwayName %
+                  (useTracks ? QLatin1String("|T") : QLatin1String("|"));
+    auto it = lookupCache->waypointAirways.constFind(key);
+    if(it != lookupCache->waypointAirways.constEnd())
+      airways = it.value();
+    else
+    {
+      airwayQuery->getAirwaysForWaypoints(airways, waypointId1, waypointId2, airwayName);
+      lookupCache->waypointAirways.insert(key, airways);
+    }
+  }
+  else
+    airwayQuery->getAirwaysForWaypoints(airways, waypointId1, waypointId2, airwayName);
+}
+
+void RouteStringReader::findWaypointsInternal(MapResult& result, const QString& item, bool matchWaypoints)
 {
   bool searchCoords = false;
   if(item.length() > 5)
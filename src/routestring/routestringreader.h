@@ -90,6 +90,10 @@ public:
     plaintextMessages = value;
   }
 
+  /* Keep results of airport, navaid and airway lookups across calls of createRouteFromString().
+   * Used for batch parsing of many route strings. Caches are kept until disabled or the reader is deleted. */
+  void setCacheLookups(bool value);
+
   bool hasWarningMessages() const
   {
     return !warningMessages.isEmpty();
@@ -107,6 +111,9 @@ private:
   /* Internal parsing structure which holds all found potential candidates from a search */
   struct ParseEntry;
 
+  /* Lookup results shared between route strings if setCacheLookups() is enabled */
+  struct LookupCache;
+
   /* Add messages to log */
   void appendMessage(const QString& message);
   void insertMessage(const QString& message, int index);
@@ -133,6 +140,12 @@ private:
   /* Get airport or any navaid for item. Also resolves coordinate formats. Optionally tries to match position
    * to waypoints like oceaninc or confluence points.*/
   void findWaypoints(map::MapResult& result, const QString& item, bool matchWaypoints);
+  void findWaypointsInternal(map::MapResult& result, const QString& item, bool matchWaypoints);
+
+  /* Airway queries using the lookup cache if enabled */
+  void waypointsForAirway(QList<map::MapWaypoint>& waypoints, const QString& airwayName, const QString& waypointName);
+  void waypointListForAirwayName(QList<map::MapAirwayWaypoint>& waypoints, const QString& airwayName);
+  void airwaysForWaypoints(QList<map::MapAirway>& airways, int waypointId1, int waypointId2, const QString& airwayName);
 
   /* Get nearest waypoint for given position probably removing ones which are too far away. Changes given result.
    * Also checks airways and connections if lastResult is given. */
@@ -203,6 +216,12 @@ private:
   FlightplanEntryBuilder *entryBuilder = nullptr;
   QStringList errorMessages, warningMessages, logMessages;
   bool plaintextMessages = false;
+
+  /* Null if caching is disabled */
+  LookupCache *lookupCache = nullptr;
+
+  /* Track usage for current route string. Part of the airway cache keys. */
+  bool useTracks = true;
 };
 
 #endif // LITTLENAVMAP_ROUTESTRINGREADER_H
@@ -31,6 +31,7 @@
 #include "ui_mainwindow.h"
 
 #include <QDebug>
+#include <QDir>
 
 using atools::track::TrackDownloader;
 using atools::settings::Settings;
@@ -62,6 +63,16 @@ TrackController::TrackController(TrackManager *trackManagerParam, MainWindow *ma
                      settings.getAndStoreValue(lnm::OPTIONS_TRACK_AUSOTS_PARAM, TrackDownloader::PARAM.value(t::AUSOTS)).toStringList());
 #endif
 
+  // Read tracks from local files given on the command line to measure loading times without network
+  QString trackDir = NavApp::getStartupOptionStr(lnm::STARTUP_TRACK_FILES);
+  if(!trackDir.isEmpty())
+  {
+    qInfo() << Q_FUNC_INFO << "Loading tracks from" << trackDir;
+    downloader->setUrl(atools::track::NAT, QDir(trackDir).filePath("NAT.txt"));
+    downloader->setUrl(atools::track::PACOTS, QDir(trackDir).filePath("PACOTS.txt"));
+    downloader->setUrl(atools::track::AUSOTS, QDir(trackDir).filePath("AUSOTS.txt"));
+  }
+
   connect(downloader, &TrackDownloader::trackDownloadFinished, this, &TrackController::trackDownloadFinished);
   connect(downloader, &TrackDownloader::trackDownloadFailed, this, &TrackController::trackDownloadFailed);
   connect(downloader, &TrackDownloader::trackDownloadSslErrors, this, &TrackController::trackDownloadSslErrors);
@@ -32,6 +32,7 @@
 
 #include <QDataStream>
 #include <QElapsedTimer>
+#include <QStringBuilder>
 
 using atools::sql::SqlDatabase;
 using atools::sql::SqlTransaction;
@@ -53,46 +54,115 @@ TrackManager::TrackManager(SqlDatabase *trackDatabase, SqlDatabase *navDatabase)
 
 TrackManager::~TrackManager()
 {
-  deInitQueries();
 }
 
-void TrackManager::initQueries()
+/* Track string parsed into references. Collected before resolving all references in batches. */
+struct TrackManager::ParsedTrack
 {
-  deInitQueries();
+  const Track *track;
+  int fragmentNo;
+  map::MapObjectRefExtVector refs;
+};
 
-  waypointQuery = new SqlQuery(dbNav);
-  waypointQuery->prepare("select * from waypoint where waypoint_id = ? limit 1");
+/* Maximum number of ids for one "in" clause */
+const static int BATCH_SIZE = 500;
 
-  waypointNavQuery = new SqlQuery(dbNav);
-  waypointNavQuery->prepare("select waypoint_id from waypoint where nav_id = ? and type= ? limit 1");
-
-  vorQuery = new SqlQuery(dbNav);
-  vorQuery->prepare("select * from vor where vor_id = ? limit 1");
-
-  ndbQuery = new SqlQuery(dbNav);
-  ndbQuery->prepare("select * from ndb where ndb_id = ? limit 1");
+void TrackManager::fillCache(QHash<int, SqlRecord>& cache, const QString& queryStr, const QString& idColumn, const QSet<int>& ids)
+{
+  QList<int> idList = ids.values();
+  for(int i = 0; i < idList.size(); i += BATCH_SIZE)
+  {
+    QStringList idStrings;
+    for(int id : idList.mid(i, BATCH_SIZE))
+      idStrings.append(QString::number(id));
 
-  airwayQuery = new SqlQuery(dbNav);
-  airwayQuery->prepare("select minimum_altitude, maximum_altitude, direction "
-                       "from airway where airway_id = ? limit 1");
+    SqlQuery query(queryStr.arg(idStrings.join(',')), dbNav);
+    query.exec();
+    while(query.next())
+    {
+      int id = query.valueInt(idColumn);
+      if(!cache.contains(id))
+        cache.insert(id, query.record());
+    }
+  }
 }
 
-void TrackManager::deInitQueries()
+void TrackManager::fillCaches(const QVector<ParsedTrack>& parsedTracks)
 {
-  delete waypointQuery;
-  waypointQuery = nullptr;
+  clearCaches();
+
+  // Collect all distinct ids by type over all tracks ==================================
+  QSet<int> navIds, airwayIds;
+  for(const ParsedTrack& parsed : parsedTracks)
+  {
+    for(const map::MapRefExt& ref : parsed.refs)
+    {
+      if(ref.objType == map::VOR || ref.objType == map::NDB)
+        navIds.insert(ref.id);
+      else if(ref.objType & map::AIRWAY)
+        airwayIds.insert(ref.id);
+    }
+  }
+
+  // Find waypoints associated with VOR and NDB ==================================
+  QList<int> navIdList = navIds.values();
+  for(int i = 0; i < navIdList.size(); i += BATCH_SIZE)
+  {
+    QStringList idStrings;
+    for(int id : navIdList.mid(i, BATCH_SIZE))
+      idStrings.append(QString::number(id));
+
+    SqlQuery query("select waypoint_id, nav_id, type from waypoint where type in ('V', 'N') and nav_id in (" %
+                   idStrings.join(',') % ")", dbNav);
+    query.exec();
+    while(query.next())
+    {
+      auto key = std::make_pair(query.valueInt("nav_id"), query.valueStr("type"));
+      if(!navWaypointIdCache.contains(key))
+        navWaypointIdCache.insert(key, query.valueInt("waypoint_id"));
+    }
+  }
 
-  delete waypointNavQuery;
-  waypointNavQuery = nullptr;
+  // Collect waypoint, VOR and NDB ids after resolving navaids to waypoints ==================================
+  QSet<int> waypointIds, vorIds, ndbIds;
+  for(const ParsedTrack& parsed : parsedTracks)
+  {
+    for(const map::MapRefExt& ref : parsed.refs)
+    {
+      if(ref.objType == map::WAYPOINT)
+        waypointIds.insert(ref.id);
+      else if(ref.objType == map::VOR || ref.objType == map::NDB)
+      {
+        int waypointId = navWaypointIdCache.value(std::make_pair(ref.id, ref.objType == map::VOR ? "V" : "N"), -1);
+        if(waypointId != -1)
+          waypointIds.insert(waypointId);
+        else if(ref.objType == map::VOR)
+          vorIds.insert(ref.id);
+        else
+          ndbIds.insert(ref.id);
+      }
+    }
+  }
 
-  delete vorQuery;
-  vorQuery = nullptr;
+  // Load all needed rows with one query per type and batch ==================================
+  fillCache(waypointCache, "select * from waypoint where waypoint_id in (%1)", "waypoint_id", waypointIds);
+  fillCache(vorCache, "select * from vor where vor_id in (%1)", "vor_id", vorIds);
+  fillCache(ndbCache, "select * from ndb where ndb_id in (%1)", "ndb_id", ndbIds);
+  fillCache(airwayCache, "select airway_id, minimum_altitude, maximum_altitude, direction from airway where airway_id in (%1)",
+            "airway_id", airwayIds);
 
-  delete ndbQuery;
-  ndbQuery = nullptr;
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "waypoints" << waypointCache.size() << "VOR" << vorCache.size() << "NDB" << ndbCache.size()
+             << "airways" << airwayCache.size();
+}
 
-  delete airwayQuery;
-  airwayQuery = nullptr;
+void TrackManager::clearCaches()
+{
+  navWaypointIdCache.clear();
+  waypointCache.clear();
+  vorCache.clear();
+  ndbCache.clear();
+  airwayCache.clear();
 }
 
 void TrackManager::loadTracks(const TrackVectorType& tracks, bool onlyValid)
@@ -101,10 +171,9 @@ void TrackManager::loadTracks(const TrackVectorType& tracks, bool onlyValid)
   SqlTransaction transaction(db);
   clearTracks();
 
-  initQueries();
-
-  QElapsedTimer timer;
+  QElapsedTimer timer, totalTimer;
   timer.start();
+  totalTimer.start();
 
   // Generated ids with offset to distinguis from read airways and waypoints
   int trackpointId = atools::track::TRACKPOINT_ID_OFFSET, trackId = atools::track::TRACK_ID_OFFSET, trackmetaId = 1;
@@ -113,17 +182,25 @@ void TrackManager::loadTracks(const TrackVectorType& tracks, bool onlyValid)
   RouteStringReader reader(&builder);
   reader.setPlaintextMessages(true);
 
+  // Tracks share most waypoints and airways - look up each ident and airway only once for all tracks
+  reader.setCacheLookups(true);
+
   // Maps trackpoint/waypoint (real or generated with offset) ids to records to insert into table trackpoint
   QHash<int, SqlRecord> trackpoints;
 
   // Maps type (NAT, PACOTS, etc.) and track name to metadata record
   QHash<std::pair<TrackType, QString>, SqlRecord> trackmeta;
 
+  // Records for track table
+  QList<SqlRecord> trackRecords;
+
   // Maps name to a fragment number for airway compatibility which needs name and fragment as a key
   QHash<QString, int> nameFragmentHash;
 
   QDateTime now = QDateTime::currentDateTimeUtc();
-  // Read each track into the database ==================================================
+
+  // Read each track string into a list of references ==================================================
+  QVector<ParsedTrack> parsedTracks;
   for(const Track& track : tracks)
   {
     if(verbose)
@@ -138,7 +215,6 @@ void TrackManager::loadTracks(const TrackVectorType& tracks, bool onlyValid)
     else
       nameFragmentHash.insert(track.name, 1);
 
-    // Read string into a list of references ====================================
     map::MapObjectRefExtVector refs;
     QString routeStr = track.route.join(" ");
     if(reader.createRouteFromString(routeStr, rs::TRACK_DEFAULTS, nullptr, &refs))
@@ -152,136 +228,156 @@ void TrackManager::loadTracks(const TrackVectorType& tracks, bool onlyValid)
         qWarning() << Q_FUNC_INFO << reader.getAllMessages();
       }
 
-      // Empty records
-      SqlRecord trackRec = getEmptyRecord(); // track table
-      SqlRecord trackpointRec = db->record("trackpoint");
+      parsedTracks.append({&track, nameFragmentHash.value(track.name), refs});
+    }
+    else
+    {
+      QString err = tr("Error when parsing track %1 (%2) with route %3.").
+                    arg(track.name).
+                    arg(track.typeString()).arg(atools::elideTextShortMiddle(track.route.join(" "), 40));
+      errorMessages.append(err);
+      errorMessages.append(reader.getAllMessages());
+    }
+  }
 
-      int startPointId = -1, endPointId = -1;
-      // Write all waypoints to the database ===========================================
-      for(int i = 1; i < refs.size(); i++)
-      {
-        const map::MapRefExt& ref = refs.at(i);
+  if(!errorMessages.isEmpty())
+    qWarning() << errorMessages;
 
-        // Read airways later
-        if(ref.objType & map::AIRWAY)
-          continue;
+  qint64 parseTime = timer.restart();
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "after parsing tracks" << parseTime;
 
-        if((ref.id == -1 && ref.objType != map::USERPOINTROUTE) || !ref.position.isValidRange())
-          qWarning() << Q_FUNC_INFO << "Invalid track ref" << ref;
+  // Resolve all distinct waypoints, navaids and airways at once ==================================================
+  fillCaches(parsedTracks);
 
-        const map::MapRefExt *refLast2 = i > 1 ? &refs.at(i - 2) : nullptr;
-        const map::MapRefExt& refLast1 = refs.at(i - 1);
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "after filling caches" << timer.restart();
 
-        trackRec.setValue("track_id", trackId++);
-        trackRec.setValue("trackmeta_id", trackmetaId);
-        trackRec.setValue("track_name", track.name);
-        trackRec.setValue("track_type", atools::charToStr(track.type));
-        trackRec.setValue("sequence_no", i);
-        trackRec.setValue("track_fragment_no", nameFragmentHash.value(track.name));
+  // Empty records
+  SqlRecord trackRec = getEmptyRecord(); // track table
+  SqlRecord trackpointRec = db->record("trackpoint");
 
-        if(!track.eastLevels.isEmpty())
-          trackRec.setValue("altitude_levels_east", atools::io::writeVector<quint16, quint16>(track.eastLevels));
-        if(!track.westLevels.isEmpty())
-          trackRec.setValue("altitude_levels_west", atools::io::writeVector<quint16, quint16>(track.westLevels));
+  // Build records for each track ==================================================
+  for(const ParsedTrack& parsed : qAsConst(parsedTracks))
+  {
+    const Track& track = *parsed.track;
+    const map::MapObjectRefExtVector& refs = parsed.refs;
 
-        int airwayId = -1;
-        map::MapRefExt fromRef, toRef;
-        if(refLast2 != nullptr && refLast1.objType & map::AIRWAY)
-        {
-          // Previous entry is an airway - second previous is from waypoint
-          fromRef = *refLast2;
-          airwayId = refLast1.id;
-        }
-        else
-          // No airway - previous is from waypoint
-          fromRef = refLast1;
+    int startPointId = -1, endPointId = -1;
+    // Write all waypoints to the database ===========================================
+    for(int i = 1; i < refs.size(); i++)
+    {
+      const map::MapRefExt& ref = refs.at(i);
 
-        // to waypoint
-        toRef = ref;
+      // Read airways later
+      if(ref.objType & map::AIRWAY)
+        continue;
 
-        if(airwayId != -1)
-        {
-          // Save copy of certain airway fields ============
-          trackRec.setValue("airway_id", airwayId);
-
-          airwayQuery->bindValue(0, airwayId);
-          airwayQuery->exec();
-          if(airwayQuery->next())
-          {
-            trackRec.setValue("airway_minimum_altitude", airwayQuery->value("minimum_altitude"));
-            trackRec.setValue("airway_maximum_altitude", airwayQuery->value("maximum_altitude"));
-            trackRec.setValue("airway_direction", airwayQuery->value("direction"));
-          }
-        }
+      if((ref.id == -1 && ref.objType != map::USERPOINTROUTE) || !ref.position.isValidRange())
+        qWarning() << Q_FUNC_INFO << "Invalid track ref" << ref;
+
+      const map::MapRefExt *refLast2 = i > 1 ? &refs.at(i - 2) : nullptr;
+      const map::MapRefExt& refLast1 = refs.at(i - 1);
+
+      trackRec.setValue("track_id", trackId++);
+      trackRec.setValue("trackmeta_id", trackmetaId);
+      trackRec.setValue("track_name", track.name);
+      trackRec.setValue("track_type", atools::charToStr(track.type));
+      trackRec.setValue("sequence_no", i);
+      trackRec.setValue("track_fragment_no", parsed.fragmentNo);
 
-        // Add trackpoint/waypoint to hash and return id which can be generated or original waypoint id
-        int fromId = addTrackpoint(trackpoints, trackpointRec, fromRef, trackpointId);
-
-        // New generated id for waypoint in case it is needed
-        trackpointId++;
-        int toId = addTrackpoint(trackpoints, trackpointRec, toRef, trackpointId);
-
-        // Remember start and end id (real or generated) for metadata
-        if(i == 1)
-          startPointId = fromId;
-        if(i == refs.size() - 1)
-          endPointId = toId;
-
-        trackRec.setValue("from_waypoint_id", fromId);
-        trackRec.setValue("from_waypoint_name", fromRef.name);
-        trackRec.setValue("to_waypoint_id", toId);
-        trackRec.setValue("to_waypoint_name", toRef.name);
-
-        // Coordinates and bounding rectangle
-        atools::geo::Rect rect(atools::geo::LineString({fromRef.position, toRef.position}));
-        trackRec.setValue("left_lonx", rect.getWest());
-        trackRec.setValue("top_laty", rect.getNorth());
-        trackRec.setValue("right_lonx", rect.getEast());
-        trackRec.setValue("bottom_laty", rect.getSouth());
-        trackRec.setValue("from_lonx", fromRef.position.getLonX());
-        trackRec.setValue("from_laty", fromRef.position.getLatY());
-        trackRec.setValue("to_lonx", ref.position.getLonX());
-        trackRec.setValue("to_laty", ref.position.getLatY());
-
-        // Insert into database
-        insertOneRecord(trackRec);
-
-        // Set all to null
-        trackRec.clearValues();
+      if(!track.eastLevels.isEmpty())
+        trackRec.setValue("altitude_levels_east", atools::io::writeVector<quint16, quint16>(track.eastLevels));
+      if(!track.westLevels.isEmpty())
+        trackRec.setValue("altitude_levels_west", atools::io::writeVector<quint16, quint16>(track.westLevels));
+
+      int airwayId = -1;
+      map::MapRefExt fromRef, toRef;
+      if(refLast2 != nullptr && refLast1.objType & map::AIRWAY)
+      {
+        // Previous entry is an airway - second previous is from waypoint
+        fromRef = *refLast2;
+        airwayId = refLast1.id;
       }
+      else
+        // No airway - previous is from waypoint
+        fromRef = refLast1;
 
-      // Add to trackmeta table if a new track was found
-      if(addTrackmeta(trackmeta, track, trackmetaId, startPointId, endPointId))
-        trackmetaId++;
+      // to waypoint
+      toRef = ref;
 
+      if(airwayId != -1)
+      {
+        // Save copy of certain airway fields ============
+        trackRec.setValue("airway_id", airwayId);
+
+        if(airwayCache.contains(airwayId))
+        {
+          const SqlRecord& airwayRec = airwayCache[airwayId];
+          trackRec.setValue("airway_minimum_altitude", airwayRec.value("minimum_altitude"));
+          trackRec.setValue("airway_maximum_altitude", airwayRec.value("maximum_altitude"));
+          trackRec.setValue("airway_direction", airwayRec.value("direction"));
+        }
+      }
+
+      // Add trackpoint/waypoint to hash and return id which can be generated or original waypoint id
+      int fromId = addTrackpoint(trackpoints, trackpointRec, fromRef, trackpointId);
+
+      // New generated id for waypoint in case it is needed
+      trackpointId++;
+      int toId = addTrackpoint(trackpoints, trackpointRec, toRef, trackpointId);
+
+      // Remember start and end id (real or generated) for metadata
+      if(i == 1)
+        startPointId = fromId;
+      if(i == refs.size() - 1)
+        endPointId = toId;
+
+      trackRec.setValue("from_waypoint_id", fromId);
+      trackRec.setValue("from_waypoint_name", fromRef.name);
+      trackRec.setValue("to_waypoint_id", toId);
+      trackRec.setValue("to_waypoint_name", toRef.name);
+
+      // Coordinates and bounding rectangle
+      atools::geo::Rect rect(atools::geo::LineString({fromRef.position, toRef.position}));
+      trackRec.setValue("left_lonx", rect.getWest());
+      trackRec.setValue("top_laty", rect.getNorth());
+      trackRec.setValue("right_lonx", rect.getEast());
+      trackRec.setValue("bottom_laty", rect.getSouth());
+      trackRec.setValue("from_lonx", fromRef.position.getLonX());
+      trackRec.setValue("from_laty", fromRef.position.getLatY());
+      trackRec.setValue("to_lonx", ref.position.getLonX());
+      trackRec.setValue("to_laty", ref.position.getLatY());
+
+      // Collect for bulk insert
+      trackRecords.append(trackRec);
+
+      // Set all to null
+      trackRec.clearValues();
     }
-    else
-    {
-      QString err = tr("Error when parsing track %1 (%2) with route %3.").
-                    arg(track.name).
-                    arg(track.typeString()).arg(atools::elideTextShortMiddle(track.route.join(" "), 40));
-      errorMessages.append(err);
-      errorMessages.append(reader.getAllMessages());
-    }
+
+    // Add to trackmeta table if a new track was found
+    if(addTrackmeta(trackmeta, track, trackmetaId, startPointId, endPointId))
+      trackmetaId++;
   }
 
-  if(!errorMessages.isEmpty())
-    qWarning() << errorMessages;
+  clearCaches();
 
   if(verbose)
-    qDebug() << Q_FUNC_INFO << "after loading tracks" << timer.restart();
+    qDebug() << Q_FUNC_INFO << "after building records" << timer.restart();
 
-  // Write collected trackpoints into database
+  // Write collected track segments, trackpoints and metadata into database using prepared statements
+  insertRecords(trackRecords, "track");
   insertRecords(trackpoints.values(), "trackpoint");
-
-  // Write collected metadata into database
   insertRecords(trackmeta.values(), "trackmeta");
 
   transaction.commit();
-  deInitQueries();
 
   if(verbose)
-    qDebug() << Q_FUNC_INFO << "after loading trackpoints" << timer.restart();
+    qDebug() << Q_FUNC_INFO << "after inserting records" << timer.restart();
+
+  qInfo() << Q_FUNC_INFO << "Loaded" << parsedTracks.size() << "tracks with" << trackRecords.size() << "segments in"
+          << totalTimer.elapsed() << "ms. Parsing" << parseTime << "ms";
 }
 
 int TrackManager::addTrackpoint(QHash<int, SqlRecord>& trackpoints, atools::sql::SqlRecord rec,
@@ -292,16 +388,13 @@ int TrackManager::addTrackpoint(QHash<int, SqlRecord>& trackpoints, atools::sql:
   // Try to find associated waypoint for VOR or NDB ============================
   if(ref.objType == map::VOR || ref.objType == map::NDB)
   {
-    waypointNavQuery->bindValue(0, ref.id);
-    waypointNavQuery->bindValue(1, ref.objType == map::VOR ? "V" : "N");
-    waypointNavQuery->exec();
-    if(waypointNavQuery->next())
+    int waypointId = navWaypointIdCache.value(std::make_pair(ref.id, ref.objType == map::VOR ? "V" : "N"), -1);
+    if(waypointId != -1)
     {
       // Change reference to waypoint ===================
-      ref.id = waypointNavQuery->valueInt(0);
+      ref.id = waypointId;
       ref.objType = map::WAYPOINT;
     }
-    waypointNavQuery->finish();
   }
 
   rec.clearValues();
@@ -310,25 +403,23 @@ int TrackManager::addTrackpoint(QHash<int, SqlRecord>& trackpoints, atools::sql:
   {
     if(!trackpoints.contains(ref.id))
     {
-      waypointQuery->bindValue(0, ref.id);
-      waypointQuery->exec();
-      if(waypointQuery->next())
+      if(waypointCache.contains(ref.id))
       {
         // Waypoint new in list and found in database - insert a copy with waypoint_id ========================
+        const SqlRecord& waypointRec = waypointCache[ref.id];
         rec.setValue("trackpoint_id", ref.id);
-        rec.setValue("nav_id", waypointQuery->value("nav_id"));
-        rec.setValue("ident", waypointQuery->value("ident"));
-        rec.setValue("region", waypointQuery->value("region"));
-        rec.setValue("type", waypointQuery->value("type"));
-        rec.setValue("num_victor_airway", waypointQuery->value("num_victor_airway"));
-        rec.setValue("num_jet_airway", waypointQuery->value("num_jet_airway"));
-        rec.setValue("mag_var", waypointQuery->value("mag_var"));
-        rec.setValue("lonx", waypointQuery->value("lonx"));
-        rec.setValue("laty", waypointQuery->value("laty"));
+        rec.setValue("nav_id", waypointRec.value("nav_id"));
+        rec.setValue("ident", waypointRec.value("ident"));
+        rec.setValue("region", waypointRec.value("region"));
+        rec.setValue("type", waypointRec.value("type"));
+        rec.setValue("num_victor_airway", waypointRec.value("num_victor_airway"));
+        rec.setValue("num_jet_airway", waypointRec.value("num_jet_airway"));
+        rec.setValue("mag_var", waypointRec.value("mag_var"));
+        rec.setValue("lonx", waypointRec.value("lonx"));
+        rec.setValue("laty", waypointRec.value("laty"));
         trackpoints.insert(ref.id, rec);
         returnId = ref.id;
       }
-      waypointQuery->finish();
     }
     else
       returnId = ref.id;
@@ -336,46 +427,31 @@ int TrackManager::addTrackpoint(QHash<int, SqlRecord>& trackpoints, atools::sql:
   else if(ref.objType == map::VOR || ref.objType == map::NDB)
   {
     // VOR or NDB without associated waypoint ==========================================
-    SqlQuery *navaidQuery = nullptr;
-    QString type;
-    if(ref.objType == map::VOR)
-    {
-      navaidQuery = vorQuery;
-      type = "V";
-    }
-    else if(ref.objType == map::NDB)
-    {
-      navaidQuery = ndbQuery;
-      type = "N";
-    }
+    const QHash<int, SqlRecord>& navaidCache = ref.objType == map::VOR ? vorCache : ndbCache;
+    QString type = ref.objType == map::VOR ? "V" : "N";
 
-    if(navaidQuery != nullptr)
+    if(!trackpoints.contains(trackpointId))
     {
-      if(!trackpoints.contains(trackpointId))
+      if(navaidCache.contains(ref.id))
       {
-        navaidQuery->bindValue(0, ref.id);
-        navaidQuery->exec();
-        if(navaidQuery->next())
-        {
-          // Navaid new in list and found in database - insert a new VOR or NDB waypoint with generated id ===========
-          rec.setValue("trackpoint_id", trackpointId);
-          rec.setValue("nav_id", ref.id);
-          rec.setValue("ident", navaidQuery->value("ident"));
-          rec.setValue("region", navaidQuery->value("region"));
-          rec.setValue("type", type);
-          rec.setValue("num_victor_airway", 0);
-          rec.setValue("num_jet_airway", 0);
-          rec.setValue("mag_var", navaidQuery->value("mag_var"));
-          rec.setValue("lonx", navaidQuery->value("lonx"));
-          rec.setValue("laty", navaidQuery->value("laty"));
-          trackpoints.insert(trackpointId, rec);
-          returnId = trackpointId;
-        }
-        navaidQuery->finish();
-      }
-      else
+        // Navaid new in list and found in database - insert a new VOR or NDB waypoint with generated id ===========
+        const SqlRecord& navaidRec = navaidCache[ref.id];
+        rec.setValue("trackpoint_id", trackpointId);
+        rec.setValue("nav_id", ref.id);
+        rec.setValue("ident", navaidRec.value("ident"));
+        rec.setValue("region", navaidRec.value("region"));
+        rec.setValue("type", type);
+        rec.setValue("num_victor_airway", 0);
+        rec.setValue("num_jet_airway", 0);
+        rec.setValue("mag_var", navaidRec.value("mag_var"));
+        rec.setValue("lonx", navaidRec.value("lonx"));
+        rec.setValue("laty", navaidRec.value("laty"));
+        trackpoints.insert(trackpointId, rec);
         returnId = trackpointId;
+      }
     }
+    else
+      returnId = trackpointId;
   }
 
   if(returnId == -1)
@@ -21,6 +21,8 @@
 #include "track/tracktypes.h"
 #include "sql/datamanagerbase.h"
 
+#include <QSet>
+
 namespace map {
 struct MapRefExt;
 typedef QVector<map::MapRefExt> MapObjectRefExtVector;
@@ -68,9 +70,16 @@ public:
   }
 
 private:
-  /* Queries are initialized and closed when entering and leaving loadTracks(). */
-  void initQueries();
-  void deInitQueries();
+  struct ParsedTrack;
+
+  /* Resolve all distinct waypoint, VOR, NDB and airway ids of all parsed tracks using one query per type
+   * and batch of ids. Results are kept in the caches below for the whole load. */
+  void fillCaches(const QVector<ParsedTrack>& parsedTracks);
+  void clearCaches();
+
+  /* Run query for ids and add all result rows to the cache. queryStr has to contain "in (%1)" */
+  void fillCache(QHash<int, atools::sql::SqlRecord>& cache, const QString& queryStr, const QString& idColumn,
+                 const QSet<int>& ids);
 
   /* Add waypoint/trackpoint to hash returning waypoint id or new generated trackpoint id.
    * rec is an empty record for trackpoint table. */
@@ -81,8 +90,11 @@ private:
   bool addTrackmeta(QHash<std::pair<atools::track::TrackType, QString>, atools::sql::SqlRecord>& records,
                     const atools::track::Track& track, int metaId, int startPointId, int endPointId);
 
-  atools::sql::SqlQuery *waypointQuery = nullptr, *waypointNavQuery = nullptr,
-                        *ndbQuery = nullptr, *vorQuery = nullptr, *airwayQuery = nullptr;
+  /* Filled before building records and cleared afterwards. Map ids to full rows of the nav database. */
+  QHash<int, atools::sql::SqlRecord> waypointCache, vorCache, ndbCache, airwayCache;
+
+  /* Maps VOR or NDB id and type "V" or "N" to the id of the associated waypoint */
+  QHash<std::pair<int, QString>, int> navWaypointIdCache;
 
   bool verbose = false;
 
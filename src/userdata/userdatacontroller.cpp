@@ -21,6 +21,7 @@
 #include "common/constants.h"
 #include "common/mapresult.h"
 #include "common/maptypesfactory.h"
+#include "db/dataimport.h"
 #include "db/undoredoprogress.h"
 #include "exception.h"
 #include "fs/userdata/userdatamanager.h"
@@ -54,6 +55,9 @@ using atools::sql::SqlRecord;
 using atools::sql::SqlColumn;
 using atools::geo::Pos;
 
+/* Number of undo steps for main and import managers */
+static const int MAX_UNDO_STEPS = 50;
+
 UserdataController::UserdataController(atools::fs::userdata::UserdataManager *userdataManager, MainWindow *parent)
   : manager(userdataManager), mainWindow(parent)
 {
@@ -69,7 +73,7 @@ UserdataController::UserdataController(atools::fs::userdata::UserdataManager *us
   connect(ui->actionSearchUserpointUndo, &QAction::triggered, this, &UserdataController::undoTriggered);
   connect(ui->actionSearchUserpointRedo, &QAction::triggered, this, &UserdataController::redoTriggered);
 
-  manager->setMaximumUndoSteps(50);
+  manager->setMaximumUndoSteps(MAX_UNDO_STEPS);
   manager->setTextSuffix(tr("Userpoint", "Userpoint singular"), tr("Userpoints", "Userpoint plural"));
   manager->setActions(ui->actionSearchUserpointUndo, ui->actionSearchUserpointRedo);
 }
@@ -668,35 +672,80 @@ void UserdataController::importCsv()
 
     if(!files.isEmpty())
     {
-      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-      SqlTransaction transaction(manager->getDatabase());
-      int numImported = manager->importCsv(files, atools::fs::userdata::NONE, ',', '"');
-      transaction.commit();
-      QGuiApplication::restoreOverrideCursor();
-
-      mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
-      if(numImported > 0)
-      {
+      if(importCsvFiles(files) > 0)
         mainWindow->showUserpointSearch();
-        manager->updateUndoRedoActions();
-        emit refreshUserdataSearch(false /* loadAll */, false /* keepSelection */, true /* force */);
-      }
     }
   }
   catch(atools::Exception& e)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleException(e);
   }
   catch(...)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleUnknownException();
   }
 }
 
+int UserdataController::importCsvFiles(const QStringList& files)
+{
+  int numImported = runImport(files, [&files](atools::fs::userdata::UserdataManager& importManager) -> int {
+    return importManager.importCsv(files, atools::fs::userdata::NONE, ',', '"');
+  });
+
+  mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
+
+  if(numImported > 0)
+  {
+    // Refresh search only once after all files are imported
+    manager->updateUndoRedoActions();
+    emit refreshUserdataSearch(false /* loadAll */, false /* keepSelection */, true /* force */);
+  }
+  return numImported;
+}
+
+int UserdataController::runImport(const QStringList& files,
+                                  const std::function<int(atools::fs::userdata::UserdataManager& importManager)>& importFunc)
+{
+  atools::fs::common::MagDecReader *magDecReader = NavApp::getMagDecReader();
+  QString suffixSingular = tr("Userpoint", "Userpoint singular"), suffixPlural = tr("Userpoints", "Userpoint plural");
+
+  return dataimport::runImport(mainWindow, manager, "userdata", files,
+                               [&importFunc, magDecReader, &suffixSingular, &suffixPlural](atools::sql::SqlDatabase *db) -> int {
+    // Separate manager for the worker thread connection using the same undo settings
+    atools::fs::userdata::UserdataManager importManager(db);
+    importManager.setMaximumUndoSteps(MAX_UNDO_STEPS);
+    importManager.setTextSuffix(suffixSingular, suffixPlural);
+    importManager.setMagDecReader(magDecReader);
+    return importFunc(importManager);
+  });
+}
+
+void UserdataController::importStartup()
+{
+  QString file = NavApp::getStartupOptionStr(lnm::STARTUP_IMPORT_USERPOINTS);
+  if(!file.isEmpty())
+  {
+    qDebug() << Q_FUNC_INFO << file;
+    try
+    {
+      if(atools::checkFile(Q_FUNC_INFO, file, true /* warn */))
+        importCsvFiles({file});
+    }
+    catch(atools::Exception& e)
+    {
+      NavApp::closeSplashScreen();
+      atools::gui::ErrorHandler(mainWindow).handleException(e);
+    }
+    catch(...)
+    {
+      NavApp::closeSplashScreen();
+      atools::gui::ErrorHandler(mainWindow).handleUnknownException();
+    }
+  }
+}
+
 void UserdataController::importXplaneUserFixDat()
 {
   qDebug() << Q_FUNC_INFO;
@@ -709,11 +758,9 @@ void UserdataController::importXplaneUserFixDat()
 
     if(!file.isEmpty())
     {
-      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-      SqlTransaction transaction(manager->getDatabase());
-      int numImported = manager->importXplane(file);
-      transaction.commit();
-      QGuiApplication::restoreOverrideCursor();
+      int numImported = runImport({file}, [&file](atools::fs::userdata::UserdataManager& importManager) -> int {
+        return importManager.importXplane(file);
+      });
 
       mainWindow->showUserpointSearch();
       mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
@@ -723,13 +770,11 @@ void UserdataController::importXplaneUserFixDat()
   }
   catch(atools::Exception& e)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleException(e);
   }
   catch(...)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleUnknownException();
   }
@@ -747,11 +792,9 @@ void UserdataController::importGarmin()
 
     if(!file.isEmpty())
     {
-      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-      SqlTransaction transaction(manager->getDatabase());
-      int numImported = manager->importGarmin(file);
-      transaction.commit();
-      QGuiApplication::restoreOverrideCursor();
+      int numImported = runImport({file}, [&file](atools::fs::userdata::UserdataManager& importManager) -> int {
+        return importManager.importGarmin(file);
+      });
 
       mainWindow->showUserpointSearch();
       mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
@@ -761,13 +804,11 @@ void UserdataController::importGarmin()
   }
   catch(atools::Exception& e)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleException(e);
   }
   catch(...)
   {
-    QGuiApplication::restoreOverrideCursor();
     NavApp::closeSplashScreen();
     atools::gui::ErrorHandler(mainWindow).handleUnknownException();
   }
@@ -21,6 +21,8 @@
 #include <QObject>
 #include <QVector>
 
+#include <functional>
+
 namespace atools {
 namespace sql {
 class SqlRecord;
@@ -89,6 +91,9 @@ public:
   void importCsv();
   void exportCsv();
 
+  /* Import userpoint CSV file given on the command line without user interaction */
+  void importStartup();
+
   /* Import and export user_fix.dat file from X-Plane. Import does not commit. */
   void importXplaneUserFixDat();
   void exportXplaneUserFixDat();
@@ -172,6 +177,13 @@ private:
   void addUserpointInternalAddon(const atools::geo::Pos& pos, const atools::sql::SqlRecord& rec);
   bool exportSelectedQuestion(bool& selected, bool& append, bool& header, bool& xp12, bool appendAllowed, bool headerAllowed, bool xplane);
 
+  /* Import CSV files in one transaction and refresh search once. Returns number of userpoints. */
+  int importCsvFiles(const QStringList& files);
+
+  /* Runs importFunc in a background thread on a separate manager configured like the main one.
+   * Returns number of userpoints. */
+  int runImport(const QStringList& files, const std::function<int(atools::fs::userdata::UserdataManager& importManager)>& importFunc);
+
   /* Get default X-Plane path to user_fix.dat file */
   QString xplaneUserWptDatPath();
 
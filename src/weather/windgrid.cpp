@@ -0,0 +1,176 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "weather/windgrid.h"
+
+#include "atools.h"
+#include "common/maptypes.h"
+#include "geo/calculations.h"
+#include "geo/linestring.h"
+
+namespace  {
+/* Grid resolution in degree which matches the NOAA GRIB resolution */
+const static float GRID_STEP_DEG = 1.f;
+
+/* Altitude levels in feet. First level is the surface wind which is interpolated towards below the second level.
+ * Positions above the highest level are clamped. */
+const static QVector<float> LEVELS_FT = {0.f, 1000.f, 2000.f, 5000.f, 10000.f, 15000.f, 20000.f, 25000.f, 30000.f, 35000.f,
+                                         40000.f, 45000.f};
+
+/* Distance between samples along line strings */
+const static float SAMPLE_DISTANCE_NM = 20.f;
+
+/* Maximum number of samples for one line segment */
+const static int MAX_SAMPLES = 200;
+}
+
+WindGrid::WindGrid(const WindQueryFuncType& queryFunc)
+  : query(queryFunc)
+{
+}
+
+void WindGrid::clear()
+{
+  nodes.clear();
+}
+
+const WindGrid::WindVector& WindGrid::node(int latIndex, int lonIndex, int levelIndex)
+{
+  // Wrap longitude around anti-meridian
+  int numLon = atools::roundToInt(360.f / GRID_STEP_DEG);
+  lonIndex = ((lonIndex % numLon) + numLon) % numLon;
+
+  quint32 key = (static_cast<quint32>(levelIndex) << 24) | (static_cast<quint32>(latIndex) << 12) | static_cast<quint32>(lonIndex);
+
+  auto it = nodes.find(key);
+  if(it == nodes.end())
+  {
+    // Not filled yet - query source and convert to vector
+    atools::geo::Pos pos(lonIndex * GRID_STEP_DEG - 180.f, latIndex * GRID_STEP_DEG - 90.f, LEVELS_FT.at(levelIndex));
+    atools::grib::Wind wind = query(pos);
+
+    WindVector vector;
+    vector.valid = wind.speed < map::INVALID_SPEED_VALUE && wind.dir < map::INVALID_COURSE_VALUE;
+    if(vector.valid)
+    {
+      // Direction is where the wind comes from
+      float rad = atools::geo::toRadians(wind.dir);
+      vector.u = -wind.speed * std::sin(rad);
+      vector.v = -wind.speed * std::cos(rad);
+    }
+    else if(levelIndex == 0)
+      // No surface wind available - use next level above which results in a constant wind below it
+      vector = node(latIndex, lonIndex, 1);
+    else
+      vector.u = vector.v = 0.f;
+
+    // Insert after the recursive call above which can modify the hash
+    it = nodes.insert(key, vector);
+  }
+  return it.value();
+}
+
+bool WindGrid::windVector(WindVector& vector, const atools::geo::Pos& pos)
+{
+  // Grid position ==============================
+  // Longitude index is wrapped in node()
+  float latGrid = (atools::minmax(-90.f, 90.f, pos.getLatY()) + 90.f) / GRID_STEP_DEG;
+  float lonGrid = (pos.getLonX() + 180.f) / GRID_STEP_DEG;
+  int lat0 = std::min(static_cast<int>(std::floor(latGrid)), atools::roundToInt(180.f / GRID_STEP_DEG) - 1);
+  int lon0 = static_cast<int>(std::floor(lonGrid));
+  float latFrac = latGrid - lat0, lonFrac = lonGrid - lon0;
+
+  // Altitude levels ==============================
+  float alt = atools::minmax(LEVELS_FT.constFirst(), LEVELS_FT.constLast(), pos.getAltitude());
+  int level0 = 0;
+  while(level0 < LEVELS_FT.size() - 2 && alt > LEVELS_FT.at(level0 + 1))
+    level0++;
+  float levelFrac = (alt - LEVELS_FT.at(level0)) / (LEVELS_FT.at(level0 + 1) - LEVELS_FT.at(level0));
+
+  // Interpolate bilinear on both levels and then linear between levels ================
+  float u[2], v[2];
+  for(int l = 0; l < 2; l++)
+  {
+    const WindVector& n00 = node(lat0, lon0, level0 + l);
+    const WindVector& n01 = node(lat0, lon0 + 1, level0 + l);
+    const WindVector& n10 = node(lat0 + 1, lon0, level0 + l);
+    const WindVector& n11 = node(lat0 + 1, lon0 + 1, level0 + l);
+
+    if(!n00.valid || !n01.valid || !n10.valid || !n11.valid)
+      return false;
+
+    u[l] = (n00.u * (1.f - lonFrac) + n01.u * lonFrac) * (1.f - latFrac) + (n10.u * (1.f - lonFrac) + n11.u * lonFrac) * latFrac;
+    v[l] = (n00.v * (1.f - lonFrac) + n01.v * lonFrac) * (1.f - latFrac) + (n10.v * (1.f - lonFrac) + n11.v * lonFrac) * latFrac;
+  }
+
+  vector.u = u[0] * (1.f - levelFrac) + u[1] * levelFrac;
+  vector.v = v[0] * (1.f - levelFrac) + v[1] * levelFrac;
+  vector.valid = true;
+  return true;
+}
+
+bool WindGrid::getWindForPos(atools::grib::Wind& wind, const atools::geo::Pos& pos)
+{
+  WindVector vector;
+  if(!windVector(vector, pos))
+    return false;
+
+  wind.speed = std::sqrt(vector.u * vector.u + vector.v * vector.v);
+  wind.dir = atools::geo::normalizeCourse(atools::geo::toDegree(std::atan2(-vector.u, -vector.v)));
+  return true;
+}
+
+bool WindGrid::getWindAverageForLineString(atools::grib::Wind& wind, const atools::geo::LineString& line)
+{
+  if(line.isEmpty())
+    return false;
+
+  if(line.size() == 1)
+    return getWindForPos(wind, line.constFirst());
+
+  // Sample all segments in one pass and sum up vector components ===================
+  float uSum = 0.f, vSum = 0.f;
+  int num = 0;
+  WindVector vector;
+  for(int i = 0; i < line.size() - 1; i++)
+  {
+    const atools::geo::Pos& pos1 = line.at(i);
+    const atools::geo::Pos& pos2 = line.at(i + 1);
+    float distNm = atools::geo::meterToNm(pos1.distanceMeterTo(pos2));
+    int samples = std::min(std::max(static_cast<int>(distNm / SAMPLE_DISTANCE_NM), 1), MAX_SAMPLES);
+
+    // Include start point only for the first segment to avoid duplicates
+    for(int j = i == 0 ? 0 : 1; j <= samples; j++)
+    {
+      float fraction = static_cast<float>(j) / samples;
+      atools::geo::Pos pos = pos1.interpolate(pos2, fraction);
+      pos.setAltitude(pos1.getAltitude() + (pos2.getAltitude() - pos1.getAltitude()) * fraction);
+
+      if(!windVector(vector, pos))
+        return false;
+
+      uSum += vector.u;
+      vSum += vector.v;
+      num++;
+    }
+  }
+
+  float u = uSum / num, v = vSum / num;
+  wind.speed = std::sqrt(u * u + v * v);
+  wind.dir = atools::geo::normalizeCourse(atools::geo::toDegree(std::atan2(-u, -v)));
+  return true;
+}
@@ -0,0 +1,85 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_WINDGRID_H
+#define LNM_WINDGRID_H
+
+#include "grib/windtypes.h"
+
+#include <QHash>
+#include <functional>
+
+namespace atools {
+namespace geo {
+class Pos;
+class LineString;
+}
+}
+
+/*
+ * Regular grid of wind vectors over latitude, longitude and altitude levels. Used to speed up the
+ * repeated wind calculations for flight plan legs which sample many positions along all legs.
+ *
+ * Grid nodes are filled on first access by calling the query function and kept until clear() is called.
+ * This has to be done whenever the underlying GRIB data changes.
+ *
+ * Values between nodes are interpolated bilinear for position and linear for altitude using wind
+ * vector components.
+ */
+class WindGrid
+{
+public:
+  /* Function to get wind for a position. Altitude in feet is taken from the position. */
+  typedef std::function<atools::grib::Wind(const atools::geo::Pos& pos)> WindQueryFuncType;
+
+  explicit WindGrid(const WindQueryFuncType& queryFunc);
+
+  /* Remove all nodes */
+  void clear();
+
+  /* Get average wind for all positions sampled along the line string. Altitude is interpolated between points.
+   * Returns false if any needed node has no valid wind. */
+  bool getWindAverageForLineString(atools::grib::Wind& wind, const atools::geo::LineString& line);
+
+  /* Get interpolated wind for position. Returns false if any needed node has no valid wind. */
+  bool getWindForPos(atools::grib::Wind& wind, const atools::geo::Pos& pos);
+
+  int size() const
+  {
+    return nodes.size();
+  }
+
+private:
+  /* Wind vector components in knots. u is eastward and v northward. */
+  struct WindVector
+  {
+    float u, v;
+    bool valid;
+  };
+
+  /* Interpolate wind vector at position */
+  bool windVector(WindVector& vector, const atools::geo::Pos& pos);
+
+  /* Get node from grid or query and insert it */
+  const WindVector& node(int latIndex, int lonIndex, int levelIndex);
+
+  /* Maps index combination to wind vector */
+  QHash<quint32, WindVector> nodes;
+  WindQueryFuncType query;
+};
+
+#endif // LNM_WINDGRID_H
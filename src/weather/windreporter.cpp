@@ -20,6 +20,7 @@
 #include "app/navapp.h"
 #include "ui_mainwindow.h"
 #include "grib/windquery.h"
+#include "weather/windgrid.h"
 #include "settings/settings.h"
 #include "common/constants.h"
 #include "options/optiondata.h"
@@ -179,6 +180,14 @@ WindReporter::WindReporter(QObject *parent, atools::fs::FsPaths::SimulatorType t
   connect(windQueryOnline, &atools::grib::WindQuery::windDownloadSslErrors, this, &WindReporter::windDownloadSslErrors);
   connect(windQueryOnline, &atools::grib::WindQuery::windDownloadProgress, this, &WindReporter::windDownloadProgress);
 
+  // Grid is filled on demand from the online wind data - clear it before anybody else gets the update signal
+  windGrid = new WindGrid([this](const atools::geo::Pos& pos) -> atools::grib::Wind {
+    return windQueryOnline->getWindForPos(pos);
+  });
+  connect(this, &WindReporter::windUpdated, this, [this]() {
+    windGrid->clear();
+  });
+
   // Layers from custom settings ==================
   windQueryManual = new atools::grib::WindQuery(parent, verbose);
   windQueryManual->initFromFixedModel(0.f, 0.f, 0.f);
@@ -198,6 +207,8 @@ WindReporter::~WindReporter()
   qDebug() << Q_FUNC_INFO << "delete windQueryManual";
   delete windQueryManual;
   windQueryManual = nullptr;
+  delete windGrid;
+  windGrid = nullptr;
   qDebug() << Q_FUNC_INFO << "delete actionGroup";
   delete actionGroup;
   actionGroup = nullptr;
@@ -260,6 +271,7 @@ void WindReporter::updateDataSource()
 
   actionToValues();
   downloadErrorReported = false;
+  windGeneration++;
 
   if(ui->actionMapShowWindSimulator->isChecked() && atools::fs::FsPaths::isAnyXplane(simType))
   {
@@ -310,6 +322,7 @@ void WindReporter::updateDataSource()
 void WindReporter::windDownloadFinished()
 {
   qDebug() << Q_FUNC_INFO;
+  windGeneration++;
   updateToolButtonState();
   updateSliderLabel();
 
@@ -678,6 +691,7 @@ void WindReporter::resetSettingsToDefault()
   showFlightplanWaypoints = false;
 
   sliderActionAltitude->setAltitudeFt(10000);
+  windGeneration++;
 
   valuesToAction();
   updateToolButtonState();
@@ -694,6 +708,7 @@ void WindReporter::debugDumpContainerSizes() const
   if(windQueryOnline != nullptr)
     windQueryOnline->debugDumpContainerSizes();
   qDebug() << Q_FUNC_INFO << "windPosCache.list.size()" << windPosCache.list.size();
+  qDebug() << Q_FUNC_INFO << "windGrid->size()" << windGrid->size();
 
 }
 
@@ -808,11 +823,23 @@ atools::grib::WindPos WindReporter::getWindForPos(const atools::geo::Pos& pos)
 
 atools::grib::Wind WindReporter::getWindForPosRoute(const atools::geo::Pos& pos)
 {
+  if(useWindGrid())
+  {
+    atools::grib::Wind wind;
+    if(windGrid->getWindForPos(wind, pos))
+      return wind;
+  }
   return currentWindQuery()->getWindForPos(pos);
 }
 
 atools::grib::Wind WindReporter::getWindForLineRoute(const atools::geo::Pos& pos1, const atools::geo::Pos& pos2)
 {
+  if(useWindGrid())
+  {
+    atools::grib::Wind wind;
+    if(windGrid->getWindAverageForLineString(wind, atools::geo::LineString({pos1, pos2})))
+      return wind;
+  }
   return currentWindQuery()->getWindAverageForLine(pos1, pos2);
 }
 
@@ -823,9 +850,21 @@ atools::grib::Wind WindReporter::getWindForLineRoute(const atools::geo::Line& li
 
 atools::grib::Wind WindReporter::getWindForLineStringRoute(const atools::geo::LineString& line)
 {
+  if(useWindGrid())
+  {
+    atools::grib::Wind wind;
+    if(windGrid->getWindAverageForLineString(wind, line))
+      return wind;
+  }
   return currentWindQuery()->getWindAverageForLineString(line);
 }
 
+bool WindReporter::useWindGrid() const
+{
+  // Manual wind is a simple model which does not need a grid
+  return !isWindManual() && windQueryOnline->hasWindData();
+}
+
 atools::grib::WindPosList WindReporter::windStackForPosInternal(const atools::geo::Pos& pos, QVector<int> altitudesFt) const
 {
   atools::grib::WindPosList winds;
@@ -913,6 +952,7 @@ atools::grib::WindPosList WindReporter::getWindStackForPos(const atools::geo::Po
 
 void WindReporter::updateManualRouteWinds()
 {
+  windGeneration++;
   const AircraftPerfController *perfController = NavApp::getAircraftPerfController();
   windQueryManual->initFromFixedModel(perfController->getManualWindDirDeg(),
                                       perfController->getManualWindSpeedKts(),
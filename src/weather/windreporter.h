@@ -41,6 +41,7 @@ class WindQuery;
 }
 
 class QToolButton;
+class WindGrid;
 class QAction;
 class QActionGroup;
 class QSlider;
@@ -146,6 +147,12 @@ public:
   /* Updates the query class */
   void updateManualRouteWinds();
 
+  /* Incremented each time wind data or source used for flight plan calculation might have changed */
+  int getWindGeneration() const
+  {
+    return windGeneration;
+  }
+
   /* Update toolbar button and menu items */
   void updateToolButtonState();
 
@@ -202,6 +209,9 @@ private:
   /* Update altitude label from slider values */
   void updateSliderLabel();
 
+  /* true if online wind data is used and route calculations can use the grid */
+  bool useWindGrid() const;
+
   atools::grib::WindQuery *currentWindQuery() const
   {
     return isWindManual() ? windQueryManual : windQueryOnline;
@@ -210,6 +220,9 @@ private:
   /* GRIB wind data query for downloading files and monitoring files- Manual wind if for user setting. */
   atools::grib::WindQuery *windQueryOnline = nullptr, *windQueryManual = nullptr;
 
+  /* Grid of interpolated wind vectors from windQueryOnline for flight plan calculations. Cleared on each update. */
+  WindGrid *windGrid = nullptr;
+
   /* Toolbar button */
   QToolButton *windlevelToolButton = nullptr;
 
@@ -243,6 +256,9 @@ private:
   windinternal::WindLabelAction *labelActionWindAltitude = nullptr;
 
   bool downloadErrorReported = false;
+
+  /* See getWindGeneration() */
+  int windGeneration = 0;
 };
 
 namespace windinternal {
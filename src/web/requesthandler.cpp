@@ -29,6 +29,7 @@
 #include "webapi/webapicontroller.h"
 #include "web/webtools.h"
 #include "web/webapp.h"
+#include "web/webstream.h"
 #include "common/mapcolors.h"
 #include "geo/calculations.h"
 #include "common/htmlinfobuilder.h"
@@ -46,8 +47,9 @@
 using namespace stefanfrings;
 
 RequestHandler::RequestHandler(QObject *parent, WebMapController *webMapController,WebApiController *webApiController,
-                               HtmlInfoBuilder *htmlInfoBuilderParam, bool verboseParam)
-  : HttpRequestHandler(parent), webApiController(webApiController), htmlInfoBuilder(htmlInfoBuilderParam), verbose(verboseParam)
+                               WebStream *webStreamParam, HtmlInfoBuilder *htmlInfoBuilderParam, bool verboseParam)
+  : HttpRequestHandler(parent), webApiController(webApiController), webStream(webStreamParam),
+  htmlInfoBuilder(htmlInfoBuilderParam), verbose(verboseParam)
 {
   if(verbose)
     qDebug() << Q_FUNC_INFO;
@@ -99,6 +101,10 @@ void RequestHandler::service(HttpRequest& request, HttpResponse& response)
     // ===========================================================================
     // Requests for map images only - either with or without session
     handleMapImage(request, response);
+  else if(path == QLatin1String("/stream"))
+    // ===========================================================================
+    // Server sent events for aircraft, progress and route changes - stateless
+    handleStream(request, response);
   else if(path.startsWith(webApiController->webApiPathPrefix))
     // ===========================================================================
     // Requests for web api - either with or without session
@@ -330,6 +336,47 @@ inline void RequestHandler::handleMapImage(HttpRequest& request, HttpResponse& r
     showErrorPixmap(response, width, height, 404, QStringLiteral(u"invalid pixmap"));
 }
 
+void RequestHandler::handleStream(HttpRequest& request, HttpResponse& response)
+{
+  Parameter params(request, verbose);
+
+  WebStreamClient client;
+  // Minimum time between two updates for this client
+  client.intervalMs = atools::minmax(static_cast<int>(WebStream::MIN_ENCODE_INTERVAL_MS), 60000,
+                                     params.asInt(QStringLiteral(u"interval"), 1000));
+
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "Stream opened interval" << client.intervalMs;
+
+  // No content length header - response uses chunked transfer encoding
+  response.setHeader("Content-Type", "text/event-stream; charset=UTF-8");
+  response.setHeader("Cache-Control", "no-cache");
+  response.setHeader("X-Accel-Buffering", "no");
+
+  // Tell the browser how long to wait before reconnecting
+  response.write("retry: 2000\n\n", false);
+
+  bool stopped = false;
+  while(!stopped && response.isConnected())
+  {
+    QByteArray events = webStream->waitForEvents(client, 15000, stopped);
+
+    if(stopped)
+      break;
+
+    if(events.isEmpty())
+      // Timeout - send comment to keep connection and proxies alive and to detect closed connections
+      response.write(": keepalive\n\n", false);
+    else
+      response.write(events, false);
+  }
+
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "Stream closed";
+
+  // Terminate chunked transfer
+  response.write(QByteArray(), true);
+}
 
 inline void RequestHandler::handleWebApiRequest(HttpRequest& request, HttpResponse& response)
 {
@@ -39,6 +39,7 @@ class HttpSession;
 }
 
 class HtmlInfoBuilder;
+class WebStream;
 
 /*
  * Handles all HTTP server requests including stateless and stateful. Maintains a session for the stateful page.
@@ -55,7 +56,7 @@ class RequestHandler :
 public:
   /* Prepare connections to other objects. Handler is ready to accept connections when instantiated. */
   RequestHandler(QObject *parent, WebMapController *webMapController, WebApiController *webApiController,
-                 HtmlInfoBuilder *htmlInfoBuilderParam, bool verboseParam);
+                 WebStream *webStreamParam, HtmlInfoBuilder *htmlInfoBuilderParam, bool verboseParam);
   virtual ~RequestHandler() override;
 
   /* Doing all the work right here. */
@@ -96,6 +97,9 @@ private:
   /* Handle stateful and stateless api requests. */
   void handleWebApiRequest(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response);
 
+  /* Handle server sent event stream. Blocks this server thread until the client disconnects or the server stops. */
+  void handleStream(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response);
+
   /* Handle html file requests. */
   void handleHtmlFileRequest(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response, stefanfrings::HttpSession& session, QString& file, const QString& extension);
 
@@ -106,6 +110,7 @@ private:
   stefanfrings::HttpSession getSession(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response);
 
   WebApiController *webApiController;
+  WebStream *webStream;
   HtmlInfoBuilder *htmlInfoBuilder;
 
   bool verbose = false;
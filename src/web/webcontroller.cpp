@@ -22,6 +22,7 @@
 #include "web/webmapcontroller.h"
 #include "webapi/webapicontroller.h"
 #include "web/webapp.h"
+#include "web/webstream.h"
 #include "gui/helphandler.h"
 #include "httpserver/httplistener.h"
 #include "common/htmlinfobuilder.h"
@@ -63,6 +64,7 @@ WebController::WebController(QWidget *parent) :
 
   mapController = new WebMapController(parentWidget, verbose);
   apiController = new WebApiController(parentWidget, verbose);
+  webStream = new WebStream(this, verbose);
 
   htmlInfoBuilder = new HtmlInfoBuilder(parent, mapController->getMapPaintWidget(), true /*info*/, true /*print*/);
   updateSettings();
@@ -76,6 +78,7 @@ WebController::~WebController()
 
   delete mapController;
   delete apiController;
+  delete webStream;
   delete htmlInfoBuilder;
 }
 
@@ -105,7 +108,10 @@ void WebController::startServer()
   // Start map
   mapController->init();
 
-  requestHandler = new RequestHandler(this, mapController, apiController, htmlInfoBuilder, verbose);
+  // Allow streaming clients to wait for events
+  webStream->start();
+
+  requestHandler = new RequestHandler(this, mapController, apiController, webStream, htmlInfoBuilder, verbose);
 
   // Set port - always override configuration file
   listenerSettings.insert("port", port);
@@ -217,6 +223,9 @@ void WebController::stopServer()
 
   mapController->deInit();
 
+  // Wake up all threads blocked in streaming requests to allow the listener to shut down
+  webStream->stop();
+
   if(listener != nullptr)
     listener->close();
 
@@ -348,4 +357,5 @@ void WebController::preDatabaseLoad()
 void WebController::postDatabaseLoad()
 {
   mapController->postDatabaseLoad();
+  apiController->postDatabaseLoad();
 }
@@ -31,6 +31,7 @@ class HttpListener;
 class RequestHandler;
 class WebMapController;
 class WebApiController;
+class WebStream;
 class HtmlInfoBuilder;
 class QSettings;
 
@@ -114,6 +115,12 @@ public:
 
   WebMapController *getWebMapController() const;
 
+  /* Server push stream for aircraft, progress and route events. Has to be connected to the data sources. */
+  WebStream *getWebStream() const
+  {
+    return webStream;
+  }
+
   /* Need to clear caches and tear down queries in map widget before switching database */
   void preDatabaseLoad();
 
@@ -133,6 +140,9 @@ private:
   /* Web API controller */
   WebApiController *apiController = nullptr;
 
+  /* Encodes events once for all streaming clients */
+  WebStream *webStream = nullptr;
+
   /* Handles all HTTP requests using templates or static */
   RequestHandler *requestHandler = nullptr;
 
@@ -0,0 +1,238 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "web/webstream.h"
+
+#include "app/navapp.h"
+#include "fs/sc/simconnectdata.h"
+#include "geo/calculations.h"
+#include "route/route.h"
+
+#include <QDebug>
+
+// Use JSON library
+#include "json/nlohmann/json.hpp"
+using JSON = nlohmann::json;
+
+WebStream::WebStream(QObject *parent, bool verboseParam)
+  : QObject(parent), verbose(verboseParam)
+{
+  if(verbose)
+    qDebug() << Q_FUNC_INFO;
+
+  // Clients connecting before the first route change get a notification anyway
+  routeFrame = frame("route", JSON({{"changed", false}, {"size", 0}}).dump().data());
+  routeSeq = ++sequence;
+}
+
+WebStream::~WebStream()
+{
+  if(verbose)
+    qDebug() << Q_FUNC_INFO;
+
+  stop();
+}
+
+void WebStream::start()
+{
+  QMutexLocker locker(&mutex);
+  stopped = false;
+}
+
+void WebStream::stop()
+{
+  QMutexLocker locker(&mutex);
+  stopped = true;
+  condition.wakeAll();
+}
+
+void WebStream::simDataChanged(const atools::fs::sc::SimConnectData& simConnectData)
+{
+  if(simConnectData.isEmptyReply() || !simConnectData.isUserAircraftValid())
+    return;
+
+  // Encode only once per tick for all clients
+  if(lastEncode.isValid() && lastEncode.elapsed() < MIN_ENCODE_INTERVAL_MS)
+    return;
+  lastEncode.start();
+
+  // Encode outside of the lock - route has to be accessed in main thread anyway
+  QByteArray aircraft = frame("aircraft", aircraftJson(simConnectData));
+  QByteArray progress = frame("progress", progressJson(simConnectData));
+
+  QMutexLocker locker(&mutex);
+  bool changed = updateEvent(aircraftFrame, aircraftSeq, aircraft);
+  changed |= updateEvent(progressFrame, progressSeq, progress);
+
+  if(changed)
+    condition.wakeAll();
+}
+
+void WebStream::routeChanged(bool geometryChanged, bool newFlightplan)
+{
+  JSON json = {
+    {"changed", true},
+    {"geometry", geometryChanged},
+    {"new", newFlightplan},
+    {"size", NavApp::getRouteConst().size()}
+  };
+
+  QMutexLocker locker(&mutex);
+  // Always notify since payload might be the same for different plans
+  routeFrame = frame("route", json.dump().data());
+  routeSeq = ++sequence;
+  condition.wakeAll();
+}
+
+void WebStream::disconnectedFromSimulator()
+{
+  QByteArray inactive = JSON({{"active", false}}).dump().data();
+
+  QMutexLocker locker(&mutex);
+  bool changed = updateEvent(aircraftFrame, aircraftSeq, frame("aircraft", inactive));
+  changed |= updateEvent(progressFrame, progressSeq, frame("progress", inactive));
+  lastEncode.invalidate();
+
+  if(changed)
+    condition.wakeAll();
+}
+
+QByteArray WebStream::waitForEvents(WebStreamClient& client, int timeoutMs, bool& stoppedParam)
+{
+  QMutexLocker locker(&mutex);
+
+  // Rate limit per client - wait for the rest of the interval but wake up on shutdown ==================
+  if(client.lastWrite.isValid())
+  {
+    qint64 remaining = client.intervalMs - client.lastWrite.elapsed();
+    while(!stopped && remaining > 0)
+    {
+      condition.wait(&mutex, static_cast<unsigned long>(remaining));
+      remaining = client.intervalMs - client.lastWrite.elapsed();
+    }
+  }
+
+  // Wait for anything new for this client ======================================
+  QElapsedTimer timer;
+  timer.start();
+  while(!stopped && client.aircraftSeq >= aircraftSeq && client.progressSeq >= progressSeq && client.routeSeq >= routeSeq)
+  {
+    qint64 remaining = timeoutMs - timer.elapsed();
+    if(remaining <= 0)
+      break;
+    condition.wait(&mutex, static_cast<unsigned long>(remaining));
+  }
+
+  stoppedParam = stopped;
+
+  // Collect all pre-encoded frames newer than the last ones sent to this client ========================
+  QByteArray retval;
+  if(!stopped)
+  {
+    if(client.routeSeq < routeSeq)
+    {
+      retval.append(routeFrame);
+      client.routeSeq = routeSeq;
+    }
+
+    if(client.aircraftSeq < aircraftSeq)
+    {
+      retval.append(aircraftFrame);
+      client.aircraftSeq = aircraftSeq;
+    }
+
+    if(client.progressSeq < progressSeq)
+    {
+      retval.append(progressFrame);
+      client.progressSeq = progressSeq;
+    }
+
+    if(!retval.isEmpty())
+      client.lastWrite.start();
+  }
+  return retval;
+}
+
+bool WebStream::updateEvent(QByteArray& eventFrame, quint64& eventSeq, const QByteArray& newFrame)
+{
+  if(eventFrame != newFrame)
+  {
+    eventFrame = newFrame;
+    eventSeq = ++sequence;
+    return true;
+  }
+  return false;
+}
+
+QByteArray WebStream::frame(const char *eventName, const QByteArray& json)
+{
+  return QByteArray("event: ") + eventName + "\ndata: " + json + "\n\n";
+}
+
+QByteArray WebStream::aircraftJson(const atools::fs::sc::SimConnectData& simConnectData) const
+{
+  const atools::fs::sc::SimConnectUserAircraft& aircraft = simConnectData.getUserAircraftConst();
+  const atools::geo::Pos& pos = aircraft.getPosition();
+
+  JSON json = {
+    {"active", true},
+    {"lat", pos.getLatY()},
+    {"lon", pos.getLonX()},
+    {"alt", aircraft.getActualAltitudeFt()},
+    {"ialt", aircraft.getIndicatedAltitudeFt()},
+    {"gs", aircraft.getGroundSpeedKts()},
+    {"ias", aircraft.getIndicatedSpeedKts()},
+    {"tas", aircraft.getTrueAirspeedKts()},
+    {"vs", aircraft.getVerticalSpeedFeetPerMin()},
+    {"hdg", aircraft.getHeadingDegMag()},
+    {"hdgt", aircraft.getHeadingDegTrue()},
+    {"trk", aircraft.getTrackDegTrue()},
+    {"gnd", aircraft.isOnGround()},
+    {"winddir", atools::geo::normalizeCourse(aircraft.getWindDirectionDegT() - aircraft.getMagVarDeg())},
+    {"windspd", aircraft.getWindSpeedKts()}
+  };
+  return json.dump().data();
+}
+
+QByteArray WebStream::progressJson(const atools::fs::sc::SimConnectData& simConnectData) const
+{
+  Q_UNUSED(simConnectData)
+
+  const Route& route = NavApp::getRouteConst();
+  const RouteLeg *activeLeg = route.getActiveLeg();
+
+  JSON json;
+  float distFromStart = 0.f, distToDest = 0.f, nextLegDistance = 0.f, crossTrack = 0.f;
+  if(activeLeg != nullptr && route.getRouteDistances(&distFromStart, &distToDest, &nextLegDistance, &crossTrack))
+  {
+    // Round values to avoid sending events for insignificant changes
+    json = {
+      {"active", true},
+      {"leg", route.getActiveLegIndex()},
+      {"next", qUtf8Printable(activeLeg->getIdent())},
+      {"fromstart", atools::roundToInt(distFromStart * 10.f) / 10.f},
+      {"todest", atools::roundToInt(distToDest * 10.f) / 10.f},
+      {"tonext", atools::roundToInt(nextLegDistance * 10.f) / 10.f},
+      {"xtrack", atools::roundToInt(crossTrack * 100.f) / 100.f},
+      {"todfromdest", atools::roundToInt(route.getTopOfDescentFromDestination() * 10.f) / 10.f}
+    };
+  }
+  else
+    json = {{"active", false}};
+
+  return json.dump().data();
+}
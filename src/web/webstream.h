@@ -0,0 +1,119 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_WEBSTREAM_H
+#define LNM_WEBSTREAM_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QWaitCondition>
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+}
+}
+}
+
+/* Per client state for a streaming request. Kept by the server thread handling the request. */
+struct WebStreamClient
+{
+  /* Sequence numbers of the last events sent to this client */
+  quint64 aircraftSeq = 0L, progressSeq = 0L, routeSeq = 0L;
+
+  /* Minimum time between two writes to this client. Limited to 100 ms - 60 s. */
+  int intervalMs = 1000;
+
+  /* Time since last write */
+  QElapsedTimer lastWrite;
+};
+
+/*
+ * Server push for the web server using server sent events (SSE, "text/event-stream").
+ *
+ * Receives simulator data and route changes in the main thread and encodes compact JSON events once per tick.
+ * The encoded frames are shared by all streaming clients which are served by the HTTP server threads.
+ * Clients wait in waitForEvents() and get only events changed since their last call.
+ *
+ * Events are "aircraft" (user aircraft state), "progress" (only sent when changed) and "route"
+ * (notification that the flight plan was changed and has to be reloaded).
+ */
+class WebStream :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit WebStream(QObject *parent, bool verboseParam);
+  virtual ~WebStream() override;
+
+  WebStream(const WebStream& other) = delete;
+  WebStream& operator=(const WebStream& other) = delete;
+
+  /* Connected to ConnectClient::dataPacketReceived. Main thread. */
+  void simDataChanged(const atools::fs::sc::SimConnectData& simConnectData);
+
+  /* Connected to RouteController::routeChanged. Main thread. */
+  void routeChanged(bool geometryChanged, bool newFlightplan);
+
+  /* Clear aircraft and progress state and send an inactive event. Main thread. */
+  void disconnectedFromSimulator();
+
+  /* Allow clients to wait for events. Called when the server starts. */
+  void start();
+
+  /* Wake up all waiting server threads and let them close their streams. Called before the server stops. */
+  void stop();
+
+  /* Called from the server threads. Waits until the client interval has passed and at least one event is newer than
+   * the last one sent to the client. Returns empty array on timeout which can be used to send keep alive comments.
+   * Sets stopped to true if the server is shutting down. Updates the sequence numbers in client. */
+  QByteArray waitForEvents(WebStreamClient& client, int timeoutMs, bool& stopped);
+
+  /* Do not encode more often than this. This is the "tick". */
+  static constexpr int MIN_ENCODE_INTERVAL_MS = 100;
+
+private:
+  /* Build a full SSE frame for the given event name and JSON payload */
+  static QByteArray frame(const char *eventName, const QByteArray& json);
+
+  QByteArray aircraftJson(const atools::fs::sc::SimConnectData& simConnectData) const;
+  QByteArray progressJson(const atools::fs::sc::SimConnectData& simConnectData) const;
+
+  /* Store frame and increment sequence number if payload has changed. Caller has to lock the mutex. */
+  bool updateEvent(QByteArray& eventFrame, quint64& eventSeq, const QByteArray& newFrame);
+
+  /* Guards all fields below */
+  QMutex mutex;
+  QWaitCondition condition;
+
+  /* Pre-encoded SSE frames shared by all clients */
+  QByteArray aircraftFrame, progressFrame, routeFrame;
+
+  /* Sequence numbers for the frames above taken from a global counter */
+  quint64 aircraftSeq = 0L, progressSeq = 0L, routeSeq = 0L, sequence = 0L;
+
+  bool stopped = true;
+
+  /* Main thread only - rate limit for encoding */
+  QElapsedTimer lastEncode;
+  bool verbose = false;
+};
+
+#endif // LNM_WEBSTREAM_H
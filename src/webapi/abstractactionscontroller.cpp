@@ -53,6 +53,10 @@ Q_UNUSED(request)
 
 }
 
+void AbstractActionsController::postDatabaseLoad(){
+    // Nothing cached by default
+}
+
 WebApiResponse AbstractActionsController::getResponse(){
 
     WebApiResponse response = WebApiResponse();
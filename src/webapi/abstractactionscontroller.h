@@ -42,6 +42,10 @@ public:
      * @brief return a "404 not found" response
      */
     Q_INVOKABLE virtual WebApiResponse notFoundAction(WebApiRequest request);
+    /**
+     * @brief called after a database switch to drop cached navdata. Not invokable as action.
+     */
+    virtual void postDatabaseLoad();
 protected:
     /**
      * @brief get new response object
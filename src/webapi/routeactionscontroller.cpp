@@ -0,0 +1,81 @@
+#include "routeactionscontroller.h"
+#include "common/infobuildertypes.h"
+#include "common/abstractinfobuilder.h"
+#include "routestring/routestringbatch.h"
+#include "webapi/webapirequest.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+using InfoBuilderTypes::RouteParseData;
+
+/* Number of route descriptions parsed before pending events are processed since parsing runs in the main thread */
+const static int ROUTES_PER_CHUNK = 200;
+
+/* Drop lookup cache after this number of parsed route descriptions to limit memory usage */
+const static int MAX_ROUTES_PER_CACHE = 20000;
+
+RouteActionsController::RouteActionsController(QObject *parent, bool verboseParam, AbstractInfoBuilder* infoBuilder) :
+    AbstractLnmActionsController(parent, verboseParam, infoBuilder)
+{
+    if(verbose)
+        qDebug() << Q_FUNC_INFO;
+
+    batch = new RouteStringBatch;
+}
+
+RouteActionsController::~RouteActionsController()
+{
+    delete batch;
+}
+
+void RouteActionsController::postDatabaseLoad(){
+    batch->clearCache();
+}
+
+WebApiResponse RouteActionsController::parseAction(WebApiRequest request){
+    if(verbose)
+        qDebug() << Q_FUNC_INFO;
+
+    // Get a new response object
+    WebApiResponse response = getResponse();
+
+    // Collect route strings from body and parameters
+    QStringList routeStrings = RouteStringBatch::splitLines(QString::fromUtf8(request.body));
+    for(const QByteArray& route : request.parameters.values("route"))
+        routeStrings.append(RouteStringBatch::splitLines(QString::fromUtf8(route)));
+
+    if(routeStrings.isEmpty()){
+        response.status = 400;
+        response.body = "No route description given";
+        return response;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(batch->getNumParsedSinceClear() > MAX_ROUTES_PER_CACHE)
+        batch->clearCache();
+
+    // Lookup caches are shared between all routes and requests
+    QVector<RouteStringBatch::Result> results;
+    results.reserve(routeStrings.size());
+    for(int i = 0; i < routeStrings.size(); i += ROUTES_PER_CHUNK){
+        if(i > 0)
+            // Keep map and other requests going between chunks
+            QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+
+        results.append(batch->parse(routeStrings.mid(i, ROUTES_PER_CHUNK)));
+    }
+
+    RouteParseData data = {
+        results,
+        timer.elapsed()
+    };
+
+    response.body = infoBuilder->routeparse(data);
+    response.status = 200;
+
+    return response;
+
+}
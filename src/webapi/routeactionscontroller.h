@@ -0,0 +1,33 @@
+#ifndef ROUTEACTIONSCONTROLLER_H
+#define ROUTEACTIONSCONTROLLER_H
+
+#include "abstractlnmactionscontroller.h"
+
+class RouteStringBatch;
+
+/**
+ * @brief Route actions controller implementation.
+ */
+class RouteActionsController :
+        public AbstractLnmActionsController
+{
+    Q_OBJECT
+public:
+    Q_INVOKABLE RouteActionsController(QObject *parent, bool verboseParam, AbstractInfoBuilder* infoBuilder);
+    virtual ~RouteActionsController() override;
+    /**
+     * @brief parse route descriptions given in the request body (one per line) or as "route" parameters
+     */
+    Q_INVOKABLE WebApiResponse parseAction(WebApiRequest request);
+    /**
+     * @brief drop the lookup cache after a database switch
+     */
+    virtual void postDatabaseLoad() override;
+private:
+    /**
+     * @brief batch parser keeping airport, navaid and airway lookups across requests
+     */
+    RouteStringBatch *batch;
+};
+
+#endif // ROUTEACTIONSCONTROLLER_H
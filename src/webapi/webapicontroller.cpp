@@ -17,6 +17,7 @@
 
 #include "webapi/webapicontroller.h"
 #include "common/jsoninfobuilder.h"
+#include "webapi/abstractactionscontroller.h"
 #include "webapi/actionscontrollerindex.h"
 #include "webapi/webapiresponse.h"
 #include "webapi/webapirequest.h"
@@ -112,6 +113,14 @@ WebApiResponse WebApiController::service(WebApiRequest& request)
 
 }
 
+void WebApiController::postDatabaseLoad(){
+    for(QObject *controller : qAsConst(controllerInstances)){
+        AbstractActionsController *actionsController = qobject_cast<AbstractActionsController *>(controller);
+        if(actionsController != nullptr)
+            actionsController->postDatabaseLoad();
+    }
+}
+
 QByteArray WebApiController::getControllerNameByPath(QByteArray path){
     QByteArray name = "AbstractActionsController"; /* Default fallback */
     QList<QByteArray> list = path.split('/');
@@ -56,6 +56,11 @@ public:
    */
   WebApiResponse service(WebApiRequest& request);
 
+  /**
+   * @brief notify all instantiated controllers about a database switch
+   */
+  void postDatabaseLoad();
+
 private:
 
   /**